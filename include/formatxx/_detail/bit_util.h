@@ -0,0 +1,143 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_BIT_UTIL_H)
+#define _guard_FORMATXX_DETAIL_BIT_UTIL_H
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#	include <intrin.h>
+#endif
+
+// SIMD kernels are selected at compile time; define FORMATXX_NO_SIMD to force the portable paths
+#if !defined(FORMATXX_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	define _FORMATXX_SSE2 1
+#	include <emmintrin.h>
+#elif !defined(FORMATXX_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#	define _FORMATXX_NEON 1
+#	include <arm_neon.h>
+#endif
+
+namespace formatxx {
+namespace _detail {
+
+/// Number of leading zero bits; value must be non-zero.
+inline int count_leading_zeroes(std::uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clz(value);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return 31 - static_cast<int>(index);
+#else
+	int count = 0;
+	while ((value & 0x80000000u) == 0)
+	{
+		value <<= 1;
+		++count;
+	}
+	return count;
+#endif
+}
+
+/// Number of leading zero bits; value must be non-zero.
+inline int count_leading_zeroes(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_clzll(value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return 63 - static_cast<int>(index);
+#else
+	std::uint32_t const high = static_cast<std::uint32_t>(value >> 32);
+	return high != 0 ? count_leading_zeroes(high) : 32 + count_leading_zeroes(static_cast<std::uint32_t>(value));
+#endif
+}
+
+/// Number of trailing zero bits; value must be non-zero.
+inline int count_trailing_zeroes(std::uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(value);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return static_cast<int>(index);
+#else
+	int count = 0;
+	while ((value & 1) == 0)
+	{
+		value >>= 1;
+		++count;
+	}
+	return count;
+#endif
+}
+
+/// Number of trailing zero bits; value must be non-zero.
+inline int count_trailing_zeroes(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(value);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return static_cast<int>(index);
+#else
+	std::uint32_t const low = static_cast<std::uint32_t>(value);
+	return low != 0 ? count_trailing_zeroes(low) : 32 + count_trailing_zeroes(static_cast<std::uint32_t>(value >> 32));
+#endif
+}
+
+inline std::uint64_t byte_swap(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_bswap64(value);
+#elif defined(_MSC_VER)
+	return _byteswap_uint64(value);
+#else
+	value = ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+	value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+	return (value << 32) | (value >> 32);
+#endif
+}
+
+/// Number of bits required to represent value; zero for zero.
+inline int bit_width(std::uint32_t value) { return value != 0 ? 32 - count_leading_zeroes(value) : 0; }
+inline int bit_width(std::uint64_t value) { return value != 0 ? 64 - count_leading_zeroes(value) : 0; }
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_BIT_UTIL_H
@@ -0,0 +1,161 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_COMPILE_IMPL_H)
+#define _guard_FORMATXX_DETAIL_COMPILE_IMPL_H
+#pragma once
+
+#include "format_impl.h"
+#include "printf_impl.h"
+
+namespace formatxx {
+namespace _detail {
+
+/// Receiver for the parsers that records segments instead of formatting them.
+template <typename CharT>
+class compile_receiver
+{
+public:
+	explicit compile_receiver(std::vector<compiled_segment<CharT>>& segments) : _segments(segments) {}
+
+	void literal(basic_string_view<CharT> text)
+	{
+		compiled_segment<CharT> segment;
+		segment.text = text;
+		_segments.push_back(segment);
+	}
+
+	result_code argument(unsigned index, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+	{
+		compiled_segment<CharT> segment;
+		segment.text = spec_string;
+		segment.spec = spec != nullptr ? *spec : parse_format_spec(spec_string);
+		segment.index = index;
+		_segments.push_back(segment);
+		return result_code::success;
+	}
+
+private:
+	std::vector<compiled_segment<CharT>>& _segments;
+};
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API compile_format_impl(std::vector<compiled_segment<CharT>>& segments, basic_string_view<CharT> format, format_syntax syntax)
+{
+	compile_receiver<CharT> receiver(segments);
+	return syntax == format_syntax::printf ? parse_printf(format, receiver) : parse_format(format, receiver);
+}
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API compiled_format_impl(basic_format_writer<CharT>& out, compiled_segment<CharT> const* segments, std::size_t count, basic_format_args<CharT> args)
+{
+	result_code result = result_code::success;
+
+	for (compiled_segment<CharT> const* const end = segments + count; segments != end; ++segments)
+	{
+		if (segments->index == compiled_segment<CharT>::literal_index)
+		{
+			out.put_stable(segments->text);
+			continue;
+		}
+
+		result_code const arg_result = args.format_arg(out, segments->index, segments->text, &segments->spec);
+		if (arg_result != result_code::success)
+		{
+			result = arg_result;
+		}
+	}
+
+	return result;
+}
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API format_rows_impl(basic_format_writer<CharT>& out, compiled_segment<CharT> const* segments, std::size_t count, batch_column<CharT> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row)
+{
+	result_code result = result_code::success;
+	compiled_segment<CharT> const* const end = segments + count;
+
+	// a reference past the last column fails identically in every row, so it is checked once
+	for (compiled_segment<CharT> const* segment = segments; segment != end; ++segment)
+	{
+		if (segment->index != compiled_segment<CharT>::literal_index && segment->index >= column_count)
+		{
+			result = result_code::out_of_range;
+		}
+	}
+
+	for (std::size_t row = first_row; row != last_row; ++row)
+	{
+		for (compiled_segment<CharT> const* segment = segments; segment != end; ++segment)
+		{
+			if (segment->index == compiled_segment<CharT>::literal_index)
+			{
+				out.put_stable(segment->text);
+			}
+			else if (segment->index < column_count)
+			{
+				batch_column<CharT> const& column = columns[segment->index];
+				column.format(out, column.values, row, segment->text, &segment->spec);
+			}
+		}
+	}
+
+	return result;
+}
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API static_format_impl(basic_format_writer<CharT>& out, CharT const* format, static_segment const* segments, std::size_t count, basic_format_args<CharT> args)
+{
+	result_code result = result_code::success;
+
+	for (static_segment const* const end = segments + count; segments != end; ++segments)
+	{
+		basic_string_view<CharT> const text(format + segments->offset, segments->length);
+
+		if (segments->index == static_segment::literal_index)
+		{
+			out.put_stable(text);
+			continue;
+		}
+
+		result_code const arg_result = args.format_arg(out, segments->index, text);
+		if (arg_result != result_code::success)
+		{
+			result = arg_result;
+		}
+	}
+
+	return result;
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_COMPILE_IMPL_H
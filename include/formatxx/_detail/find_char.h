@@ -0,0 +1,152 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_FIND_CHAR_H)
+#define _guard_FORMATXX_DETAIL_FIND_CHAR_H
+#pragma once
+
+#include "bit_util.h"
+#include <cstring>
+#include <cwchar>
+
+namespace formatxx {
+namespace _detail {
+
+/// Finds the first needle in [first, last), returning last if there is none.
+/// Used by the parsers to skip over whole literal spans at once.
+template <typename CharT>
+CharT const* find_char(CharT const* first, CharT const* last, CharT needle)
+{
+	while (first != last && *first != needle)
+	{
+		++first;
+	}
+	return first;
+}
+
+#if defined(_FORMATXX_SSE2)
+
+/// Compares 16 bytes at a time; Width is the size of the character type.
+template <std::size_t Width>
+struct sse2_find;
+
+template <> struct sse2_find<1>
+{
+	static __m128i splat(int c) { return _mm_set1_epi8(static_cast<char>(c)); }
+	static __m128i compare(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+};
+
+template <> struct sse2_find<2>
+{
+	static __m128i splat(int c) { return _mm_set1_epi16(static_cast<short>(c)); }
+	static __m128i compare(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+};
+
+template <> struct sse2_find<4>
+{
+	static __m128i splat(int c) { return _mm_set1_epi32(c); }
+	static __m128i compare(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+};
+
+template <typename CharT>
+CharT const* sse2_find_char(CharT const* first, CharT const* last, CharT needle)
+{
+	using ops = sse2_find<sizeof(CharT)>;
+	constexpr std::size_t lanes = 16 / sizeof(CharT);
+
+	__m128i const pattern = ops::splat(static_cast<int>(needle));
+	while (static_cast<std::size_t>(last - first) >= lanes)
+	{
+		__m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+		unsigned const mask = static_cast<unsigned>(_mm_movemask_epi8(ops::compare(chunk, pattern)));
+		if (mask != 0)
+		{
+			// movemask yields one bit per byte, so scale back down to characters
+			return first + count_trailing_zeroes(static_cast<std::uint32_t>(mask)) / sizeof(CharT);
+		}
+		first += lanes;
+	}
+
+	return find_char<CharT>(first, last, needle);
+}
+
+inline char const* find_char(char const* first, char const* last, char needle) { return sse2_find_char(first, last, needle); }
+inline wchar_t const* find_char(wchar_t const* first, wchar_t const* last, wchar_t needle) { return sse2_find_char(first, last, needle); }
+inline char16_t const* find_char(char16_t const* first, char16_t const* last, char16_t needle) { return sse2_find_char(first, last, needle); }
+inline char32_t const* find_char(char32_t const* first, char32_t const* last, char32_t needle) { return sse2_find_char(first, last, needle); }
+
+#elif defined(_FORMATXX_NEON)
+
+inline char const* find_char(char const* first, char const* last, char needle)
+{
+	uint8x16_t const pattern = vdupq_n_u8(static_cast<std::uint8_t>(needle));
+	while (last - first >= 16)
+	{
+		uint8x16_t const chunk = vld1q_u8(reinterpret_cast<std::uint8_t const*>(first));
+		uint8x16_t const matches = vceqq_u8(chunk, pattern);
+
+		// narrow each byte of the comparison to a nibble, giving a 64-bit mask
+		std::uint64_t const mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+		if (mask != 0)
+		{
+			return first + count_trailing_zeroes(mask) / 4;
+		}
+		first += 16;
+	}
+
+	return find_char<char>(first, last, needle);
+}
+
+inline wchar_t const* find_char(wchar_t const* first, wchar_t const* last, wchar_t needle)
+{
+	wchar_t const* const found = std::wmemchr(first, needle, static_cast<std::size_t>(last - first));
+	return found != nullptr ? found : last;
+}
+
+#else
+
+inline char const* find_char(char const* first, char const* last, char needle)
+{
+	void const* const found = std::memchr(first, static_cast<unsigned char>(needle), static_cast<std::size_t>(last - first));
+	return found != nullptr ? static_cast<char const*>(found) : last;
+}
+
+inline wchar_t const* find_char(wchar_t const* first, wchar_t const* last, wchar_t needle)
+{
+	wchar_t const* const found = std::wmemchr(first, needle, static_cast<std::size_t>(last - first));
+	return found != nullptr ? found : last;
+}
+
+#endif
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_FIND_CHAR_H
@@ -0,0 +1,837 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_FLOAT_DIGITS_H)
+#define _guard_FORMATXX_DETAIL_FLOAT_DIGITS_H
+#pragma once
+
+#include "bit_util.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace formatxx {
+namespace _detail {
+
+/// Raw IEEE754 decomposition of a floating point value.
+struct float_parts
+{
+	std::uint64_t mantissa = 0; ///< significand, including the hidden bit for normal values
+	int exponent = 0; ///< binary exponent such that value == mantissa * 2^exponent
+	bool negative = false;
+	bool infinite = false;
+	bool nan = false;
+	bool normal = false; ///< mantissa includes the hidden bit
+};
+
+template <typename FloatT>
+float_parts decompose_float(FloatT value)
+{
+	using bits_type = typename std::conditional<sizeof(FloatT) == 4, std::uint32_t, std::uint64_t>::type;
+	constexpr int precision = std::numeric_limits<FloatT>::digits;
+	constexpr int bias = std::numeric_limits<FloatT>::max_exponent - 1 + (precision - 1);
+	constexpr std::uint64_t hidden_bit = std::uint64_t(1) << (precision - 1);
+	constexpr std::uint64_t exponent_mask = (std::uint64_t(1) << (sizeof(FloatT) * 8 - precision)) - 1;
+
+	static_assert(sizeof(FloatT) == sizeof(bits_type) && std::numeric_limits<FloatT>::is_iec559, "IEEE754 floating point required");
+
+	bits_type raw;
+	std::memcpy(&raw, &value, sizeof(raw));
+	std::uint64_t const bits = raw;
+
+	std::uint64_t const fraction = bits & (hidden_bit - 1);
+	std::uint64_t const biased = (bits >> (precision - 1)) & exponent_mask;
+
+	float_parts parts;
+	parts.negative = (bits >> (sizeof(FloatT) * 8 - 1)) != 0;
+
+	if (biased == exponent_mask)
+	{
+		parts.infinite = fraction == 0;
+		parts.nan = fraction != 0;
+	}
+	else if (biased == 0)
+	{
+		parts.mantissa = fraction;
+		parts.exponent = 1 - bias;
+	}
+	else
+	{
+		parts.mantissa = fraction | hidden_bit;
+		parts.exponent = static_cast<int>(biased) - bias;
+		parts.normal = true;
+	}
+	return parts;
+}
+
+/// Fixed-capacity unsigned integer large enough to hold the exact value
+/// (or exact fractional numerator) of any double multiplied by 10^9, or
+/// the scaled value and boundaries of exact_shortest_digits.
+class float_bignum
+{
+public:
+	static constexpr int max_limbs = 36;
+
+	/// Assigns value * 2^shift.
+	void assign(std::uint64_t value, int shift)
+	{
+		for (int i = 0; i != _size; ++i)
+		{
+			_limbs[i] = 0;
+		}
+		_size = 0;
+
+		int const index = shift / 32;
+		int const bit = shift % 32;
+		std::uint32_t const low = static_cast<std::uint32_t>(value);
+		std::uint32_t const high = static_cast<std::uint32_t>(value >> 32);
+
+		if (bit == 0)
+		{
+			_limbs[index] = low;
+			_limbs[index + 1] = high;
+			_limbs[index + 2] = 0;
+		}
+		else
+		{
+			_limbs[index] = low << bit;
+			_limbs[index + 1] = (high << bit) | (low >> (32 - bit));
+			_limbs[index + 2] = high >> (32 - bit);
+		}
+		_size = index + 3;
+		_trim();
+	}
+
+	bool zero() const { return _size == 0; }
+
+	void multiply(std::uint32_t factor)
+	{
+		std::uint64_t carry = 0;
+		for (int i = 0; i != _size; ++i)
+		{
+			std::uint64_t const product = std::uint64_t(_limbs[i]) * factor + carry;
+			_limbs[i] = static_cast<std::uint32_t>(product);
+			carry = product >> 32;
+		}
+		if (carry != 0)
+		{
+			_limbs[_size++] = static_cast<std::uint32_t>(carry);
+		}
+	}
+
+	/// Divides in place and returns the remainder.
+	std::uint32_t divide(std::uint32_t divisor)
+	{
+		std::uint64_t remainder = 0;
+		for (int i = _size; i-- != 0;)
+		{
+			std::uint64_t const current = (remainder << 32) | _limbs[i];
+			_limbs[i] = static_cast<std::uint32_t>(current / divisor);
+			remainder = current % divisor;
+		}
+		_trim();
+		return static_cast<std::uint32_t>(remainder);
+	}
+
+	/// Multiplies in place by 10^exponent.
+	void multiply_pow10(int exponent)
+	{
+		for (; exponent >= 9; exponent -= 9)
+		{
+			multiply(1000000000);
+		}
+		for (; exponent != 0; --exponent)
+		{
+			multiply(10);
+		}
+	}
+
+	void add(float_bignum const& rhs)
+	{
+		int const size = _size > rhs._size ? _size : rhs._size;
+		std::uint64_t carry = 0;
+		for (int i = 0; i != size; ++i)
+		{
+			std::uint64_t const sum = std::uint64_t(_limbs[i]) + rhs._limbs[i] + carry;
+			_limbs[i] = static_cast<std::uint32_t>(sum);
+			carry = sum >> 32;
+		}
+		_size = size;
+		if (carry != 0)
+		{
+			_limbs[_size++] = static_cast<std::uint32_t>(carry);
+		}
+	}
+
+	/// Subtracts rhs, which must not be greater.
+	void subtract(float_bignum const& rhs)
+	{
+		std::uint64_t borrow = 0;
+		for (int i = 0; i != _size; ++i)
+		{
+			std::uint64_t const difference = std::uint64_t(_limbs[i]) - rhs._limbs[i] - borrow;
+			_limbs[i] = static_cast<std::uint32_t>(difference);
+			borrow = (difference >> 32) & 1;
+		}
+		_trim();
+	}
+
+	/// Returns a negative, zero or positive value as lhs is less than, equal to or greater than rhs.
+	static int compare(float_bignum const& lhs, float_bignum const& rhs)
+	{
+		if (lhs._size != rhs._size)
+		{
+			return lhs._size < rhs._size ? -1 : 1;
+		}
+		for (int i = lhs._size; i-- != 0;)
+		{
+			if (lhs._limbs[i] != rhs._limbs[i])
+			{
+				return lhs._limbs[i] < rhs._limbs[i] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	/// Removes and returns every bit at or above position shift; the result must fit in 32 bits.
+	std::uint32_t extract(int shift)
+	{
+		int const index = shift / 32;
+		int const bit = shift % 32;
+		if (index >= _size)
+		{
+			return 0;
+		}
+
+		std::uint64_t high = _limbs[index];
+		if (index + 1 < _size)
+		{
+			high |= std::uint64_t(_limbs[index + 1]) << 32;
+		}
+		std::uint32_t const result = static_cast<std::uint32_t>(high >> bit);
+
+		_limbs[index] &= bit == 0 ? 0 : (std::uint32_t(1) << bit) - 1;
+		for (int i = index + 1; i < _size; ++i)
+		{
+			_limbs[i] = 0;
+		}
+		_size = index + 1;
+		_trim();
+		return result;
+	}
+
+private:
+	void _trim()
+	{
+		while (_size != 0 && _limbs[_size - 1] == 0)
+		{
+			--_size;
+		}
+	}
+
+	std::uint32_t _limbs[max_limbs] = {};
+	int _size = 0;
+};
+
+/// Produces the exact decimal digits of mantissa * 2^exponent, starting with
+/// the integer part and continuing (without end) into the fraction.
+class exact_digits
+{
+public:
+	static constexpr int max_integer_digits = 310;
+
+	exact_digits(std::uint64_t mantissa, int exponent)
+	{
+		if (exponent >= 0)
+		{
+			float_bignum integer;
+			integer.assign(mantissa, exponent);
+			_set_integer(integer);
+		}
+		else if (exponent > -64)
+		{
+			_set_integer(mantissa >> -exponent);
+			_shift = -exponent;
+			_fraction.assign(mantissa & ((std::uint64_t(1) << _shift) - 1), 0);
+		}
+		else
+		{
+			_shift = -exponent;
+			_fraction.assign(mantissa, 0);
+		}
+	}
+
+	/// Digits in the integer part, or 0 if the integer part is zero.
+	int integer_size() const { return _integer_size; }
+
+	int next()
+	{
+		if (_integer_pos != _integer_size)
+		{
+			return _integer[_integer_pos++];
+		}
+		if (_chunk_pos == chunk_size)
+		{
+			_refill();
+		}
+		return _chunk[_chunk_pos++];
+	}
+
+	/// Skips leading zeros, returning the count skipped; the value must be non-zero.
+	int skip_zeroes()
+	{
+		int count = 0;
+		for (;;)
+		{
+			if (_integer_pos != _integer_size)
+			{
+				if (_integer[_integer_pos] != 0)
+				{
+					return count;
+				}
+				++_integer_pos;
+			}
+			else
+			{
+				if (_chunk_pos == chunk_size)
+				{
+					_refill();
+				}
+				if (_chunk[_chunk_pos] != 0)
+				{
+					return count;
+				}
+				++_chunk_pos;
+			}
+			++count;
+		}
+	}
+
+	/// True if every remaining digit is zero.
+	bool remaining_zero() const
+	{
+		for (int i = _integer_pos; i != _integer_size; ++i)
+		{
+			if (_integer[i] != 0)
+			{
+				return false;
+			}
+		}
+		for (int i = _chunk_pos; i != chunk_size; ++i)
+		{
+			if (_chunk[i] != 0)
+			{
+				return false;
+			}
+		}
+		return _fraction.zero();
+	}
+
+private:
+	static constexpr int chunk_size = 9;
+	static constexpr std::uint32_t chunk_scale = 1000000000;
+
+	void _set_integer(std::uint64_t value)
+	{
+		char reversed[20];
+		int count = 0;
+		while (value != 0)
+		{
+			reversed[count++] = static_cast<char>(value % 10);
+			value /= 10;
+		}
+		while (count != 0)
+		{
+			_integer[_integer_size++] = reversed[--count];
+		}
+	}
+
+	void _set_integer(float_bignum& value)
+	{
+		std::uint32_t chunks[float_bignum::max_limbs + 1];
+		int count = 0;
+		while (!value.zero())
+		{
+			chunks[count++] = value.divide(chunk_scale);
+		}
+		if (count == 0)
+		{
+			return;
+		}
+
+		_set_integer(chunks[--count]);
+		while (count != 0)
+		{
+			std::uint32_t chunk = chunks[--count];
+			for (int i = chunk_size; i-- != 0;)
+			{
+				_integer[_integer_size + i] = static_cast<char>(chunk % 10);
+				chunk /= 10;
+			}
+			_integer_size += chunk_size;
+		}
+	}
+
+	void _refill()
+	{
+		std::uint32_t chunk = 0;
+		if (!_fraction.zero())
+		{
+			_fraction.multiply(chunk_scale);
+			chunk = _fraction.extract(_shift);
+		}
+		for (int i = chunk_size; i-- != 0;)
+		{
+			_chunk[i] = static_cast<char>(chunk % 10);
+			chunk /= 10;
+		}
+		_chunk_pos = 0;
+	}
+
+	char _integer[max_integer_digits];
+	int _integer_size = 0;
+	int _integer_pos = 0;
+	float_bignum _fraction;
+	int _shift = 0;
+	char _chunk[chunk_size] = {};
+	int _chunk_pos = chunk_size;
+};
+
+/// Rounds a digit sequence to nearest, ties to even, given the next digit and whether any
+/// non-zero digits follow it. Returns true if the carry overflowed the first digit, in which
+/// case digits now holds 1 followed by zeros.
+inline bool round_digits(char* digits, int count, int next, bool exact)
+{
+	bool const odd = count != 0 && (digits[count - 1] & 1) != 0;
+	if (next < 5 || (next == 5 && exact && !odd))
+	{
+		return false;
+	}
+
+	for (int i = count; i-- != 0;)
+	{
+		if (digits[i] != 9)
+		{
+			++digits[i];
+			return false;
+		}
+		digits[i] = 0;
+	}
+	if (count != 0)
+	{
+		digits[0] = 1;
+	}
+	return true;
+}
+
+/// Shortest round-trip digit generation, following Grisu3 as described by
+/// Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers".
+namespace grisu {
+
+struct diy_fp
+{
+	std::uint64_t f;
+	int e;
+};
+
+inline diy_fp subtract(diy_fp x, diy_fp y) { return {x.f - y.f, x.e}; }
+
+inline diy_fp multiply(diy_fp x, diy_fp y)
+{
+	std::uint64_t const x_lo = x.f & 0xFFFFFFFFu;
+	std::uint64_t const x_hi = x.f >> 32;
+	std::uint64_t const y_lo = y.f & 0xFFFFFFFFu;
+	std::uint64_t const y_hi = y.f >> 32;
+
+	std::uint64_t const p0 = x_lo * y_lo;
+	std::uint64_t const p1 = x_lo * y_hi;
+	std::uint64_t const p2 = x_hi * y_lo;
+	std::uint64_t const p3 = x_hi * y_hi;
+
+	std::uint64_t middle = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+	middle += std::uint64_t(1) << 31; // round to nearest
+
+	return {p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32), x.e + y.e + 64};
+}
+
+inline diy_fp normalize(diy_fp x)
+{
+	int const shift = count_leading_zeroes(x.f);
+	return {x.f << shift, x.e - shift};
+}
+
+inline diy_fp normalize_to(diy_fp x, int e) { return {x.f << (x.e - e), e}; }
+
+struct cached_power
+{
+	std::uint64_t f;
+	int e;
+	int k;
+};
+
+/// Normalized approximations of 10^k for k = -300, -292, ..., 324.
+inline cached_power get_cached_power(int e)
+{
+	static constexpr cached_power powers[] = {
+		{0xAB70FE17C79AC6CA, -1060, -300},
+		{0xFF77B1FCBEBCDC4F, -1034, -292},
+		{0xBE5691EF416BD60C, -1007, -284},
+		{0x8DD01FAD907FFC3C,  -980, -276},
+		{0xD3515C2831559A83,  -954, -268},
+		{0x9D71AC8FADA6C9B5,  -927, -260},
+		{0xEA9C227723EE8BCB,  -901, -252},
+		{0xAECC49914078536D,  -874, -244},
+		{0x823C12795DB6CE57,  -847, -236},
+		{0xC21094364DFB5637,  -821, -228},
+		{0x9096EA6F3848984F,  -794, -220},
+		{0xD77485CB25823AC7,  -768, -212},
+		{0xA086CFCD97BF97F4,  -741, -204},
+		{0xEF340A98172AACE5,  -715, -196},
+		{0xB23867FB2A35B28E,  -688, -188},
+		{0x84C8D4DFD2C63F3B,  -661, -180},
+		{0xC5DD44271AD3CDBA,  -635, -172},
+		{0x936B9FCEBB25C996,  -608, -164},
+		{0xDBAC6C247D62A584,  -582, -156},
+		{0xA3AB66580D5FDAF6,  -555, -148},
+		{0xF3E2F893DEC3F126,  -529, -140},
+		{0xB5B5ADA8AAFF80B8,  -502, -132},
+		{0x87625F056C7C4A8B,  -475, -124},
+		{0xC9BCFF6034C13053,  -449, -116},
+		{0x964E858C91BA2655,  -422, -108},
+		{0xDFF9772470297EBD,  -396, -100},
+		{0xA6DFBD9FB8E5B88F,  -369,  -92},
+		{0xF8A95FCF88747D94,  -343,  -84},
+		{0xB94470938FA89BCF,  -316,  -76},
+		{0x8A08F0F8BF0F156B,  -289,  -68},
+		{0xCDB02555653131B6,  -263,  -60},
+		{0x993FE2C6D07B7FAC,  -236,  -52},
+		{0xE45C10C42A2B3B06,  -210,  -44},
+		{0xAA242499697392D3,  -183,  -36},
+		{0xFD87B5F28300CA0E,  -157,  -28},
+		{0xBCE5086492111AEB,  -130,  -20},
+		{0x8CBCCC096F5088CC,  -103,  -12},
+		{0xD1B71758E219652C,   -77,   -4},
+		{0x9C40000000000000,   -50,    4},
+		{0xE8D4A51000000000,   -24,   12},
+		{0xAD78EBC5AC620000,     3,   20},
+		{0x813F3978F8940984,    30,   28},
+		{0xC097CE7BC90715B3,    56,   36},
+		{0x8F7E32CE7BEA5C70,    83,   44},
+		{0xD5D238A4ABE98068,   109,   52},
+		{0x9F4F2726179A2245,   136,   60},
+		{0xED63A231D4C4FB27,   162,   68},
+		{0xB0DE65388CC8ADA8,   189,   76},
+		{0x83C7088E1AAB65DB,   216,   84},
+		{0xC45D1DF942711D9A,   242,   92},
+		{0x924D692CA61BE758,   269,  100},
+		{0xDA01EE641A708DEA,   295,  108},
+		{0xA26DA3999AEF774A,   322,  116},
+		{0xF209787BB47D6B85,   348,  124},
+		{0xB454E4A179DD1877,   375,  132},
+		{0x865B86925B9BC5C2,   402,  140},
+		{0xC83553C5C8965D3D,   428,  148},
+		{0x952AB45CFA97A0B3,   455,  156},
+		{0xDE469FBD99A05FE3,   481,  164},
+		{0xA59BC234DB398C25,   508,  172},
+		{0xF6C69A72A3989F5C,   534,  180},
+		{0xB7DCBF5354E9BECE,   561,  188},
+		{0x88FCF317F22241E2,   588,  196},
+		{0xCC20CE9BD35C78A5,   614,  204},
+		{0x98165AF37B2153DF,   641,  212},
+		{0xE2A0B5DC971F303A,   667,  220},
+		{0xA8D9D1535CE3B396,   694,  228},
+		{0xFB9B7CD9A4A7443C,   720,  236},
+		{0xBB764C4CA7A44410,   747,  244},
+		{0x8BAB8EEFB6409C1A,   774,  252},
+		{0xD01FEF10A657842C,   800,  260},
+		{0x9B10A4E5E9913129,   827,  268},
+		{0xE7109BFBA19C0C9D,   853,  276},
+		{0xAC2820D9623BF429,   880,  284},
+		{0x80444B5E7AA7CF85,   907,  292},
+		{0xBF21E44003ACDD2D,   933,  300},
+		{0x8E679C2F5E44FF8F,   960,  308},
+		{0xD433179D9C8CB841,   986,  316},
+		{0x9E19DB92B4E31BA9,  1013,  324}
+	};
+
+	constexpr int alpha = -60;
+	constexpr int min_decimal_exponent = -300;
+	constexpr int decimal_step = 8;
+
+	int const f = alpha - e - 1;
+	int const k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+	int const index = (-min_decimal_exponent + k + (decimal_step - 1)) / decimal_step;
+	return powers[index];
+}
+
+inline std::uint32_t pow10_u32(int n)
+{
+	static constexpr std::uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+	return powers[n];
+}
+
+inline int count_digits_u32(std::uint32_t n)
+{
+	int digits = 1;
+	while (digits < 10 && n >= pow10_u32(digits))
+	{
+		++digits;
+	}
+	return digits;
+}
+
+/// Splits off the leading digit of value, which has exactly digits digits;
+/// the constant divisors avoid hardware division.
+inline std::uint32_t split_leading_digit(std::uint32_t& value, int digits)
+{
+	std::uint32_t digit = 0;
+	switch (digits)
+	{
+	case 10: digit = value / 1000000000; value %= 1000000000; break;
+	case 9: digit = value / 100000000; value %= 100000000; break;
+	case 8: digit = value / 10000000; value %= 10000000; break;
+	case 7: digit = value / 1000000; value %= 1000000; break;
+	case 6: digit = value / 100000; value %= 100000; break;
+	case 5: digit = value / 10000; value %= 10000; break;
+	case 4: digit = value / 1000; value %= 1000; break;
+	case 3: digit = value / 100; value %= 100; break;
+	case 2: digit = value / 10; value %= 10; break;
+	default: digit = value; value = 0; break;
+	}
+	return digit;
+}
+
+/// Moves the last digit towards w while that stays within the interval, then reports whether
+/// the result is certainly the closest shortest one despite the unit of error in the inputs.
+inline bool round_weed(char* buffer, int length, std::uint64_t distance_too_high_w, std::uint64_t unsafe_interval, std::uint64_t rest, std::uint64_t ten_kappa, std::uint64_t unit)
+{
+	std::uint64_t const small_distance = distance_too_high_w - unit;
+	std::uint64_t const big_distance = distance_too_high_w + unit;
+
+	while (rest < small_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance))
+	{
+		--buffer[length - 1];
+		rest += ten_kappa;
+	}
+
+	// another candidate could be closer, once the error is taken into account
+	if (rest < big_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance))
+	{
+		return false;
+	}
+
+	// the candidate must be safely inside the interval
+	return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+/// Grisu3 digit generation within the scaled boundaries low and high; returns false
+/// if the digits cannot be proven shortest and closest, in which case they are unusable.
+inline bool generate_digits(char* buffer, int& length, int& decimal_exponent, diy_fp low, diy_fp w, diy_fp high)
+{
+	std::uint64_t unit = 1;
+	diy_fp const too_low = {low.f - unit, low.e};
+	diy_fp const too_high = {high.f + unit, high.e};
+	std::uint64_t unsafe_interval = subtract(too_high, too_low).f;
+	std::uint64_t const distance = subtract(too_high, w).f;
+
+	diy_fp const one = {std::uint64_t(1) << -w.e, w.e};
+
+	std::uint32_t p1 = static_cast<std::uint32_t>(too_high.f >> -one.e);
+	std::uint64_t p2 = too_high.f & (one.f - 1);
+
+	int n = count_digits_u32(p1);
+	while (n > 0)
+	{
+		buffer[length++] = static_cast<char>(split_leading_digit(p1, n));
+		--n;
+
+		std::uint64_t const rest = (std::uint64_t(p1) << -one.e) + p2;
+		if (rest < unsafe_interval)
+		{
+			decimal_exponent += n;
+			return round_weed(buffer, length, distance, unsafe_interval, rest, std::uint64_t(pow10_u32(n)) << -one.e, unit);
+		}
+	}
+
+	int m = 0;
+	for (;;)
+	{
+		p2 *= 10;
+		unit *= 10;
+		unsafe_interval *= 10;
+		buffer[length++] = static_cast<char>(p2 >> -one.e);
+		p2 &= one.f - 1;
+		++m;
+
+		if (p2 < unsafe_interval)
+		{
+			decimal_exponent -= m;
+			return round_weed(buffer, length, distance * unit, unsafe_interval, p2, one.f, unit);
+		}
+	}
+}
+
+} // namespace grisu
+
+/// Generates the shortest digit string that round-trips, closest to the exact value, with bignums,
+/// following Steele and White's free-format algorithm; the fallback for values Grisu3 cannot decide.
+/// Receives at most 17 digits, with value == digits * 10^decimal_exponent.
+inline int exact_shortest_digits(std::uint64_t mantissa, int exponent, bool lower_closer, char* digits, int& decimal_exponent)
+{
+	// value == numerator / denominator, and the rounding boundaries are value + plus and value - minus,
+	// all scaled by 4 so that a boundary a quarter of a unit away is still an integer
+	float_bignum numerator;
+	float_bignum denominator;
+	float_bignum plus;
+	float_bignum minus;
+	if (exponent >= 0)
+	{
+		numerator.assign(mantissa, exponent + 2);
+		denominator.assign(4, 0);
+		plus.assign(1, exponent + 1);
+		minus.assign(1, lower_closer ? exponent : exponent + 1);
+	}
+	else
+	{
+		numerator.assign(mantissa, 2);
+		denominator.assign(1, 2 - exponent);
+		plus.assign(2, 0);
+		minus.assign(lower_closer ? 1 : 2, 0);
+	}
+
+	// floor(log10(2^magnitude)) never overestimates the number of integer digits, so this starts
+	// at most two below the exponent just past the first digit, and is raised to it below
+	int const magnitude = 63 - count_leading_zeroes(mantissa) + exponent;
+	int k = magnitude >= 0 ? (magnitude * 78913) >> 18 : -((-magnitude * 78913 + (1 << 18) - 1) >> 18);
+	if (k >= 0)
+	{
+		denominator.multiply_pow10(k);
+	}
+	else
+	{
+		numerator.multiply_pow10(-k);
+		plus.multiply_pow10(-k);
+		minus.multiply_pow10(-k);
+	}
+
+	// values exactly on a boundary round to the even mantissa, so such a boundary is in range
+	bool const even = (mantissa & 1) == 0;
+	auto const reaches_high = [&](float_bignum const& rest) {
+		float_bignum sum = rest;
+		sum.add(plus);
+		int const order = float_bignum::compare(sum, denominator);
+		return even ? order >= 0 : order > 0;
+	};
+
+	while (reaches_high(numerator))
+	{
+		denominator.multiply(10);
+		++k;
+	}
+
+	int length = 0;
+	for (;;)
+	{
+		numerator.multiply(10);
+		plus.multiply(10);
+		minus.multiply(10);
+
+		int digit = 0;
+		while (float_bignum::compare(numerator, denominator) >= 0)
+		{
+			numerator.subtract(denominator);
+			++digit;
+		}
+
+		int const low_order = float_bignum::compare(numerator, minus);
+		bool const low = even ? low_order <= 0 : low_order < 0;
+		bool const high = reaches_high(numerator);
+		if (!low && !high)
+		{
+			digits[length++] = static_cast<char>(digit);
+			continue;
+		}
+
+		if (low && high)
+		{
+			// both neighbours round-trip; take the closer, or the even one on a tie
+			numerator.multiply(2);
+			int const half = float_bignum::compare(numerator, denominator);
+			digit += half > 0 || (half == 0 && (digit & 1) != 0);
+		}
+		else if (high)
+		{
+			++digit;
+		}
+		digits[length++] = static_cast<char>(digit);
+		break;
+	}
+
+	decimal_exponent = k - length;
+	return length;
+}
+
+/// Generates the shortest digit string that round-trips to the original value of the given
+/// precision, closest to the exact value; the value must be finite and non-zero.
+/// Grisu3 decides nearly every value, and the rest fall back to exact_shortest_digits.
+/// Receives at most 17 digits, with value == digits * 10^decimal_exponent.
+template <typename FloatT>
+int shortest_digits(float_parts const& parts, char* digits, int& decimal_exponent)
+{
+	using namespace grisu;
+
+	diy_fp const v = {parts.mantissa, parts.exponent};
+	bool const lower_closer = parts.normal && parts.mantissa == (std::uint64_t(1) << (std::numeric_limits<FloatT>::digits - 1)) && parts.exponent > std::numeric_limits<FloatT>::min_exponent - std::numeric_limits<FloatT>::digits;
+
+	diy_fp const plus = normalize({2 * v.f + 1, v.e - 1});
+	diy_fp const minus = normalize_to(lower_closer ? diy_fp{4 * v.f - 1, v.e - 2} : diy_fp{2 * v.f - 1, v.e - 1}, plus.e);
+	diy_fp const value = normalize(v);
+
+	cached_power const cached = get_cached_power(plus.e);
+	diy_fp const c_minus_k = {cached.f, cached.e};
+
+	diy_fp const w = multiply(value, c_minus_k);
+	diy_fp const w_minus = multiply(minus, c_minus_k);
+	diy_fp const w_plus = multiply(plus, c_minus_k);
+
+	int length = 0;
+	decimal_exponent = -cached.k;
+	if (generate_digits(digits, length, decimal_exponent, w_minus, w, w_plus))
+	{
+		return length;
+	}
+	return exact_shortest_digits(parts.mantissa, parts.exponent, lower_closer, digits, decimal_exponent);
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_FLOAT_DIGITS_H
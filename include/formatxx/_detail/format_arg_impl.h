@@ -0,0 +1,98 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_FORMAT_ARG_IMPL_H)
+#define _guard_FORMATXX_DETAIL_FORMAT_ARG_IMPL_H
+#pragma once
+
+namespace formatxx {
+namespace _detail {
+
+template <typename CharT, typename T>
+void format_builtin(basic_format_writer<CharT>& out, T value, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+{
+	if (spec != nullptr)
+	{
+		format_value(out, value, *spec);
+	}
+	else
+	{
+		format_value(out, value, spec_string);
+	}
+}
+
+/// Formats a string the caller passed as an argument, which is stable for the whole call.
+template <typename CharT>
+void format_builtin_string(basic_format_writer<CharT>& out, basic_string_view<CharT> value, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+{
+	if (spec != nullptr)
+	{
+		write_string(out, value, *spec, true);
+	}
+	else
+	{
+		write_string(out, value, parse_format_spec(spec_string), true);
+	}
+}
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API format_builtin_arg(basic_format_writer<CharT>& out, basic_format_arg<CharT> const& arg, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+{
+	using type = typename basic_format_arg<CharT>::type;
+
+	switch (arg.kind)
+	{
+	case type::boolean: format_builtin(out, arg.value.boolean, spec_string, spec); break;
+	case type::character: format_builtin(out, arg.value.character, spec_string, spec); break;
+	case type::signed_char: format_builtin(out, static_cast<signed char>(arg.value.signed_integer), spec_string, spec); break;
+	case type::signed_short: format_builtin(out, static_cast<signed short>(arg.value.signed_integer), spec_string, spec); break;
+	case type::signed_int: format_builtin(out, static_cast<signed int>(arg.value.signed_integer), spec_string, spec); break;
+	case type::signed_long: format_builtin(out, static_cast<signed long>(arg.value.signed_integer), spec_string, spec); break;
+	case type::signed_long_long: format_builtin(out, arg.value.signed_integer, spec_string, spec); break;
+	case type::unsigned_char: format_builtin(out, static_cast<unsigned char>(arg.value.unsigned_integer), spec_string, spec); break;
+	case type::unsigned_short: format_builtin(out, static_cast<unsigned short>(arg.value.unsigned_integer), spec_string, spec); break;
+	case type::unsigned_int: format_builtin(out, static_cast<unsigned int>(arg.value.unsigned_integer), spec_string, spec); break;
+	case type::unsigned_long: format_builtin(out, static_cast<unsigned long>(arg.value.unsigned_integer), spec_string, spec); break;
+	case type::unsigned_long_long: format_builtin(out, arg.value.unsigned_integer, spec_string, spec); break;
+	case type::single_float: format_builtin(out, arg.value.single_float, spec_string, spec); break;
+	case type::double_float: format_builtin(out, arg.value.double_float, spec_string, spec); break;
+	case type::zstring: format_builtin_string(out, basic_string_view<CharT>(arg.value.zstring), spec_string, spec); break;
+	case type::string: format_builtin_string(out, basic_string_view<CharT>(arg.value.string.data, arg.value.string.size), spec_string, spec); break;
+	case type::pointer: format_builtin(out, arg.value.pointer, spec_string, spec); break;
+	case type::bytes: format_builtin(out, hex_bytes(arg.value.bytes.data, arg.value.bytes.size), spec_string, spec); break;
+	case type::custom: return arg.value.custom.thunk(out, arg.value.custom.pointer, spec_string, spec);
+	}
+	return result_code::success;
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_FORMAT_ARG_IMPL_H
@@ -32,11 +32,21 @@
 #define _guard_FORMATXX_DETAIL_FORMAT_IMPL_H
 #pragma once
 
+#include "find_char.h"
+
+#if defined(FORMATXX_INSTRUMENT)
+#	include "instrument_impl.h"
+#endif
+
 namespace formatxx {
 namespace _detail {
 
-template <typename CharT>
-FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>& out, basic_string_view<CharT> format, basic_format_args<CharT> args)
+/// Parses a {}-style format string, handing each literal span and argument reference to a receiver.
+/// The receiver must provide `literal(basic_string_view<CharT>)` and
+/// `argument(unsigned index, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)`,
+/// the latter returning a result_code; spec is nullptr when the parser has not parsed the spec.
+template <typename CharT, typename ReceiverT>
+result_code parse_format(basic_string_view<CharT> format, ReceiverT& receiver)
 {
 	unsigned next_index = 0;
 	result_code result = result_code::success;
@@ -47,16 +57,15 @@ FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>&
 
 	while (iter < end)
 	{
-		if (*iter != FormatTraits<CharT>::cFormatBegin)
-		{
-			++iter;
-		}
-		else
+		// skip the entire literal span up to the next directive
+		iter = find_char(iter, end, FormatTraits<CharT>::cFormatBegin);
+		if (iter != end)
 		{
 			// write out the string so far, since we don't write characters immediately
 			if (iter > begin)
 			{
-				out.write({begin, iter});
+				receiver.literal({begin, iter});
+				begin = iter;
 			}
 
 			++iter; // swallow the {
@@ -102,10 +111,7 @@ FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>&
 				++iter; // eat separator
 				CharT const* const spec_begin = iter;
 
-				while (iter < end && *iter != FormatTraits<CharT>::cFormatEnd)
-				{
-					++iter;
-				}
+				iter = find_char(iter, end, FormatTraits<CharT>::cFormatEnd);
 
 				if (iter == end)
 				{
@@ -126,7 +132,7 @@ FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>&
 				continue;
 			}
 
-			result_code const arg_result = args.format_arg(out, index, spec);
+			result_code const arg_result = receiver.argument(index, spec, nullptr);
 			if (arg_result != result_code::success)
 			{
 				result = arg_result;
@@ -143,12 +149,45 @@ FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>&
 	// write out tail end of format string
 	if (iter > begin)
 	{
-		out.write({begin, iter});
+		receiver.literal({begin, iter});
 	}
 
 	return result;
 }
 
+/// Receiver for the parsers that immediately formats into a writer.
+template <typename CharT>
+class format_receiver
+{
+public:
+	format_receiver(basic_format_writer<CharT>& out, basic_format_args<CharT> const& args) : _out(out), _args(args) {}
+
+	void literal(basic_string_view<CharT> text) { _out.put_stable(text); }
+	result_code argument(unsigned index, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec) { return _args.format_arg(_out, index, spec_string, spec); }
+
+private:
+	basic_format_writer<CharT>& _out;
+	basic_format_args<CharT> const& _args;
+};
+
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>& out, basic_string_view<CharT> format, basic_format_args<CharT> args)
+{
+#if defined(FORMATXX_INSTRUMENT)
+	if (unsigned const mode = instrument_mode())
+	{
+		return instrument_call(mode, out, format, [&](basic_format_writer<CharT>& writer)
+		{
+			format_receiver<CharT> receiver(writer, args);
+			return parse_format(format, receiver);
+		});
+	}
+#endif
+
+	format_receiver<CharT> receiver(out, args);
+	return parse_format(format, receiver);
+}
+
 } // namespace _detail
 } // namespace formatxx
 
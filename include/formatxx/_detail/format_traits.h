@@ -58,9 +58,6 @@ template <> struct FormatTraits<char>
 	static constexpr string_view sTrue{"true", 4};
 	static constexpr string_view sFalse{"false", 5};
 
-	static constexpr string_view sPrintfSpecifiers{"bcCsSdioxXufFeEaAgGp", 20};
-	static constexpr string_view sPrintfModifiers{"hljztL", 6};
-
 	static constexpr char const sDecimalPairs[] =
 		"00010203040506070809"
 		"10111213141516171819"
@@ -74,15 +71,44 @@ template <> struct FormatTraits<char>
 		"90919293949596979899";
 	static constexpr char const sHexadecimalLower[] = "0123456789abcdef";
 	static constexpr char const sHexadecimalUpper[] = "0123456789ABCDEF";
+
+	// two characters per byte value, indexed by byte * 2
+	static constexpr char const sHexadecimalPairsLower[] =
+		"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+		"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+		"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+		"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+		"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+		"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+		"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+		"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+	static constexpr char const sHexadecimalPairsUpper[] =
+		"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+		"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+		"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+		"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+		"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+		"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+		"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+	// two octal digits per 6 bits, indexed by bits * 2
+	static constexpr char const sOctalPairs[] =
+		"0001020304050607101112131415161720212223242526273031323334353637"
+		"4041424344454647505152535455565760616263646566677071727374757677";
+	// four binary digits per nibble, indexed by nibble * 4
+	static constexpr char const sBinaryNibbles[] =
+		"0000000100100011010001010110011110001001101010111100110111101111";
 };
 
 constexpr string_view FormatTraits<char>::sTrue;
 constexpr string_view FormatTraits<char>::sFalse;
-constexpr string_view FormatTraits<char>::sPrintfSpecifiers;
-constexpr string_view FormatTraits<char>::sPrintfModifiers;
 constexpr char const FormatTraits<char>::sDecimalPairs[];
 constexpr char const FormatTraits<char>::sHexadecimalLower[];
 constexpr char const FormatTraits<char>::sHexadecimalUpper[];
+constexpr char const FormatTraits<char>::sHexadecimalPairsLower[];
+constexpr char const FormatTraits<char>::sHexadecimalPairsUpper[];
+constexpr char const FormatTraits<char>::sOctalPairs[];
+constexpr char const FormatTraits<char>::sBinaryNibbles[];
 
 template <> struct FormatTraits<wchar_t>
 {
@@ -101,11 +127,8 @@ template <> struct FormatTraits<wchar_t>
 	static constexpr wchar_t cPrintfSpec = L'%';
 	static constexpr wchar_t cPrintfIndex = L'$';
 
-	static constexpr wstring_view sTrue{L"true", 4};
-	static constexpr wstring_view sFalse{L"false", 5};
-
-	static constexpr wstring_view sPrintfSpecifiers{L"bcCsSdioxXufFeEaAgGp", 20};
-	static constexpr wstring_view sPrintfModifiers{L"hljztL", 6};
+	static constexpr basic_string_view<wchar_t> sTrue{L"true", 4};
+	static constexpr basic_string_view<wchar_t> sFalse{L"false", 5};
 
 	static constexpr wchar_t const sDecimalPairs[] =
 		L"00010203040506070809"
@@ -120,15 +143,262 @@ template <> struct FormatTraits<wchar_t>
 		L"90919293949596979899";
 	static constexpr wchar_t const sHexadecimalLower[] = L"0123456789abcdef";
 	static constexpr wchar_t const sHexadecimalUpper[] = L"0123456789ABCDEF";
+
+	// two characters per byte value, indexed by byte * 2
+	static constexpr wchar_t const sHexadecimalPairsLower[] =
+		L"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+		L"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+		L"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+		L"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+		L"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+		L"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+		L"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+		L"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+	static constexpr wchar_t const sHexadecimalPairsUpper[] =
+		L"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		L"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+		L"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+		L"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+		L"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+		L"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+		L"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+		L"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+	// two octal digits per 6 bits, indexed by bits * 2
+	static constexpr wchar_t const sOctalPairs[] =
+		L"0001020304050607101112131415161720212223242526273031323334353637"
+		L"4041424344454647505152535455565760616263646566677071727374757677";
+	// four binary digits per nibble, indexed by nibble * 4
+	static constexpr wchar_t const sBinaryNibbles[] =
+		L"0000000100100011010001010110011110001001101010111100110111101111";
 };
 
-constexpr wstring_view FormatTraits<wchar_t>::sTrue;
-constexpr wstring_view FormatTraits<wchar_t>::sFalse;
-constexpr wstring_view FormatTraits<wchar_t>::sPrintfSpecifiers;
-constexpr wstring_view FormatTraits<wchar_t>::sPrintfModifiers;
+constexpr basic_string_view<wchar_t> FormatTraits<wchar_t>::sTrue;
+constexpr basic_string_view<wchar_t> FormatTraits<wchar_t>::sFalse;
 constexpr wchar_t const FormatTraits<wchar_t>::sDecimalPairs[];
 constexpr wchar_t const FormatTraits<wchar_t>::sHexadecimalLower[];
 constexpr wchar_t const FormatTraits<wchar_t>::sHexadecimalUpper[];
+constexpr wchar_t const FormatTraits<wchar_t>::sHexadecimalPairsLower[];
+constexpr wchar_t const FormatTraits<wchar_t>::sHexadecimalPairsUpper[];
+constexpr wchar_t const FormatTraits<wchar_t>::sOctalPairs[];
+constexpr wchar_t const FormatTraits<wchar_t>::sBinaryNibbles[];
+
+template <> struct FormatTraits<char16_t>
+{
+	static constexpr char16_t cFormatBegin = u'{';
+	static constexpr char16_t cFormatEnd = u'}';
+	static constexpr char16_t cFormatSep = u':';
+
+	static constexpr char16_t cPlus = u'+';
+	static constexpr char16_t cMinus = u'-';
+	static constexpr char16_t cSpace = u' ';
+	static constexpr char16_t cHash = u'#';
+	static constexpr char16_t cDot = u'.';
+
+	static constexpr char16_t to_digit(char16_t c) { return c + u'0'; }
+
+	static constexpr char16_t cPrintfSpec = u'%';
+	static constexpr char16_t cPrintfIndex = u'$';
+
+	static constexpr basic_string_view<char16_t> sTrue{u"true", 4};
+	static constexpr basic_string_view<char16_t> sFalse{u"false", 5};
+
+	static constexpr char16_t const sDecimalPairs[] =
+		u"00010203040506070809"
+		u"10111213141516171819"
+		u"20212223242526272829"
+		u"30313233343536373839"
+		u"40414243444546474849"
+		u"50515253545556575859"
+		u"60616263646566676869"
+		u"70717273747576777879"
+		u"80818283848586878889"
+		u"90919293949596979899";
+	static constexpr char16_t const sHexadecimalLower[] = u"0123456789abcdef";
+	static constexpr char16_t const sHexadecimalUpper[] = u"0123456789ABCDEF";
+
+	// two characters per byte value, indexed by byte * 2
+	static constexpr char16_t const sHexadecimalPairsLower[] =
+		u"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+		u"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+		u"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+		u"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+		u"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+		u"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+		u"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+		u"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+	static constexpr char16_t const sHexadecimalPairsUpper[] =
+		u"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		u"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+		u"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+		u"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+		u"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+		u"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+		u"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+		u"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+	// two octal digits per 6 bits, indexed by bits * 2
+	static constexpr char16_t const sOctalPairs[] =
+		u"0001020304050607101112131415161720212223242526273031323334353637"
+		u"4041424344454647505152535455565760616263646566677071727374757677";
+	// four binary digits per nibble, indexed by nibble * 4
+	static constexpr char16_t const sBinaryNibbles[] =
+		u"0000000100100011010001010110011110001001101010111100110111101111";
+};
+
+constexpr basic_string_view<char16_t> FormatTraits<char16_t>::sTrue;
+constexpr basic_string_view<char16_t> FormatTraits<char16_t>::sFalse;
+constexpr char16_t const FormatTraits<char16_t>::sDecimalPairs[];
+constexpr char16_t const FormatTraits<char16_t>::sHexadecimalLower[];
+constexpr char16_t const FormatTraits<char16_t>::sHexadecimalUpper[];
+constexpr char16_t const FormatTraits<char16_t>::sHexadecimalPairsLower[];
+constexpr char16_t const FormatTraits<char16_t>::sHexadecimalPairsUpper[];
+constexpr char16_t const FormatTraits<char16_t>::sOctalPairs[];
+constexpr char16_t const FormatTraits<char16_t>::sBinaryNibbles[];
+
+template <> struct FormatTraits<char32_t>
+{
+	static constexpr char32_t cFormatBegin = U'{';
+	static constexpr char32_t cFormatEnd = U'}';
+	static constexpr char32_t cFormatSep = U':';
+
+	static constexpr char32_t cPlus = U'+';
+	static constexpr char32_t cMinus = U'-';
+	static constexpr char32_t cSpace = U' ';
+	static constexpr char32_t cHash = U'#';
+	static constexpr char32_t cDot = U'.';
+
+	static constexpr char32_t to_digit(char32_t c) { return c + U'0'; }
+
+	static constexpr char32_t cPrintfSpec = U'%';
+	static constexpr char32_t cPrintfIndex = U'$';
+
+	static constexpr basic_string_view<char32_t> sTrue{U"true", 4};
+	static constexpr basic_string_view<char32_t> sFalse{U"false", 5};
+
+	static constexpr char32_t const sDecimalPairs[] =
+		U"00010203040506070809"
+		U"10111213141516171819"
+		U"20212223242526272829"
+		U"30313233343536373839"
+		U"40414243444546474849"
+		U"50515253545556575859"
+		U"60616263646566676869"
+		U"70717273747576777879"
+		U"80818283848586878889"
+		U"90919293949596979899";
+	static constexpr char32_t const sHexadecimalLower[] = U"0123456789abcdef";
+	static constexpr char32_t const sHexadecimalUpper[] = U"0123456789ABCDEF";
+
+	// two characters per byte value, indexed by byte * 2
+	static constexpr char32_t const sHexadecimalPairsLower[] =
+		U"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+		U"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+		U"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+		U"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+		U"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+		U"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+		U"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+		U"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+	static constexpr char32_t const sHexadecimalPairsUpper[] =
+		U"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		U"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+		U"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+		U"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+		U"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+		U"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+		U"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+		U"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+	// two octal digits per 6 bits, indexed by bits * 2
+	static constexpr char32_t const sOctalPairs[] =
+		U"0001020304050607101112131415161720212223242526273031323334353637"
+		U"4041424344454647505152535455565760616263646566677071727374757677";
+	// four binary digits per nibble, indexed by nibble * 4
+	static constexpr char32_t const sBinaryNibbles[] =
+		U"0000000100100011010001010110011110001001101010111100110111101111";
+};
+
+constexpr basic_string_view<char32_t> FormatTraits<char32_t>::sTrue;
+constexpr basic_string_view<char32_t> FormatTraits<char32_t>::sFalse;
+constexpr char32_t const FormatTraits<char32_t>::sDecimalPairs[];
+constexpr char32_t const FormatTraits<char32_t>::sHexadecimalLower[];
+constexpr char32_t const FormatTraits<char32_t>::sHexadecimalUpper[];
+constexpr char32_t const FormatTraits<char32_t>::sHexadecimalPairsLower[];
+constexpr char32_t const FormatTraits<char32_t>::sHexadecimalPairsUpper[];
+constexpr char32_t const FormatTraits<char32_t>::sOctalPairs[];
+constexpr char32_t const FormatTraits<char32_t>::sBinaryNibbles[];
+
+#if defined(__cpp_char8_t)
+template <> struct FormatTraits<char8_t>
+{
+	static constexpr char8_t cFormatBegin = u8'{';
+	static constexpr char8_t cFormatEnd = u8'}';
+	static constexpr char8_t cFormatSep = u8':';
+
+	static constexpr char8_t cPlus = u8'+';
+	static constexpr char8_t cMinus = u8'-';
+	static constexpr char8_t cSpace = u8' ';
+	static constexpr char8_t cHash = u8'#';
+	static constexpr char8_t cDot = u8'.';
+
+	static constexpr char8_t to_digit(char8_t c) { return c + u8'0'; }
+
+	static constexpr char8_t cPrintfSpec = u8'%';
+	static constexpr char8_t cPrintfIndex = u8'$';
+
+	static constexpr basic_string_view<char8_t> sTrue{u8"true", 4};
+	static constexpr basic_string_view<char8_t> sFalse{u8"false", 5};
+
+	static constexpr char8_t const sDecimalPairs[] =
+		u8"00010203040506070809"
+		u8"10111213141516171819"
+		u8"20212223242526272829"
+		u8"30313233343536373839"
+		u8"40414243444546474849"
+		u8"50515253545556575859"
+		u8"60616263646566676869"
+		u8"70717273747576777879"
+		u8"80818283848586878889"
+		u8"90919293949596979899";
+	static constexpr char8_t const sHexadecimalLower[] = u8"0123456789abcdef";
+	static constexpr char8_t const sHexadecimalUpper[] = u8"0123456789ABCDEF";
+
+	// two characters per byte value, indexed by byte * 2
+	static constexpr char8_t const sHexadecimalPairsLower[] =
+		u8"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+		u8"202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+		u8"404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+		u8"606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+		u8"808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+		u8"a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+		u8"c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+		u8"e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+	static constexpr char8_t const sHexadecimalPairsUpper[] =
+		u8"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+		u8"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+		u8"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+		u8"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+		u8"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+		u8"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+		u8"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+		u8"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+	// two octal digits per 6 bits, indexed by bits * 2
+	static constexpr char8_t const sOctalPairs[] =
+		u8"0001020304050607101112131415161720212223242526273031323334353637"
+		u8"4041424344454647505152535455565760616263646566677071727374757677";
+	// four binary digits per nibble, indexed by nibble * 4
+	static constexpr char8_t const sBinaryNibbles[] =
+		u8"0000000100100011010001010110011110001001101010111100110111101111";
+};
+
+constexpr basic_string_view<char8_t> FormatTraits<char8_t>::sTrue;
+constexpr basic_string_view<char8_t> FormatTraits<char8_t>::sFalse;
+constexpr char8_t const FormatTraits<char8_t>::sDecimalPairs[];
+constexpr char8_t const FormatTraits<char8_t>::sHexadecimalLower[];
+constexpr char8_t const FormatTraits<char8_t>::sHexadecimalUpper[];
+constexpr char8_t const FormatTraits<char8_t>::sHexadecimalPairsLower[];
+constexpr char8_t const FormatTraits<char8_t>::sHexadecimalPairsUpper[];
+constexpr char8_t const FormatTraits<char8_t>::sOctalPairs[];
+constexpr char8_t const FormatTraits<char8_t>::sBinaryNibbles[];
+#endif
 
 } // anonymous namespace
 } // namespace _detail
@@ -32,19 +32,52 @@
 #define _guard_FORMATXX_DETAIL_FORMAT_UTIL_H
 #pragma once
 
+#include <algorithm>
+
 namespace formatxx {
 namespace _detail {
 
 template <typename CharT>
 void write_padding(basic_format_writer<CharT>& out, CharT pad_char, std::size_t count)
 {
-    // FIXME: this is not even remotely the most efficient way to do this
-    for (std::size_t i = 0; i != count; ++i)
+    if (count != 0)
     {
-        out.write({&pad_char, 1});
+        out.put_fill(pad_char, count);
     }
 }
 
+/// Writes the sequence [padding][prefix][zeroes][body][padding], using a single
+/// reservation when the writer supports it.
+template <typename CharT>
+void write_padded_parts(basic_format_writer<CharT>& out, std::size_t left_padding, basic_string_view<CharT> prefix, std::size_t zeroes, basic_string_view<CharT> body, std::size_t right_padding)
+{
+    std::size_t const total = left_padding + prefix.size() + zeroes + body.size() + right_padding;
+    CharT const space = FormatTraits<CharT>::cSpace;
+    CharT const zero = FormatTraits<CharT>::to_digit(0);
+
+    CharT* const reserved = out.put_reserve(total);
+    if (reserved != nullptr)
+    {
+        CharT* ptr = reserved;
+        ptr = std::fill_n(ptr, left_padding, space);
+        ptr = std::copy_n(prefix.data(), prefix.size(), ptr);
+        ptr = std::fill_n(ptr, zeroes, zero);
+        ptr = std::copy_n(body.data(), body.size(), ptr);
+        std::fill_n(ptr, right_padding, space);
+        out.put_commit(reserved, total);
+        return;
+    }
+
+    write_padding(out, space, left_padding);
+    if (!prefix.empty())
+    {
+        out.put(prefix);
+    }
+    write_padding(out, zero, zeroes);
+    out.put(body);
+    write_padding(out, space, right_padding);
+}
+
 template <typename CharT>
 void write_padded_align_right(basic_format_writer<CharT>& out, basic_string_view<CharT> string, CharT pad_char, std::size_t count)
 {
@@ -53,13 +86,13 @@ void write_padded_align_right(basic_format_writer<CharT>& out, basic_string_view
         write_padding(out, pad_char, count - string.size());
     }
 
-    out.write(string);
+    out.put(string);
 }
 
 template <typename CharT>
 void write_padded_align_left(basic_format_writer<CharT>& out, basic_string_view<CharT> string, CharT pad_char, std::size_t count)
 {
-    out.write(string);
+    out.put(string);
 
     if (count > string.size())
     {
@@ -85,19 +118,6 @@ auto trim_string(basic_string_view<CharT> string, std::size_t max_size) -> basic
 {
     return string.size() < max_size ? string : basic_string_view<CharT>(string.data(), max_size);
 }
-
-template <typename CharT>
-bool string_contains(basic_string_view<CharT> haystack, CharT needle)
-{
-	for (CharT const c : haystack)
-	{
-		if (c == needle)
-		{
-			return true;
-		}
-	}
-	return false;
-}
       
 } // namespace _detail
 } // namespace formatxx
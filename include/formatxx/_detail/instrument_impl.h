@@ -0,0 +1,162 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_INSTRUMENT_IMPL_H)
+#define _guard_FORMATXX_DETAIL_INSTRUMENT_IMPL_H
+#pragma once
+
+#include "transcode.h"
+#include <atomic>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <intrin.h>
+#	define _FORMATXX_RDTSC 1
+#elif !defined(_MSC_VER) && (defined(__x86_64__) || defined(__i386__))
+#	include <x86intrin.h>
+#	define _FORMATXX_RDTSC 1
+#else
+#	include <chrono>
+#endif
+
+namespace formatxx {
+namespace _detail {
+
+enum instrument_flags : unsigned
+{
+	instrument_counts = 1,
+	instrument_ticks = 2,
+};
+
+/// One format string's counters in one thread's table.
+/// Only the owning thread writes the counters, so plain load-and-store keeps them cheap
+/// while snapshots on other threads still read whole values.
+struct instrument_entry
+{
+	static constexpr std::size_t text_capacity = 64;
+
+	std::atomic<void const*> site;
+	std::atomic<std::uint64_t> calls;
+	std::atomic<std::uint64_t> bytes;
+	std::atomic<std::uint64_t> writes;
+	std::atomic<std::uint64_t> out_of_range;
+	std::atomic<std::uint64_t> malformed;
+	std::atomic<std::uint64_t> ticks;
+	char text[text_capacity];
+	std::size_t text_size;
+
+	static void add(std::atomic<std::uint64_t>& counter, std::uint64_t amount) { counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed); }
+};
+
+/// The current instrument_flags; zero while instrumentation is disabled.
+unsigned instrument_mode();
+
+/// The calling thread's entry for site, or nullptr if it has none yet.
+instrument_entry* instrument_lookup(void const* site);
+
+/// Add an entry for site to the calling thread's table, or return its overflow entry if the table is full.
+instrument_entry* instrument_insert(void const* site, string_view text);
+
+inline std::uint64_t instrument_clock()
+{
+#if defined(_FORMATXX_RDTSC)
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// Forwards to another writer, counting the calls and characters.
+template <typename CharT>
+class instrument_writer : public basic_format_writer<CharT>
+{
+public:
+	explicit instrument_writer(basic_format_writer<CharT>& out) : _out(out) {}
+
+	void write(basic_string_view<CharT> str) override { ++writes; bytes += str.size(); _out.write(str); }
+	void write_stable(basic_string_view<CharT> str) override { ++writes; bytes += str.size(); _out.write_stable(str); }
+	void write_fill(CharT ch, std::size_t count) override { ++writes; bytes += count; _out.write_fill(ch, count); }
+	CharT* reserve(std::size_t count) override { return _out.reserve(count); }
+	void commit(std::size_t count) override { ++writes; bytes += count; _out.commit(count); }
+
+	std::uint64_t writes = 0;
+	std::uint64_t bytes = 0;
+
+private:
+	basic_format_writer<CharT>& _out;
+};
+
+template <typename CharT>
+string_view instrument_text(basic_string_view<CharT> format, char (&buffer)[instrument_entry::text_capacity])
+{
+	CharT const* iter = format.data();
+	return {buffer, transcode_chunk(iter, format.data() + format.size(), buffer, sizeof(buffer))};
+}
+
+inline string_view instrument_text(string_view format, char (&)[instrument_entry::text_capacity])
+{
+	return {format.data(), format.size() < instrument_entry::text_capacity ? format.size() : instrument_entry::text_capacity};
+}
+
+/// Runs a format call through an instrument_writer and records it against the format string.
+template <typename CharT, typename FunctionT>
+result_code instrument_call(unsigned mode, basic_format_writer<CharT>& out, basic_string_view<CharT> format, FunctionT const& function)
+{
+	instrument_writer<CharT> writer(out);
+	std::uint64_t const start = (mode & instrument_ticks) != 0 ? instrument_clock() : 0;
+	result_code const result = function(static_cast<basic_format_writer<CharT>&>(writer));
+	std::uint64_t const elapsed = (mode & instrument_ticks) != 0 ? instrument_clock() - start : 0;
+
+	instrument_entry* entry = instrument_lookup(format.data());
+	if (entry == nullptr)
+	{
+		char buffer[instrument_entry::text_capacity];
+		entry = instrument_insert(format.data(), instrument_text(format, buffer));
+	}
+
+	instrument_entry::add(entry->calls, 1);
+	instrument_entry::add(entry->bytes, writer.bytes * sizeof(CharT));
+	instrument_entry::add(entry->writes, writer.writes);
+	instrument_entry::add(entry->ticks, elapsed);
+	if (result == result_code::out_of_range)
+	{
+		instrument_entry::add(entry->out_of_range, 1);
+	}
+	else if (result == result_code::malformed_input)
+	{
+		instrument_entry::add(entry->malformed, 1);
+	}
+	return result;
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_INSTRUMENT_IMPL_H
@@ -34,14 +34,67 @@
 
 #include "parse_unsigned.h"
 #include "format_util.h"
+#include <type_traits>
 
 namespace formatxx {
+namespace _detail {
 
+enum spec_class : unsigned short
+{
+	spec_plus = 1,
+	spec_minus = 2,
+	spec_zero = 4,
+	spec_space = 8,
+	spec_hash = 16,
+	spec_group = 32,
+	spec_flag = spec_plus | spec_minus | spec_zero | spec_space | spec_hash | spec_group,
+	spec_digit = 64,
+	spec_modifier = 128,
+	spec_code = 256,
+	spec_separator = 512,
+};
+
+/// The spec_class bits of each byte value; everything outside ASCII is zero.
+template <typename T = void>
+struct spec_classes
+{
+	static constexpr unsigned short table[256] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		spec_space, 0, 0, spec_hash, 0, 0, 0, spec_group, 0, 0, 0, spec_plus, spec_separator, spec_minus, 0, 0,
+		spec_zero | spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, spec_digit, 0, 0, 0, 0, 0, 0,
+		0, spec_code, 0, spec_code, 0, spec_code, spec_code, spec_code, 0, 0, 0, 0, spec_modifier, 0, 0, 0,
+		0, 0, 0, spec_code, 0, 0, 0, 0, spec_code, 0, 0, 0, 0, 0, 0, spec_separator,
+		0, spec_code, spec_code, spec_code, spec_code, spec_code, spec_code, spec_code, spec_modifier, spec_code, spec_modifier, 0, spec_modifier, 0, 0, spec_code,
+		spec_code, 0, 0, spec_code, spec_modifier, spec_code, 0, 0, spec_code, 0, spec_modifier, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	};
+};
+
+template <typename T>
+constexpr unsigned short spec_classes<T>::table[256];
+
+/// The spec_class bits of a code unit; wider units beyond the table have none.
 template <typename CharT>
-FORMATXX_PUBLIC basic_format_spec<CharT> FORMATXX_API parse_format_spec(basic_string_view<CharT> spec)
+unsigned classify_spec_char(CharT ch)
 {
-	using Traits = _detail::FormatTraits<CharT>;
+	using unsigned_type = typename std::make_unsigned<CharT>::type;
+	unsigned_type const unit = static_cast<unsigned_type>(ch);
+	return sizeof(CharT) == 1 || unit < 256 ? spec_classes<>::table[unit & 0xFF] : 0;
+}
 
+} // namespace _detail
+
+template <typename CharT>
+FORMATXX_PUBLIC basic_format_spec<CharT> FORMATXX_API parse_format_spec(basic_string_view<CharT> spec)
+{
 	basic_format_spec<CharT> result;
 
 	result.remaining = spec.data();
@@ -49,53 +102,50 @@ FORMATXX_PUBLIC basic_format_spec<CharT> FORMATXX_API parse_format_spec(basic_st
 	CharT const* const end = spec.data() + spec.size();
 
 	// flags
-	while (start != end)
+	unsigned flags = 0;
+	unsigned current = 0;
+	while (start != end && ((current = _detail::classify_spec_char(*start)) & _detail::spec_flag) != 0)
 	{
-		if (*start == Traits::cPlus)
-		{
-			result.prepend_sign = true;
-		}
-		else if(*start == Traits::cMinus)
-		{
-			result.left_justify = true;
-		}
-		else if (*start == Traits::to_digit(0))
-		{
-			result.leading_zeroes = true;
-		}
-		else if (*start == Traits::cSpace)
-		{
-			result.prepend_space = true;
-		}
-		else if (*start == Traits::cHash)
-		{
-			result.alternate_form = true;
-		}
-		else
-		{
-			break;
-		}
+		flags |= current;
 		++start;
 	}
+	result.prepend_sign = (flags & _detail::spec_plus) != 0;
+	result.left_justify = (flags & _detail::spec_minus) != 0;
+	result.leading_zeroes = (flags & _detail::spec_zero) != 0;
+	result.prepend_space = (flags & _detail::spec_space) != 0;
+	result.alternate_form = (flags & _detail::spec_hash) != 0;
+	if ((flags & _detail::spec_group) != 0)
+	{
+		result.grouping = static_cast<CharT>(',');
+	}
 
 	// read in width
-	start = _detail::parse_unsigned(start, end, result.width);
+	if ((current & _detail::spec_digit) != 0)
+	{
+		start = _detail::parse_unsigned(start, end, result.width);
+	}
+
+	// a digit group separator may follow the width, as in Python's {:10,}
+	if (start != end && (_detail::classify_spec_char(*start) & _detail::spec_separator) != 0)
+	{
+		result.grouping = *start++;
+	}
 
 	// read in precision, if present
-	if (start != end && *start == Traits::cDot)
+	if (start != end && *start == _detail::FormatTraits<CharT>::cDot)
 	{
 		result.has_precision = true;
 		start = _detail::parse_unsigned(start + 1, end, result.precision);
 	}
 
 	// read in any of the modifiers like h or l that modify a type code (no effect in our system)
-	while (start != end && _detail::string_contains(Traits::sPrintfModifiers, *start))
+	while (start != end && (_detail::classify_spec_char(*start) & _detail::spec_modifier) != 0)
 	{
 		++start;
 	}
 
 	// generic code specified option allowed (required for printf)
-	if (start != end && _detail::string_contains(Traits::sPrintfSpecifiers, *start))
+	if (start != end && (_detail::classify_spec_char(*start) & _detail::spec_code) != 0)
 	{
 		result.code = *start++;
 	}
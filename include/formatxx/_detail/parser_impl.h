@@ -0,0 +1,200 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+
+#if !defined(_guard_FORMATXX_DETAIL_PARSER_IMPL_H)
+#define _guard_FORMATXX_DETAIL_PARSER_IMPL_H
+#pragma once
+
+#include "find_char.h"
+
+namespace formatxx {
+namespace _detail {
+
+/// Appends directive text to the carried-over state, failing if it will not fit.
+template <typename CharT>
+bool buffer_directive(parser_state<CharT>& state, CharT const* text, std::size_t length)
+{
+	if (length > parser_state<CharT>::capacity - state.size)
+	{
+		return false;
+	}
+	std::char_traits<CharT>::copy(state.text + state.size, text, length);
+	state.size += length;
+	return true;
+}
+
+/// Formats the argument of a completed directive.
+template <typename CharT>
+result_code finish_directive(basic_format_writer<CharT>& out, basic_format_args<CharT> const& args, parser_state<CharT>& state, basic_string_view<CharT> spec)
+{
+	unsigned const index = state.has_index ? state.index : state.next_index;
+	state.next_index = index + 1;
+	state.state = parser_state<CharT>::mode::literal;
+	return args.format_arg(out, index, spec, nullptr);
+}
+
+/// Formats one chunk of a streamed {}-style format string, as parse_format does for a whole string.
+/// Literal text is written straight through, and a directive within the chunk is formatted in place;
+/// only a directive that is cut off by the end of the chunk is carried over in state.
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API parse_format_chunk(basic_format_writer<CharT>& out, basic_format_args<CharT> const& args, parser_state<CharT>& state, basic_string_view<CharT> chunk)
+{
+	using mode = typename parser_state<CharT>::mode;
+
+	result_code result = result_code::success;
+
+	CharT const* iter = chunk.data();
+	CharT const* const end = iter + chunk.size();
+
+	// the current directive's text in this chunk; anything before it is in state.text
+	CharT const* directive = iter;
+
+	while (iter != end)
+	{
+		switch (state.state)
+		{
+		case mode::literal:
+		{
+			CharT const* const brace = find_char(iter, end, FormatTraits<CharT>::cFormatBegin);
+			if (brace != iter)
+			{
+				out.put({iter, brace});
+			}
+			iter = brace;
+			if (brace != end)
+			{
+				state.state = mode::brace;
+				state.size = 0;
+				directive = ++iter;
+			}
+			break;
+		}
+		case mode::brace:
+			// {{ is an escaped {, which begins the next literal
+			if (*iter == FormatTraits<CharT>::cFormatBegin)
+			{
+				out.put({iter, 1});
+				state.state = mode::literal;
+				++iter;
+				break;
+			}
+			state.state = mode::index;
+			state.has_index = false;
+			state.index = 0;
+			break;
+		case mode::index:
+			if (*iter == FormatTraits<CharT>::cFormatEnd)
+			{
+				result_code const arg_result = finish_directive(out, args, state, {});
+				if (arg_result != result_code::success)
+				{
+					result = arg_result;
+				}
+				++iter;
+			}
+			else if (*iter == FormatTraits<CharT>::cFormatSep)
+			{
+				++iter;
+				state.state = mode::spec;
+				state.spec_begin = state.size + static_cast<std::size_t>(iter - directive);
+			}
+			else if (*iter >= CharT('0') && *iter <= CharT('9'))
+			{
+				state.index = state.index * 10 + static_cast<unsigned>(*iter - CharT('0'));
+				state.has_index = true;
+				++iter;
+			}
+			else
+			{
+				// something besides a number; it starts the next literal
+				result = result_code::malformed_input;
+				state.state = mode::literal;
+			}
+			break;
+		case mode::spec:
+		{
+			CharT const* const close = find_char(iter, end, FormatTraits<CharT>::cFormatEnd);
+			iter = close;
+			if (close == end)
+			{
+				break;
+			}
+			++iter;
+
+			basic_string_view<CharT> spec;
+			if (state.size == 0)
+			{
+				// the whole directive is in this chunk
+				spec = {directive + state.spec_begin, close};
+			}
+			else if (buffer_directive(state, directive, static_cast<std::size_t>(close - directive)))
+			{
+				spec = {state.text + state.spec_begin, state.size - state.spec_begin};
+			}
+			else
+			{
+				result = result_code::malformed_input;
+				state.state = mode::literal;
+				break;
+			}
+
+			result_code const arg_result = finish_directive(out, args, state, spec);
+			if (arg_result != result_code::success)
+			{
+				result = arg_result;
+			}
+			break;
+		}
+		case mode::skip:
+			iter = find_char(iter, end, FormatTraits<CharT>::cFormatEnd);
+			if (iter != end)
+			{
+				state.state = mode::literal;
+				++iter;
+			}
+			break;
+		}
+	}
+
+	// carry over the part of a directive that the chunk cut off
+	if ((state.state == mode::index || state.state == mode::spec) && !buffer_directive(state, directive, static_cast<std::size_t>(end - directive)))
+	{
+		result = result_code::malformed_input;
+		state.state = mode::skip;
+	}
+
+	return result;
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_PARSER_IMPL_H
@@ -32,11 +32,15 @@
 #define _guard_FORMATXX_DETAIL_PRINTF_IMPL_H
 #pragma once
 
+#include "format_impl.h"
+
 namespace formatxx {
 namespace _detail {
 
-template <typename CharT>
-FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>& out, basic_string_view<CharT> format, basic_format_args<CharT> args)
+/// Parses a printf-style format string, handing each literal span and argument reference to a receiver.
+/// The receiver interface is the same as for parse_format.
+template <typename CharT, typename ReceiverT>
+result_code parse_printf(basic_string_view<CharT> format, ReceiverT& receiver)
 {
 	unsigned next_index = 0;
 	result_code result = result_code::success;
@@ -47,16 +51,15 @@ FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>&
 
 	while (iter < end)
 	{
-		if (*iter != FormatTraits<CharT>::cPrintfSpec)
-		{
-			++iter;
-		}
-		else
+		// skip the entire literal span up to the next directive
+		iter = find_char(iter, end, FormatTraits<CharT>::cPrintfSpec);
+		if (iter != end)
 		{
 			// write out the string so far, since we don't write characters immediately
 			if (iter > begin)
 			{
-				out.write({begin, iter});
+				receiver.literal({begin, iter});
+				begin = iter;
 			}
 
 			++iter; // swallow the %
@@ -77,6 +80,7 @@ FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>&
 			}
 
 			basic_string_view<CharT> spec_string;
+			basic_format_spec<CharT> spec;
 
 			// determine which argument we're going to format (optional in printf syntax)
 			unsigned index = 0;
@@ -128,7 +132,7 @@ FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>&
 				// parse forward through the specification and verify that it's correct and will
 				// properly decode in parse_format_spec later.
 				CharT const* const spec_begin = iter;
-				basic_format_spec<CharT> const spec = parse_format_spec(basic_string_view<CharT>(iter, end));
+				spec = parse_format_spec(basic_string_view<CharT>(iter, end));
 				spec_string = {spec_begin, spec.remaining};
 				if (spec.code == CharT(0))
 				{
@@ -141,7 +145,8 @@ FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>&
 				begin = iter = spec.remaining;
 			}
 
-			result_code const arg_result = args.format_arg(out, index, spec_string);
+			// a bare positional reference has no spec; otherwise pass along the spec we already parsed
+			result_code const arg_result = receiver.argument(index, spec_string, spec.code != CharT(0) ? &spec : nullptr);
 			if (arg_result != result_code::success)
 			{
 				result = arg_result;
@@ -155,12 +160,30 @@ FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>&
 	// write out tail end of format string
 	if (iter > begin)
 	{
-		out.write({begin, iter});
+		receiver.literal({begin, iter});
 	}
 
 	return result;
 }
 
+template <typename CharT>
+FORMATXX_PUBLIC result_code FORMATXX_API printf_impl(basic_format_writer<CharT>& out, basic_string_view<CharT> format, basic_format_args<CharT> args)
+{
+#if defined(FORMATXX_INSTRUMENT)
+	if (unsigned const mode = instrument_mode())
+	{
+		return instrument_call(mode, out, format, [&](basic_format_writer<CharT>& writer)
+		{
+			format_receiver<CharT> receiver(writer, args);
+			return parse_printf(format, receiver);
+		});
+	}
+#endif
+
+	format_receiver<CharT> receiver(out, args);
+	return parse_printf(format, receiver);
+}
+
 } // namespace _detail
 } // namespace formatxx
 
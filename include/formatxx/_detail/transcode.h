@@ -0,0 +1,415 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_TRANSCODE_H)
+#define _guard_FORMATXX_DETAIL_TRANSCODE_H
+#pragma once
+
+#include "format_util.h"
+#include "bit_util.h"
+
+namespace formatxx {
+namespace _detail {
+
+/// Substituted for invalid or unpaired input.
+constexpr char32_t replacement_code_point = 0xFFFD;
+
+/// Unicode encoding by code unit size: UTF-8, UTF-16 or UTF-32.
+template <std::size_t Width> struct utf;
+
+template <> struct utf<1>
+{
+	static constexpr std::size_t max_units = 4;
+
+	template <typename CharT>
+	static char32_t decode(CharT const*& iter, CharT const* end)
+	{
+		unsigned const lead = static_cast<unsigned char>(*iter++);
+		if (lead < 0x80)
+		{
+			return lead;
+		}
+
+		unsigned extra;
+		char32_t code_point;
+		char32_t minimum;
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			extra = 1;
+			code_point = lead & 0x1F;
+			minimum = 0x80;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			extra = 2;
+			code_point = lead & 0x0F;
+			minimum = 0x800;
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			extra = 3;
+			code_point = lead & 0x07;
+			minimum = 0x10000;
+		}
+		else
+		{
+			return replacement_code_point;
+		}
+
+		for (; extra != 0; --extra)
+		{
+			if (iter == end || (static_cast<unsigned char>(*iter) & 0xC0) != 0x80)
+			{
+				return replacement_code_point;
+			}
+			code_point = (code_point << 6) | (static_cast<unsigned char>(*iter++) & 0x3F);
+		}
+
+		if (code_point < minimum || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF))
+		{
+			return replacement_code_point;
+		}
+		return code_point;
+	}
+
+	template <typename CharT>
+	static std::size_t encode(char32_t code_point, CharT* dest)
+	{
+		if (code_point < 0x80)
+		{
+			dest[0] = static_cast<CharT>(code_point);
+			return 1;
+		}
+		if (code_point < 0x800)
+		{
+			dest[0] = static_cast<CharT>(0xC0 | (code_point >> 6));
+			dest[1] = static_cast<CharT>(0x80 | (code_point & 0x3F));
+			return 2;
+		}
+		if (code_point < 0x10000)
+		{
+			dest[0] = static_cast<CharT>(0xE0 | (code_point >> 12));
+			dest[1] = static_cast<CharT>(0x80 | ((code_point >> 6) & 0x3F));
+			dest[2] = static_cast<CharT>(0x80 | (code_point & 0x3F));
+			return 3;
+		}
+		dest[0] = static_cast<CharT>(0xF0 | (code_point >> 18));
+		dest[1] = static_cast<CharT>(0x80 | ((code_point >> 12) & 0x3F));
+		dest[2] = static_cast<CharT>(0x80 | ((code_point >> 6) & 0x3F));
+		dest[3] = static_cast<CharT>(0x80 | (code_point & 0x3F));
+		return 4;
+	}
+};
+
+template <> struct utf<2>
+{
+	static constexpr std::size_t max_units = 2;
+
+	template <typename CharT>
+	static char32_t decode(CharT const*& iter, CharT const* end)
+	{
+		char32_t const unit = static_cast<std::uint16_t>(*iter++);
+		if (unit < 0xD800 || unit > 0xDFFF)
+		{
+			return unit;
+		}
+		if (unit > 0xDBFF || iter == end)
+		{
+			return replacement_code_point;
+		}
+
+		char32_t const low = static_cast<std::uint16_t>(*iter);
+		if (low < 0xDC00 || low > 0xDFFF)
+		{
+			return replacement_code_point;
+		}
+		++iter;
+		return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+	}
+
+	template <typename CharT>
+	static std::size_t encode(char32_t code_point, CharT* dest)
+	{
+		if (code_point < 0x10000)
+		{
+			dest[0] = static_cast<CharT>(code_point);
+			return 1;
+		}
+		dest[0] = static_cast<CharT>(0xD800 + ((code_point - 0x10000) >> 10));
+		dest[1] = static_cast<CharT>(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+		return 2;
+	}
+};
+
+template <> struct utf<4>
+{
+	static constexpr std::size_t max_units = 1;
+
+	template <typename CharT>
+	static char32_t decode(CharT const*& iter, CharT const*)
+	{
+		char32_t const unit = static_cast<std::uint32_t>(*iter++);
+		return unit > 0x10FFFF || (unit >= 0xD800 && unit <= 0xDFFF) ? replacement_code_point : unit;
+	}
+
+	template <typename CharT>
+	static std::size_t encode(char32_t code_point, CharT* dest)
+	{
+		dest[0] = static_cast<CharT>(code_point);
+		return 1;
+	}
+};
+
+/// The number of code units converted at once by the ASCII fast path.
+constexpr std::size_t ascii_block_size = 16;
+
+#if defined(_FORMATXX_SSE2)
+
+/// Loads 16 code units as bytes, failing if any of them is not ASCII.
+template <std::size_t Width> struct sse2_ascii;
+
+template <> struct sse2_ascii<1>
+{
+	template <typename CharT>
+	static bool load(CharT const* src, __m128i& bytes)
+	{
+		bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+		return _mm_movemask_epi8(bytes) == 0;
+	}
+
+	template <typename CharT>
+	static void store(CharT* dest, __m128i bytes) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), bytes); }
+};
+
+template <> struct sse2_ascii<2>
+{
+	template <typename CharT>
+	static bool load(CharT const* src, __m128i& bytes)
+	{
+		__m128i const first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+		__m128i const second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 8));
+		__m128i const high = _mm_and_si128(_mm_or_si128(first, second), _mm_set1_epi16(static_cast<short>(0xFF80)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF)
+		{
+			return false;
+		}
+		bytes = _mm_packus_epi16(first, second);
+		return true;
+	}
+
+	template <typename CharT>
+	static void store(CharT* dest, __m128i bytes)
+	{
+		__m128i const zero = _mm_setzero_si128();
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi8(bytes, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), _mm_unpackhi_epi8(bytes, zero));
+	}
+};
+
+template <> struct sse2_ascii<4>
+{
+	template <typename CharT>
+	static bool load(CharT const* src, __m128i& bytes)
+	{
+		__m128i const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+		__m128i const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4));
+		__m128i const c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 8));
+		__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 12));
+		__m128i const all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+		__m128i const high = _mm_and_si128(all, _mm_set1_epi32(~0x7F));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF)
+		{
+			return false;
+		}
+		bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		return true;
+	}
+
+	template <typename CharT>
+	static void store(CharT* dest, __m128i bytes)
+	{
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const low = _mm_unpacklo_epi8(bytes, zero);
+		__m128i const high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4), _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 12), _mm_unpackhi_epi16(high, zero));
+	}
+};
+
+#endif
+
+/// Copies a block of ascii_block_size code units if they are all ASCII, which is the same in every encoding.
+/// @returns false, without writing, if any unit is not ASCII.
+template <typename ToCharT, typename FromCharT>
+bool copy_ascii_block(ToCharT* dest, FromCharT const* src)
+{
+#if defined(_FORMATXX_SSE2)
+	__m128i bytes;
+	if (!sse2_ascii<sizeof(FromCharT)>::load(src, bytes))
+	{
+		return false;
+	}
+	sse2_ascii<sizeof(ToCharT)>::store(dest, bytes);
+	return true;
+#else
+	std::uint32_t bits = 0;
+	for (std::size_t i = 0; i != ascii_block_size; ++i)
+	{
+		bits |= static_cast<std::uint32_t>(src[i]);
+	}
+	if (bits >= 0x80)
+	{
+		return false;
+	}
+	for (std::size_t i = 0; i != ascii_block_size; ++i)
+	{
+		dest[i] = static_cast<ToCharT>(src[i]);
+	}
+	return true;
+#endif
+}
+
+/// Converts whole code points from [iter, end) into dest for as long as they fit in capacity.
+/// @returns the number of code units written; iter is left at the first code point not converted.
+template <typename ToCharT, typename FromCharT>
+std::size_t transcode_chunk(FromCharT const*& iter, FromCharT const* end, ToCharT* dest, std::size_t capacity)
+{
+	using from_utf = utf<sizeof(FromCharT)>;
+	using to_utf = utf<sizeof(ToCharT)>;
+
+	std::size_t written = 0;
+	while (iter != end)
+	{
+		if (static_cast<std::size_t>(end - iter) >= ascii_block_size && capacity - written >= ascii_block_size && copy_ascii_block(dest + written, iter))
+		{
+			iter += ascii_block_size;
+			written += ascii_block_size;
+			continue;
+		}
+
+		// after a block with non-ASCII text, convert the next block's worth one code point at a time
+		FromCharT const* const scalar_end = static_cast<std::size_t>(end - iter) > ascii_block_size ? iter + ascii_block_size : end;
+		while (iter < scalar_end)
+		{
+			FromCharT const* const start = iter;
+			ToCharT units[to_utf::max_units];
+			std::size_t const count = to_utf::encode(from_utf::decode(iter, end), units);
+			if (count > capacity - written)
+			{
+				iter = start;
+				return written;
+			}
+			std::copy_n(units, count, dest + written);
+			written += count;
+		}
+	}
+	return written;
+}
+
+/// The number of ToCharT code units that str converts to, stopping before any code point that would pass limit.
+template <typename ToCharT, typename FromCharT>
+std::size_t transcoded_size(basic_string_view<FromCharT> str, std::size_t limit)
+{
+	using from_utf = utf<sizeof(FromCharT)>;
+	using to_utf = utf<sizeof(ToCharT)>;
+
+	std::size_t size = 0;
+	FromCharT const* iter = str.data();
+	FromCharT const* const end = iter + str.size();
+	while (iter != end)
+	{
+		std::size_t units = 1;
+		if (static_cast<std::uint32_t>(*iter) < 0x80)
+		{
+			++iter;
+		}
+		else
+		{
+			ToCharT encoded[to_utf::max_units];
+			units = to_utf::encode(from_utf::decode(iter, end), encoded);
+		}
+
+		if (units > limit - size)
+		{
+			break;
+		}
+		size += units;
+	}
+	return size;
+}
+
+/// Writes a string in another encoding, converting it in blocks with the spec's width and precision
+/// counted in output code units.
+template <typename ToCharT, typename FromCharT>
+void write_transcoded(basic_format_writer<ToCharT>& out, basic_string_view<FromCharT> str, basic_format_spec<ToCharT> const& spec)
+{
+	constexpr std::size_t chunk_size = 256;
+	std::size_t const limit = spec.has_precision ? spec.precision : static_cast<std::size_t>(-1);
+
+	std::size_t padding = 0;
+	if (spec.width != 0)
+	{
+		std::size_t const size = transcoded_size<ToCharT>(str, limit);
+		padding = spec.width > size ? spec.width - size : 0;
+	}
+
+	ToCharT const space = FormatTraits<ToCharT>::cSpace;
+	if (!spec.left_justify)
+	{
+		write_padding(out, space, padding);
+	}
+
+	ToCharT chunk[chunk_size];
+	FromCharT const* iter = str.data();
+	FromCharT const* const end = iter + str.size();
+	std::size_t remaining = limit;
+	while (iter != end && remaining != 0)
+	{
+		std::size_t const count = transcode_chunk(iter, end, chunk, remaining < chunk_size ? remaining : chunk_size);
+		if (count == 0)
+		{
+			break;
+		}
+		out.put({chunk, count});
+		remaining -= count;
+	}
+
+	if (spec.left_justify)
+	{
+		write_padding(out, space, padding);
+	}
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_TRANSCODE_H
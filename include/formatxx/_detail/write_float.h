@@ -32,89 +32,363 @@
 #define _guard_FORMATXX_DETAIL_WRITE_FLOAT_H
 #pragma once
 
+#include "format_util.h"
+#include "float_digits.h"
+
 namespace formatxx {
 namespace _detail {
 
-inline int float_helper(char* buf, int result, char const* fmt, int width, int precision, double value)
+/// Upper bound on the honored precision; larger requests are clamped.
+constexpr int float_max_precision = 1100;
+
+/// Digits for the worst case of a fully expanded double at maximum precision.
+constexpr int float_max_digits = exact_digits::max_integer_digits + float_max_precision + 2;
+
+// integer part (310), its group separators (103), decimal point (1), precision (1100), exponent (5)
+constexpr std::size_t float_buffer_size = float_max_digits + exact_digits::max_integer_digits / 3 + 8;
+
+template <typename CharT>
+CharT* write_float_fixed(CharT* ptr, char const* digits, int count, int point, int fraction, bool alternate, CharT separator)
+{
+	CharT const zero = FormatTraits<CharT>::to_digit(0);
+
+	if (point <= 0)
+	{
+		*ptr++ = zero;
+	}
+	for (int i = 0; i < point; ++i)
+	{
+		// a separator before each group of three integer digits but the first
+		if (separator != 0 && i != 0 && (point - i) % 3 == 0)
+		{
+			*ptr++ = separator;
+		}
+		*ptr++ = i < count ? FormatTraits<CharT>::to_digit(digits[i]) : zero;
+	}
+
+	if (fraction > 0 || alternate)
+	{
+		*ptr++ = FormatTraits<CharT>::cDot;
+	}
+	for (int i = 0; i < fraction; ++i)
+	{
+		int const index = point + i;
+		*ptr++ = index >= 0 && index < count ? FormatTraits<CharT>::to_digit(digits[index]) : zero;
+	}
+
+	return ptr;
+}
+
+template <typename CharT>
+CharT* write_float_exponent(CharT* ptr, char const* digits, int count, int exponent, int fraction, bool alternate, bool upper)
+{
+	CharT const zero = FormatTraits<CharT>::to_digit(0);
+
+	*ptr++ = count != 0 ? FormatTraits<CharT>::to_digit(digits[0]) : zero;
+	if (fraction > 0 || alternate)
+	{
+		*ptr++ = FormatTraits<CharT>::cDot;
+	}
+	for (int i = 1; i <= fraction; ++i)
+	{
+		*ptr++ = i < count ? FormatTraits<CharT>::to_digit(digits[i]) : zero;
+	}
+
+	*ptr++ = static_cast<CharT>(upper ? 'E' : 'e');
+	*ptr++ = exponent < 0 ? FormatTraits<CharT>::cMinus : FormatTraits<CharT>::cPlus;
+
+	// at least two exponent digits, as printf does
+	unsigned const magnitude = exponent < 0 ? 0U - static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+	if (magnitude >= 100)
+	{
+		*ptr++ = FormatTraits<CharT>::to_digit(static_cast<char>(magnitude / 100));
+	}
+	*ptr++ = FormatTraits<CharT>::sDecimalPairs[(magnitude % 100) * 2];
+	*ptr++ = FormatTraits<CharT>::sDecimalPairs[(magnitude % 100) * 2 + 1];
+
+	return ptr;
+}
+
+/// Generates the first significant digits of the exact value, rounded to nearest-even.
+inline int float_significant_digits(float_parts const& parts, int significant, char* digits, int& exponent)
 {
-	return std::snprintf(buf, result, fmt, width, precision, value);
+	exponent = 0;
+	if (parts.mantissa == 0)
+	{
+		return 0;
+	}
+
+	exact_digits source(parts.mantissa, parts.exponent);
+	exponent = source.integer_size() != 0 ? source.integer_size() - 1 : -1 - source.skip_zeroes();
+
+	for (int i = 0; i != significant; ++i)
+	{
+		digits[i] = static_cast<char>(source.next());
+	}
+
+	int const next = source.next();
+	if (round_digits(digits, significant, next, source.remaining_zero()))
+	{
+		++exponent;
+	}
+	return significant;
+}
+
+/// Generates the integer part and the given number of fraction digits, rounded to nearest-even.
+inline int float_fixed_digits(float_parts const& parts, int precision, char* digits, int& point)
+{
+	point = 0;
+	if (parts.mantissa == 0)
+	{
+		return 0;
+	}
+
+	exact_digits source(parts.mantissa, parts.exponent);
+	point = source.integer_size();
+
+	int count = 0;
+	for (int const end = point + precision; count != end; ++count)
+	{
+		digits[count] = static_cast<char>(source.next());
+	}
+
+	int const next = source.next();
+	if (round_digits(digits, count, next, source.remaining_zero()))
+	{
+		// carried out of the leading digit, so the value gained one integer digit
+		digits[count] = count == 0 ? 1 : 0;
+		++count;
+		++point;
+	}
+	return count;
 }
 
-inline int float_helper(wchar_t* buf, int result, wchar_t const* fmt, int width, int precision, double value)
+template <typename CharT, typename FloatT>
+CharT* write_float_shortest(CharT* ptr, FloatT value, bool alternate, CharT separator)
 {
-	return std::swprintf(buf, result, fmt, width, precision, value);
+	float_parts const parts = decompose_float(value);
+	if (parts.mantissa == 0)
+	{
+		return write_float_fixed(ptr, nullptr, 0, 1, 0, alternate, separator);
+	}
+
+	char digits[20];
+	int decimal_exponent = 0;
+	int const count = shortest_digits<FloatT>(parts, digits, decimal_exponent);
+	int const exponent = count + decimal_exponent - 1;
+
+	// plain notation for "human" magnitudes, scientific otherwise
+	if (exponent >= -4 && exponent < 16)
+	{
+		int const fraction = count - 1 - exponent;
+		return write_float_fixed(ptr, digits, count, exponent + 1, fraction > 0 ? fraction : 0, alternate, separator);
+	}
+	return write_float_exponent(ptr, digits, count, exponent, count - 1, alternate, false);
 }
 
 template <typename CharT>
-void write_float(basic_format_writer<CharT>& out, double value, basic_string_view<CharT> spec_string)
+CharT* write_float_general(CharT* ptr, float_parts const& parts, int precision, bool alternate, bool upper, CharT separator)
 {
-	auto const spec = parse_format_spec(spec_string);
+	char digits[float_max_digits];
+	int const significant = precision != 0 ? precision : 1;
+	int exponent = 0;
+	int count = float_significant_digits(parts, significant, digits, exponent);
 
-	constexpr std::size_t fmt_buf_size = 10;
-	CharT fmt_buf[fmt_buf_size];
-	CharT* fmt_ptr = fmt_buf + fmt_buf_size;
+	if (!alternate)
+	{
+		while (count != 0 && digits[count - 1] == 0)
+		{
+			--count;
+		}
+	}
 
-	// required NUL terminator for sprintf formats (1)
-	*--fmt_ptr = 0;
+	if (exponent >= -4 && exponent < significant)
+	{
+		int const trimmed = count - 1 - exponent;
+		int const fraction = alternate ? significant - 1 - exponent : (trimmed > 0 ? trimmed : 0);
+		return write_float_fixed(ptr, digits, count, exponent + 1, fraction, alternate, separator);
+	}
+
+	int const fraction = alternate ? significant - 1 : (count > 1 ? count - 1 : 0);
+	return write_float_exponent(ptr, digits, count, exponent, fraction, alternate, upper);
+}
+
+template <typename CharT>
+CharT* write_float_hex(CharT* ptr, float_parts const& parts, basic_format_spec<CharT> const& spec, bool upper)
+{
+	constexpr int mantissa_nibbles = 13;
+	constexpr std::uint64_t fraction_mask = (std::uint64_t(1) << (4 * mantissa_nibbles)) - 1;
 
-	// every sprint call must have a valid code (1)
-	switch (spec.code)
+	CharT const* const alphabet = upper ? FormatTraits<CharT>::sHexadecimalUpper : FormatTraits<CharT>::sHexadecimalLower;
+
+	unsigned lead = 0;
+	std::uint64_t fraction = 0;
+	int exponent = 0;
+	if (parts.mantissa != 0)
 	{
-	case 'a':
-	case 'A':
-	case 'e':
-	case 'E':
-	case 'f':
-	case 'F':
-	case 'g':
-	case 'G':
-		*--fmt_ptr = spec.code;
-		break;
-	default:
-		*--fmt_ptr = 'f';
-		break;
+		lead = parts.normal ? 1 : 0;
+		fraction = parts.mantissa & fraction_mask;
+		exponent = parts.exponent + 4 * mantissa_nibbles;
 	}
 
-	// we always pass in a width and precision, defaulting to 0 which has no effect
-	// as width, and -1 which is a guaranteed "ignore" (3)
-	*--fmt_ptr = '*';
-	*--fmt_ptr = '.';
-	*--fmt_ptr = '*';
+	int nibbles = mantissa_nibbles;
+	int trailing = 0;
+	if (!spec.has_precision)
+	{
+		while (nibbles != 0 && ((fraction >> (4 * (mantissa_nibbles - nibbles))) & 0xF) == 0)
+		{
+			--nibbles;
+		}
+		fraction >>= 4 * (mantissa_nibbles - nibbles);
+	}
+	else if (static_cast<int>(spec.precision) < mantissa_nibbles)
+	{
+		nibbles = static_cast<int>(spec.precision);
+		int const shift = 4 * (mantissa_nibbles - nibbles);
+		std::uint64_t const remainder = fraction & ((std::uint64_t(1) << shift) - 1);
+		std::uint64_t const half = std::uint64_t(1) << (shift - 1);
+		fraction >>= shift;
+		bool const odd = ((nibbles != 0 ? fraction : lead) & 1) != 0;
+		if (remainder > half || (remainder == half && odd))
+		{
+			++fraction;
+			if ((fraction >> (4 * nibbles)) != 0)
+			{
+				++lead;
+				fraction = 0;
+			}
+		}
+	}
+	else
+	{
+		trailing = static_cast<int>(spec.precision < static_cast<unsigned>(float_max_precision) ? spec.precision : float_max_precision) - mantissa_nibbles;
+	}
 
-	// these flags are mutually exclusive within themselves (1)
-	if (spec.prepend_sign)
+	*ptr++ = alphabet[lead];
+	if (nibbles + trailing > 0 || spec.alternate_form)
 	{
-		*--fmt_ptr = FormatTraits<CharT>::cPlus;
+		*ptr++ = FormatTraits<CharT>::cDot;
 	}
-	else if (spec.prepend_space)
+	for (int i = nibbles; i-- != 0;)
 	{
-		*--fmt_ptr = FormatTraits<CharT>::cSpace;
+		*ptr++ = alphabet[(fraction >> (4 * i)) & 0xF];
 	}
+	ptr = std::fill_n(ptr, trailing, FormatTraits<CharT>::to_digit(0));
 
-	// these flags may all be set together (3)
-	if (spec.left_justify)
+	*ptr++ = static_cast<CharT>(upper ? 'P' : 'p');
+	*ptr++ = exponent < 0 ? FormatTraits<CharT>::cMinus : FormatTraits<CharT>::cPlus;
+
+	// binary exponents of a double have at most 4 digits
+	CharT exponent_buffer[4];
+	CharT* const exponent_end = exponent_buffer + 4;
+	CharT* exponent_ptr = exponent_end;
+	unsigned magnitude = exponent < 0 ? 0U - static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+	do
 	{
-		*--fmt_ptr = '-';
+		*--exponent_ptr = FormatTraits<CharT>::to_digit(static_cast<char>(magnitude % 10));
 	}
-	if (spec.leading_zeroes)
+	while ((magnitude /= 10) != 0);
+
+	return std::copy(exponent_ptr, exponent_end, ptr);
+}
+
+template <typename CharT, typename FloatT>
+void write_float(basic_format_writer<CharT>& out, FloatT value, basic_format_spec<CharT> const& spec)
+{
+	// precision-driven conversions work on the promoted value, as printf does
+	float_parts const parts = decompose_float(static_cast<double>(value));
+
+	bool const upper = spec.code == 'A' || spec.code == 'E' || spec.code == 'F' || spec.code == 'G';
+	int const precision = !spec.has_precision ? 6 : spec.precision < static_cast<unsigned>(float_max_precision) ? static_cast<int>(spec.precision) : float_max_precision;
+	bool zero_fill = spec.leading_zeroes;
+
+	// sign (1), hexadecimal prefix (2)
+	CharT prefix_buffer[3];
+	CharT* prefix_end = prefix_buffer;
+	if (parts.negative)
 	{
-		*--fmt_ptr = '0';
+		*prefix_end++ = FormatTraits<CharT>::cMinus;
 	}
-	if (spec.alternate_form)
+	else if (spec.prepend_sign)
+	{
+		*prefix_end++ = FormatTraits<CharT>::cPlus;
+	}
+	else if (spec.prepend_space)
 	{
-		*--fmt_ptr = FormatTraits<CharT>::cHash;
+		*prefix_end++ = FormatTraits<CharT>::cSpace;
 	}
 
-	// every format must start with this (1)
-	*--fmt_ptr = '%';
+	CharT buffer[float_buffer_size];
+	CharT* end = buffer;
 
-	constexpr std::size_t buf_size = 1078;
-	CharT buf[buf_size];
+	if (parts.infinite || parts.nan)
+	{
+		char const* const text = parts.infinite ? (upper ? "INF" : "inf") : (upper ? "NAN" : "nan");
+		for (int i = 0; i != 3; ++i)
+		{
+			*end++ = static_cast<CharT>(text[i]);
+		}
+		zero_fill = false;
+	}
+	else
+	{
+		char digits[float_max_digits];
+		int count = 0;
+		int point = 0;
+
+		switch (spec.code)
+		{
+		case 'a':
+		case 'A':
+			*prefix_end++ = FormatTraits<CharT>::to_digit(0);
+			*prefix_end++ = static_cast<CharT>(upper ? 'X' : 'x');
+			end = write_float_hex(end, parts, spec, upper);
+			break;
+		case 'e':
+		case 'E':
+			count = float_significant_digits(parts, precision + 1, digits, point);
+			end = write_float_exponent(end, digits, count, point, precision, spec.alternate_form, upper);
+			break;
+		case 'g':
+		case 'G':
+			end = write_float_general(end, parts, precision, spec.alternate_form, upper, spec.grouping);
+			break;
+		case 'f':
+		case 'F':
+			count = float_fixed_digits(parts, precision, digits, point);
+			end = write_float_fixed(end, digits, count, point, precision, spec.alternate_form, spec.grouping);
+			break;
+		default:
+			if (spec.has_precision)
+			{
+				count = float_fixed_digits(parts, precision, digits, point);
+				end = write_float_fixed(end, digits, count, point, precision, spec.alternate_form, spec.grouping);
+			}
+			else
+			{
+				end = write_float_shortest(end, value, spec.alternate_form, spec.grouping);
+			}
+			break;
+		}
+	}
+
+	basic_string_view<CharT> const prefix(prefix_buffer, prefix_end);
+	basic_string_view<CharT> const body(buffer, end);
 
-	int const result = float_helper(buf, buf_size, fmt_ptr, spec.width, spec.has_precision ? spec.precision : -1, value);
-	if (result > 0)
+	std::size_t const output_length = prefix.size() + body.size();
+	std::size_t const padding = spec.width > output_length ? spec.width - output_length : 0;
+
+	if (spec.left_justify)
+	{
+		write_padded_parts(out, 0, prefix, 0, body, padding);
+	}
+	else if (zero_fill)
+	{
+		write_padded_parts(out, 0, prefix, padding, body, 0);
+	}
+	else
 	{
-		out.write({buf, result < buf_size ? std::size_t(result) : buf_size});
+		write_padded_parts(out, padding, prefix, 0, body, 0);
 	}
 }
 
@@ -0,0 +1,187 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DETAIL_WRITE_HEX_BYTES_H)
+#define _guard_FORMATXX_DETAIL_WRITE_HEX_BYTES_H
+#pragma once
+
+#include "format_util.h"
+#include "bit_util.h"
+
+namespace formatxx {
+namespace _detail {
+
+#if defined(_FORMATXX_SSE2)
+inline void store_hex_text(char* dest, __m128i text) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), text); }
+
+template <typename CharT>
+void store_hex_text(CharT* dest, __m128i text)
+{
+	alignas(16) char buffer[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(buffer), text);
+	for (int i = 0; i != 16; ++i)
+	{
+		dest[i] = static_cast<CharT>(buffer[i]);
+	}
+}
+
+/// Converts 16 nibbles (one per byte lane) into hex digit characters.
+inline __m128i hex_nibbles_to_text(__m128i nibbles, bool upper)
+{
+	__m128i const letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(upper ? 'A' - '0' - 10 : 'a' - '0' - 10));
+	return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+#endif
+
+/// Writes two hex digits per byte with no separators, 16 bytes at a time where SIMD is available.
+template <typename CharT>
+CharT* write_hex_run(CharT* dest, unsigned char const* bytes, std::size_t count, bool upper)
+{
+#if defined(_FORMATXX_SSE2)
+	__m128i const mask = _mm_set1_epi8(0x0F);
+	for (; count >= 16; count -= 16, bytes += 16, dest += 32)
+	{
+		__m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+		__m128i const high = _mm_and_si128(_mm_srli_epi16(input, 4), mask);
+		__m128i const low = _mm_and_si128(input, mask);
+		store_hex_text(dest, hex_nibbles_to_text(_mm_unpacklo_epi8(high, low), upper));
+		store_hex_text(dest + 16, hex_nibbles_to_text(_mm_unpackhi_epi8(high, low), upper));
+	}
+#endif
+
+	CharT const* const pairs = upper ? FormatTraits<CharT>::sHexadecimalPairsUpper : FormatTraits<CharT>::sHexadecimalPairsLower;
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		unsigned const index = static_cast<unsigned>(bytes[i]) << 1;
+		*dest++ = pairs[index];
+		*dest++ = pairs[index + 1];
+	}
+	return dest;
+}
+
+/// Layout of a hex dump: optional single-space separators and a line break every per_line bytes.
+struct hex_bytes_layout
+{
+	std::size_t per_line = 0;
+	bool separate = false;
+	bool upper = false;
+
+	/// Total characters for count bytes.
+	std::size_t size(std::size_t count) const
+	{
+		if (count == 0)
+		{
+			return 0;
+		}
+		std::size_t const lines = per_line != 0 ? (count + per_line - 1) / per_line : 1;
+		std::size_t const separators = separate ? count - lines : 0;
+		return count * 2 + separators + (lines - 1);
+	}
+
+	/// Writes bytes [first, last) of data, where first and last are indices into the full span.
+	template <typename CharT>
+	CharT* write(CharT* dest, unsigned char const* data, std::size_t first, std::size_t last) const
+	{
+		CharT const* const pairs = upper ? FormatTraits<CharT>::sHexadecimalPairsUpper : FormatTraits<CharT>::sHexadecimalPairsLower;
+
+		std::size_t index = first;
+		while (index != last)
+		{
+			if (index != 0)
+			{
+				if (per_line != 0 && index % per_line == 0)
+				{
+					*dest++ = static_cast<CharT>('\n');
+				}
+				else if (separate)
+				{
+					*dest++ = FormatTraits<CharT>::cSpace;
+				}
+			}
+
+			if (!separate)
+			{
+				// everything up to the end of the line is one contiguous run
+				std::size_t const line_end = per_line != 0 ? (index / per_line + 1) * per_line : last;
+				std::size_t const run_end = line_end < last ? line_end : last;
+				dest = write_hex_run(dest, data + index, run_end - index, upper);
+				index = run_end;
+			}
+			else
+			{
+				unsigned const pair = static_cast<unsigned>(data[index]) << 1;
+				*dest++ = pairs[pair];
+				*dest++ = pairs[pair + 1];
+				++index;
+			}
+		}
+		return dest;
+	}
+};
+
+template <typename CharT>
+void write_hex_bytes(basic_format_writer<CharT>& out, hex_bytes bytes, basic_format_spec<CharT> const& spec)
+{
+	hex_bytes_layout layout;
+	layout.per_line = spec.width;
+	layout.separate = spec.prepend_space;
+	layout.upper = spec.code == 'X';
+
+	unsigned char const* const data = static_cast<unsigned char const*>(bytes.data);
+	std::size_t const total = layout.size(bytes.size);
+	if (total == 0)
+	{
+		return;
+	}
+
+	// a single pass straight into the destination when the writer exposes its buffer
+	CharT* const reserved = out.put_reserve(total);
+	if (reserved != nullptr)
+	{
+		layout.write(reserved, data, 0, bytes.size);
+		out.put_commit(reserved, total);
+		return;
+	}
+
+	// otherwise format in blocks; each byte needs at most three characters plus a line break
+	constexpr std::size_t block_bytes = 128;
+	CharT buffer[block_bytes * 4];
+	for (std::size_t first = 0; first < bytes.size; first += block_bytes)
+	{
+		std::size_t const last = bytes.size - first > block_bytes ? first + block_bytes : bytes.size;
+		CharT* const end = layout.write(buffer, data, first, last);
+		out.put({buffer, end});
+	}
+}
+
+} // namespace _detail
+} // namespace formatxx
+
+#endif // _guard_FORMATXX_DETAIL_WRITE_HEX_BYTES_H
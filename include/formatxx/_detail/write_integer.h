@@ -33,13 +33,14 @@
 #pragma once
 
 #include "format_util.h"
+#include "bit_util.h"
 #include <limits>
 #include <climits>
 
 namespace formatxx {
 namespace _detail {
 
-template <typename CharT, typename T> void write_integer(basic_format_writer<CharT>& out, T value, basic_string_view<CharT> spec);
+template <typename CharT, typename T> void write_integer(basic_format_writer<CharT>& out, T value, basic_format_spec<CharT> spec);
 
 struct prefix_helper
 {
@@ -86,97 +87,207 @@ struct decimal_helper
 	template <typename UnsignedT>
 	static constexpr std::size_t buffer_size() { return std::numeric_limits<UnsignedT>::digits10 + 1; }
 
-	template <typename CharT, typename UnsignedT>
-	static basic_string_view<CharT> write(CharT* buffer, UnsignedT value)
+	// approximate log10 from the bit width (1233/4096 ~= log10(2)), then correct
+	// by one against a table of powers of ten
+	static int count(std::uint32_t value)
+	{
+		static constexpr std::uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+		int const estimate = (bit_width(value) * 1233) >> 12;
+		return value != 0 ? estimate + (value >= powers[estimate]) : 1;
+	}
+
+	static int count(std::uint64_t value)
+	{
+		static constexpr std::uint64_t powers[] = {
+			1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+			10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+			1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL};
+		int const estimate = (bit_width(value) * 1233) >> 12;
+		return value != 0 ? estimate + (value >= powers[estimate]) : 1;
+	}
+
+	// writes exactly count(value) digits into [dest, dest + digits), directly
+	// into the final location, working on every two decimal digits (groups of 100).
+	// notes taken from cppformat, which took the notes from Alexandrescu from
+	// "Three Optimization Tips for C++"
+	template <typename CharT>
+	static void write(CharT* dest, std::uint32_t value, int digits)
 	{
-		// we'll work on every two decimal digits (groups of 100). notes taken from cppformat,
-		// which took the notes from Alexandrescu from "Three Optimization Tips for C++"
 		CharT const* const table = FormatTraits<CharT>::sDecimalPairs;
 
-		CharT* const end = buffer + buffer_size<UnsignedT>();
-		CharT* ptr = end;
+		// the common case of small counters and indices
+		if (value < 100)
+		{
+			if (value < 10)
+			{
+				*dest = FormatTraits<CharT>::to_digit(static_cast<char>(value));
+			}
+			else
+			{
+				dest[0] = table[value * 2];
+				dest[1] = table[value * 2 + 1];
+			}
+			return;
+		}
 
-		// work on every two decimal digits (groups of 100). notes taken from cppformat,
-		// which took the notes from Alexandrescu from "Three Optimization Tips for C++"
+		CharT* ptr = dest + digits;
 		while (value >= 100)
 		{
-			// I feel like we could do the % and / better... somehow
-			// we multiply the index by two to find the pair of digits to index
 			unsigned const digit = (value % 100) << 1;
 			value /= 100;
-
-			// write out both digits of the given index
 			*--ptr = table[digit + 1];
 			*--ptr = table[digit];
 		}
 
 		if (value >= 10)
 		{
-			// we have two digits left; this is identical to the above loop, but without the division
-			unsigned const digit = static_cast<unsigned>(value << 1);
+			unsigned const digit = value << 1;
 			*--ptr = table[digit + 1];
 			*--ptr = table[digit];
 		}
 		else
 		{
-			// we have but a single digit left, so this is easy
 			*--ptr = FormatTraits<CharT>::to_digit(static_cast<char>(value));
 		}
+	}
 
-		return {ptr, end};
+	template <typename CharT>
+	static void write(CharT* dest, std::uint64_t value, int digits)
+	{
+		// peel off 64-bit pairs only while the value is too large for the cheaper 32-bit path
+		CharT const* const table = FormatTraits<CharT>::sDecimalPairs;
+		CharT* ptr = dest + digits;
+		while (value > 0xFFFFFFFFu)
+		{
+			unsigned const digit = static_cast<unsigned>(value % 100) << 1;
+			value /= 100;
+			*--ptr = table[digit + 1];
+			*--ptr = table[digit];
+		}
+
+		std::uint32_t const low = static_cast<std::uint32_t>(value);
+		int const remaining = static_cast<int>(ptr - dest);
+		write(dest, low, remaining);
+	}
+
+	// the number of characters for digits with a separator between each group of three
+	static constexpr int grouped_length(int digits) { return digits + (digits - 1) / 3; }
+
+	// writes grouped_length(count(value)) characters, a group of three digits at a time
+	template <typename CharT, typename UnsignedT>
+	static void write_grouped(CharT* dest, UnsignedT value, int length, CharT separator)
+	{
+		CharT const* const table = FormatTraits<CharT>::sDecimalPairs;
+		CharT* ptr = dest + length;
+		while (value >= 1000)
+		{
+			unsigned const group = static_cast<unsigned>(value % 1000);
+			value /= 1000;
+			unsigned const pair = (group % 100) << 1;
+			*--ptr = table[pair + 1];
+			*--ptr = table[pair];
+			*--ptr = FormatTraits<CharT>::to_digit(static_cast<char>(group / 100));
+			*--ptr = separator;
+		}
+		write(dest, static_cast<std::uint32_t>(value), static_cast<int>(ptr - dest));
 	}
 };
 
+#if defined(_FORMATXX_SSE2)
+/// Expands all 16 nibbles of a 64-bit value at once, writing the trailing digits.
+template <bool LowerCase, typename CharT>
+void write_hexadecimal_sse2(CharT* dest, std::uint64_t value, int digits)
+{
+	// byte-swap so the most significant byte lands first in memory
+	std::uint64_t const swapped = byte_swap(value);
+	__m128i const input = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(&swapped));
+
+	__m128i const mask = _mm_set1_epi8(0x0F);
+	__m128i const high = _mm_and_si128(_mm_srli_epi16(input, 4), mask);
+	__m128i const low = _mm_and_si128(input, mask);
+	__m128i const nibbles = _mm_unpacklo_epi8(high, low);
+
+	// '0' + n, plus the gap to the letters for n > 9 (SSE2 has no byte shuffle for a table lookup)
+	__m128i const letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(LowerCase ? 'a' - '0' - 10 : 'A' - '0' - 10));
+	__m128i const text = _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+
+	alignas(16) char buffer[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(buffer), text);
+	for (int i = 0; i != digits; ++i)
+	{
+		dest[i] = static_cast<CharT>(buffer[16 - digits + i]);
+	}
+}
+#endif
+
 template <bool LowerCase>
 struct hexadecimal_helper
 {
- 	// 2 hex digits per octet
+	// one hex digit per nibble
 	template <typename UnsignedT>
-	static constexpr std::size_t buffer_size() { return 2 * sizeof(UnsignedT); }
+	static constexpr std::size_t buffer_size() { return (std::numeric_limits<UnsignedT>::digits + 3) / 4; }
+
+	template <typename UnsignedT>
+	static int count(UnsignedT value) { return value != 0 ? (bit_width(value) + 3) / 4 : 1; }
 
 	template <typename CharT, typename UnsignedT>
-	static basic_string_view<CharT> write(CharT* buffer, UnsignedT value)
+	static void write(CharT* dest, UnsignedT value, int digits)
 	{
-		CharT* const end = buffer + buffer_size<UnsignedT>();
-		CharT* ptr = end;
+#if defined(_FORMATXX_SSE2)
+		if (digits > 8)
+		{
+			return write_hexadecimal_sse2<LowerCase>(dest, value, digits);
+		}
+#endif
 
-		CharT const* const alphabet = LowerCase ?
-			FormatTraits<CharT>::sHexadecimalLower :
-			FormatTraits<CharT>::sHexadecimalUpper;
+		// one table lookup gives both digits of a byte
+		CharT const* const pairs = LowerCase ?
+			FormatTraits<CharT>::sHexadecimalPairsLower :
+			FormatTraits<CharT>::sHexadecimalPairsUpper;
 
-		do
+		CharT* ptr = dest + digits;
+		while (ptr - dest >= 2)
 		{
-			*--ptr = alphabet[value & 0xF];
+			unsigned const index = static_cast<unsigned>(value & 0xFF) << 1;
+			value >>= 8;
+			*--ptr = pairs[index + 1];
+			*--ptr = pairs[index];
+		}
+		if (ptr != dest)
+		{
+			// the second character of the pair for a byte below 16 is its single digit
+			*--ptr = pairs[(static_cast<unsigned>(value & 0xF) << 1) + 1];
 		}
-		while ((value >>= 4) != 0);
-
-		return {ptr, end};
 	}
 };
 
 struct octal_helper
 {
- 	// up to three 3 octal digits per octet - FIXME is that right? I don't think that's right
+	// one octal digit per 3 bits, rounding up
 	template <typename UnsignedT>
-	static constexpr std::size_t buffer_size() { return 3 * sizeof(UnsignedT); }
+	static constexpr std::size_t buffer_size() { return (std::numeric_limits<UnsignedT>::digits + 2) / 3; }
+
+	template <typename UnsignedT>
+	static int count(UnsignedT value) { return value != 0 ? (bit_width(value) + 2) / 3 : 1; }
 
 	template <typename CharT, typename UnsignedT>
-	static basic_string_view<CharT> write(CharT* buffer, UnsignedT value)
+	static void write(CharT* dest, UnsignedT value, int digits)
 	{
-		CharT* const end = buffer + buffer_size<UnsignedT>();
-		CharT* ptr = end;
+		// two octal digits per 6 bits
+		CharT const* const pairs = FormatTraits<CharT>::sOctalPairs;
 
-		// the octal alphabet is a subset of hexadecimal,
-		// and doesn't depend on casing.
-		CharT const* const alphabet = FormatTraits<CharT>::sHexadecimalLower;
-
-		do
+		CharT* ptr = dest + digits;
+		while (ptr - dest >= 2)
 		{
-			*--ptr = alphabet[value & 0x7];
+			unsigned const index = static_cast<unsigned>(value & 0x3F) << 1;
+			value >>= 6;
+			*--ptr = pairs[index + 1];
+			*--ptr = pairs[index];
+		}
+		if (ptr != dest)
+		{
+			*--ptr = FormatTraits<CharT>::to_digit(static_cast<char>(value & 0x7));
 		}
-		while ((value >>= 3) != 0);
-
-		return {ptr, end};
 	}
 };
 
@@ -186,78 +297,128 @@ struct binary_helper
 	template <typename UnsignedT>
  	static constexpr std::size_t buffer_size() { return std::numeric_limits<UnsignedT>::digits; }
 
+	template <typename UnsignedT>
+	static int count(UnsignedT value) { return value != 0 ? bit_width(value) : 1; }
+
 	template <typename CharT, typename UnsignedT>
-	static basic_string_view<CharT> write(CharT* buffer, UnsignedT value)
+	static void write(CharT* dest, UnsignedT value, int digits)
 	{
-		CharT* const end = buffer + buffer_size<UnsignedT>();
-		CharT* ptr = end;
+		// four binary digits per nibble
+		CharT const* const nibbles = FormatTraits<CharT>::sBinaryNibbles;
 
-		do
+		CharT* ptr = dest + digits;
+		while (ptr - dest >= 4)
 		{
-			*--ptr = FormatTraits<CharT>::to_digit(value & 1);
+			CharT const* const bits = nibbles + (static_cast<unsigned>(value & 0xF) << 2);
+			value >>= 4;
+			ptr -= 4;
+			std::copy_n(bits, 4, ptr);
+		}
+		while (ptr != dest)
+		{
+			*--ptr = FormatTraits<CharT>::to_digit(static_cast<char>(value & 1));
+			value >>= 1;
 		}
-		while ((value >>= 1) != 0);
-
-		return {ptr, end};
 	}
 };
 
-static constexpr std::size_t foo() { return 3; }
+/// Padding around a formatted integer of the given length.
+struct integer_layout
+{
+	std::size_t left_padding = 0;
+	std::size_t zeroes = 0;
+	std::size_t right_padding = 0;
+
+	template <typename CharT>
+	integer_layout(basic_format_spec<CharT> const& spec, std::size_t prefix_length, std::size_t digits_length)
+	{
+		if (spec.has_precision)
+		{
+			zeroes = spec.precision > digits_length ? spec.precision - digits_length : 0;
+			return;
+		}
+
+		std::size_t const output_length = prefix_length + digits_length;
+		std::size_t const padding = spec.width > output_length ? spec.width - output_length : 0;
+
+		if (spec.left_justify)
+		{
+			right_padding = padding;
+		}
+		else if (spec.leading_zeroes)
+		{
+			zeroes = padding;
+		}
+		else
+		{
+			left_padding = padding;
+		}
+	}
+};
 
 template <typename HelperT, typename CharT, typename ValueT>
 void write_integer_helper(basic_format_writer<CharT>& out, ValueT raw_value, basic_format_spec<CharT> const& spec)
 {
 	using unsigned_type = typename std::make_unsigned<ValueT>::type;
-	
+	using work_type = typename std::conditional<(sizeof(unsigned_type) > 4), std::uint64_t, std::uint32_t>::type;
+
 	// convert to an unsigned value to make the formatting easier; note that must
 	// subtract from 0 _after_ converting to deal with 2's complement format
-	// where (abs(min) > abs(max)), otherwise we'd not be able to format -min<T>
+	// where (abs(min) > abs(max)), otherwise we'd not be able to format -min<T>.
+	// the negation must also wrap in unsigned_type before widening to the working
+	// type, or small types would sign-extend
 	unsigned_type const unsigned_value = raw_value >= 0 ? raw_value : 0 - static_cast<unsigned_type>(raw_value);
+	work_type const value = unsigned_value;
 
 	// calculate prefixes like signs
 	CharT prefix_buffer[prefix_helper::buffer_size()];
 	auto const prefix = prefix_helper::write(prefix_buffer, spec, raw_value < 0);
 
-	// generate the actual number
-	CharT value_buffer[HelperT::template buffer_size<unsigned_type>()];
-	auto const result = HelperT::write(value_buffer, unsigned_value);
+	// size the number exactly up front; write_integer only leaves grouping set for decimal
+	int const digits = HelperT::count(value);
+	int const length = spec.grouping != 0 ? decimal_helper::grouped_length(digits) : digits;
+	integer_layout const layout(spec, prefix.size(), static_cast<std::size_t>(length));
+	std::size_t const total = layout.left_padding + prefix.size() + layout.zeroes + static_cast<std::size_t>(length) + layout.right_padding;
 
-	if (spec.has_precision)
-	{
-		out.write(prefix);
-		write_padded_align_right(out, result, FormatTraits<CharT>::to_digit(0), spec.precision);
-	}
-	else
+	// format straight into the destination when the writer exposes its buffer
+	CharT* const reserved = out.put_reserve(total);
+	if (reserved != nullptr)
 	{
-		std::size_t const output_length = prefix.size() + result.size();
-		std::size_t const padding = spec.width > output_length ? spec.width - output_length : 0;
+		CharT const space = FormatTraits<CharT>::cSpace;
+		CharT const zero = FormatTraits<CharT>::to_digit(0);
 
-		if (spec.left_justify)
-		{
-			out.write(prefix);
-			out.write(result);
-			write_padding(out, FormatTraits<CharT>::cSpace, padding);
-		}
-		else if (spec.leading_zeroes)
+		CharT* ptr = std::fill_n(reserved, layout.left_padding, space);
+		ptr = std::copy_n(prefix.data(), prefix.size(), ptr);
+		ptr = std::fill_n(ptr, layout.zeroes, zero);
+		if (spec.grouping != 0)
 		{
-			out.write(prefix);
-			write_padding(out, FormatTraits<CharT>::to_digit(0), padding);
-			out.write(result);
+			decimal_helper::write_grouped(ptr, value, length, spec.grouping);
 		}
 		else
 		{
-			write_padding(out, FormatTraits<CharT>::cSpace, padding);
-			out.write(prefix);
-			out.write(result);
+			HelperT::write(ptr, value, digits);
 		}
+		std::fill_n(ptr + length, layout.right_padding, space);
+		out.put_commit(reserved, total);
+		return;
+	}
+
+	// room for a separator every three digits
+	CharT value_buffer[HelperT::template buffer_size<unsigned_type>() * 4 / 3 + 1];
+	if (spec.grouping != 0)
+	{
+		decimal_helper::write_grouped(value_buffer, value, length, spec.grouping);
+	}
+	else
+	{
+		HelperT::write(value_buffer, value, digits);
 	}
+	write_padded_parts(out, layout.left_padding, prefix, layout.zeroes, basic_string_view<CharT>(value_buffer, static_cast<std::size_t>(length)), layout.right_padding);
 }
 
 template <typename CharT, typename T>
-void write_integer(basic_format_writer<CharT>& out, T raw, basic_string_view<CharT> spec_string)
+void write_integer(basic_format_writer<CharT>& out, T raw, basic_format_spec<CharT> spec)
 {
-	basic_format_spec<CharT> spec = parse_format_spec(spec_string);
-
 	switch (spec.code)
 	{
 	default:
@@ -270,16 +431,20 @@ void write_integer(basic_format_writer<CharT>& out, T raw, basic_string_view<Cha
 		return write_integer_helper<decimal_helper>(out, raw, spec);
  	case 'x':
 		spec.prepend_sign = spec.prepend_space = false; // ignored on hex numbers
+		spec.grouping = 0; // only decimal digits are grouped
 	 	return write_integer_helper<hexadecimal_helper</*lower=*/true>>(out, typename std::make_unsigned<T>::type(raw), spec);
  	case 'X':
 		spec.prepend_sign = spec.prepend_space = false; // ignored on hex numbers
+		spec.grouping = 0;
 	 	return write_integer_helper<hexadecimal_helper</*lower=*/false>>(out, typename std::make_unsigned<T>::type(raw), spec);
 	case 'o':
 	case 'O':
+		spec.grouping = 0;
 		return write_integer_helper<octal_helper>(out, raw, spec);
 		break;
 	case 'b':
 	case 'B':
+		spec.grouping = 0;
 		return write_integer_helper<binary_helper>(out, raw, spec);
 		break;
 	}
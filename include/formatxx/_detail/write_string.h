@@ -38,30 +38,52 @@ namespace formatxx {
 namespace _detail {
 namespace {
 
+/// Writes a string argument.
+/// @param stable True if str remains valid for as long as the writer's output is in use,
+///        which holds only for the caller's own arguments, and never for a format_value's temporaries.
 template <typename CharT>
-void write_string(basic_format_writer<CharT>& out, basic_string_view<CharT> str, basic_string_view<CharT> spec_string)
+void write_string(basic_format_writer<CharT>& out, basic_string_view<CharT> str, basic_format_spec<CharT> const& spec, bool stable = false)
 {
-	auto const spec = parse_format_spec(spec_string);
-
 	if (spec.has_precision)
 	{
 		str = trim_string(str, spec.precision);
 	}
 
-	if (!spec.left_justify)
+	std::size_t const padding = spec.width > str.size() ? spec.width - str.size() : 0;
+
+	if (padding == 0 && stable)
+	{
+		out.put_stable(str);
+	}
+	else if (padding == 0)
+	{
+		out.put(str);
+	}
+	else if (!spec.left_justify)
 	{
-		write_padded_align_right(out, str, FormatTraits<CharT>::cSpace, spec.width);
+		write_padded_parts<CharT>(out, padding, {}, 0, str, 0);
 	}
 	else
 	{
-		write_padded_align_left(out, str, FormatTraits<CharT>::cSpace, spec.width);
+		write_padded_parts<CharT>(out, 0, {}, 0, str, padding);
 	}
 }
 
 template <typename CharT>
-void write_char(basic_format_writer<CharT>& out, CharT ch, basic_string_view<CharT> spec)
+void write_char(basic_format_writer<CharT>& out, CharT ch, basic_format_spec<CharT> const& spec)
 {
-	write_string(out, {&ch, 1}, spec);
+	// the character is a local copy, so it must never be written as a stable reference
+	basic_string_view<CharT> const str = trim_string<CharT>({&ch, 1}, spec.has_precision ? spec.precision : 1);
+	std::size_t const padding = spec.width > str.size() ? spec.width - str.size() : 0;
+
+	if (!spec.left_justify)
+	{
+		write_padded_parts<CharT>(out, padding, {}, 0, str, 0);
+	}
+	else
+	{
+		write_padded_parts<CharT>(out, 0, {}, 0, str, padding);
+	}
 }
 
 } // anonymous namespace
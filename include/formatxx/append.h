@@ -0,0 +1,159 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_APPEND_H)
+#define _guard_FORMATXX_APPEND_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <formatxx/string.h>
+
+namespace formatxx
+{
+	template <typename ContainerT> class basic_append_writer;
+
+	template <typename ContainerT, typename FormatT, typename... Args> result_code format_append(ContainerT& container, FormatT const& format, Args const&... args);
+	template <typename ContainerT, typename FormatT, typename... Args> result_code printf_append(ContainerT& container, FormatT const& format, Args const&... args);
+
+	namespace _detail
+	{
+		/// The length of a format string, which bounds its literal text; zero for pre-parsed formats.
+		template <typename FormatT>
+		auto append_format_length(FormatT const& format, int) -> decltype(make_string_view(format).size()) { return make_string_view(format).size(); }
+		template <typename FormatT>
+		std::size_t append_format_length(FormatT const&, long) { return 0; }
+
+		/// A rough guess at an argument's formatted length: exact for sized strings, a typical number otherwise.
+		template <typename T> std::size_t append_size_hint(T const&) { return 16; }
+		template <typename CharT> std::size_t append_size_hint(basic_string_view<CharT> str) { return str.size(); }
+		template <typename CharT, typename TraitsT, typename AllocatorT>
+		std::size_t append_size_hint(std::basic_string<CharT, TraitsT, AllocatorT> const& str) { return str.size(); }
+
+		inline std::size_t append_size_hints() { return 0; }
+		template <typename T, typename... Args>
+		std::size_t append_size_hints(T const& first, Args const&... rest) { return append_size_hint(first) + append_size_hints(rest...); }
+
+		/// Append through the fastest path each container offers.
+		template <typename ContainerT, typename CharT>
+		void append_range(ContainerT& container, CharT const* data, std::size_t size) { container.insert(container.end(), data, data + size); }
+		template <typename CharT, typename TraitsT, typename AllocatorT>
+		void append_range(std::basic_string<CharT, TraitsT, AllocatorT>& string, CharT const* data, std::size_t size) { string.append(data, size); }
+
+		/// The format string's length plus a guess per argument.
+		template <typename FormatT, typename... Args>
+		std::size_t append_estimate(FormatT const& format, Args const&... args) { return append_format_length(format, 0) + append_size_hints(args...); }
+	}
+}
+
+/// A writer that appends to a caller-owned contiguous container, such as a std::string or a
+/// std::vector of characters. Fragments are inserted at the end; numbers are formatted in place
+/// in space added with resize. The container needs size, capacity, resize, reserve, insert,
+/// end and operator[].
+template <typename ContainerT>
+class formatxx::basic_append_writer : public basic_format_writer<typename ContainerT::value_type>
+{
+public:
+	using char_type = typename ContainerT::value_type;
+
+	explicit basic_append_writer(ContainerT& container) : _container(container) {}
+
+	basic_append_writer(basic_append_writer const&) = delete;
+	basic_append_writer& operator=(basic_append_writer const&) = delete;
+
+	void write(basic_string_view<char_type> str) override { _detail::append_range(_container, str.data(), str.size()); }
+	void write_fill(char_type ch, std::size_t count) override { _container.insert(_container.end(), count, ch); }
+	char_type* reserve(std::size_t count) override;
+	void commit(std::size_t count) override { _container.resize(_container.size() - _reserved + count); _reserved = 0; }
+
+	/// Make room for at least count more characters without reallocating.
+	void grow(std::size_t count);
+
+	ContainerT& container() const { return _container; }
+
+private:
+	ContainerT& _container;
+	std::size_t _reserved = 0;
+};
+
+template <typename ContainerT>
+void formatxx::basic_append_writer<ContainerT>::grow(std::size_t count)
+{
+	std::size_t const required = _container.size() + count;
+	std::size_t const capacity = _container.capacity();
+	if (required > capacity)
+	{
+		// reserve alone may allocate exactly, which would make repeated appends quadratic
+		std::size_t const doubled = capacity * 2;
+		_container.reserve(required > doubled ? required : doubled);
+	}
+}
+
+template <typename ContainerT>
+typename formatxx::basic_append_writer<ContainerT>::char_type* formatxx::basic_append_writer<ContainerT>::reserve(std::size_t count)
+{
+	if (count == 0)
+	{
+		return nullptr;
+	}
+
+	std::size_t const size = _container.size();
+	grow(count);
+	_container.resize(size + count);
+	_reserved = count;
+	return &_container[0] + size;
+}
+
+/// Append the string format using the given parameters to a container.
+/// Room is reserved up front from the format string's length plus a guess per argument,
+/// growing the container geometrically.
+/// @param container The string or vector that the formatted text is appended to.
+/// @param format The primary text and formatting controls to be written.
+/// @param args The arguments used by the formatting string.
+template <typename ContainerT, typename FormatT, typename... Args>
+formatxx::result_code formatxx::format_append(ContainerT& container, FormatT const& format, Args const&... args)
+{
+	basic_append_writer<ContainerT> writer(container);
+	writer.grow(_detail::append_estimate(format, args...));
+	return formatxx::format(writer, format, args...);
+}
+
+/// Append the printf format using the given parameters to a container.
+/// @param container The string or vector that the formatted text is appended to.
+/// @param format The primary text and printf controls to be written.
+/// @param args The arguments used by the formatting string.
+template <typename ContainerT, typename FormatT, typename... Args>
+formatxx::result_code formatxx::printf_append(ContainerT& container, FormatT const& format, Args const&... args)
+{
+	basic_append_writer<ContainerT> writer(container);
+	writer.grow(_detail::append_estimate(format, args...));
+	return formatxx::printf(writer, format, args...);
+}
+
+#endif // !defined(_guard_FORMATXX_APPEND_H)
@@ -0,0 +1,216 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_ARENA_H)
+#define _guard_FORMATXX_ARENA_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace formatxx
+{
+	class arena;
+	template <std::size_t SizeN = 4096> class monotonic_arena;
+	template <typename T> class arena_allocator;
+
+} // namespace formatxx
+
+/// A source of memory for writers and allocators.
+/// Implement this to back writers with a pool, a per-request arena, or similar.
+class formatxx::arena
+{
+public:
+	/// Allocate memory.
+	/// @param size The number of bytes to allocate.
+	/// @param alignment The required alignment, which is a power of two.
+	/// @returns a pointer to the new memory; failure is reported by the implementation (e.g. std::bad_alloc).
+	virtual void* allocate(std::size_t size, std::size_t alignment) = 0;
+
+	/// Return memory to the arena.
+	/// Arenas that only release memory in bulk may ignore this.
+	virtual void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept { (void)ptr; (void)size; (void)alignment; }
+
+protected:
+	~arena() = default;
+};
+
+/// An arena that hands out memory sequentially and frees it all at once.
+/// The first SizeN bytes come from inline storage; further blocks come from the heap
+/// and grow geometrically. Deallocating the most recent allocation makes its space available again.
+/// Resetting keeps the largest heap block for reuse, so an arena reset per request stops allocating
+/// once it has seen its largest request.
+template <std::size_t SizeN>
+class formatxx::monotonic_arena : public arena
+{
+public:
+	monotonic_arena() = default;
+	~monotonic_arena() { _release_blocks(); ::operator delete(_spare); }
+
+	monotonic_arena(monotonic_arena const&) = delete;
+	monotonic_arena& operator=(monotonic_arena const&) = delete;
+
+	void* allocate(std::size_t size, std::size_t alignment) override;
+	void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept override;
+
+	/// Release all memory, keeping the inline storage and the largest heap block.
+	void reset() noexcept;
+
+	/// The number of bytes currently handed out from the active block.
+	std::size_t used() const noexcept { return static_cast<std::size_t>(_next - _first); }
+
+private:
+	struct block
+	{
+		block* previous;
+		std::size_t size;
+	};
+
+	void _release_blocks() noexcept;
+
+	alignas(std::max_align_t) unsigned char _storage[SizeN];
+	unsigned char* _first = _storage;
+	unsigned char* _next = _storage;
+	unsigned char* _sentinel = _storage + SizeN;
+	block* _blocks = nullptr;
+	block* _spare = nullptr;
+	std::size_t _block_size = _initial_block_size;
+
+	static constexpr std::size_t _initial_block_size = SizeN < 256 ? 512 : SizeN * 2;
+};
+
+/// A std-compatible allocator which draws from a formatxx::arena.
+template <typename T>
+class formatxx::arena_allocator
+{
+public:
+	using value_type = T;
+
+	arena_allocator(arena& source) noexcept : _arena(&source) {}
+	template <typename U> arena_allocator(arena_allocator<U> const& rhs) noexcept : _arena(&rhs.source()) {}
+
+	T* allocate(std::size_t count) { return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T* ptr, std::size_t count) noexcept { _arena->deallocate(ptr, count * sizeof(T), alignof(T)); }
+
+	arena& source() const noexcept { return *_arena; }
+
+	template <typename U> friend bool operator==(arena_allocator const& lhs, arena_allocator<U> const& rhs) noexcept { return &lhs.source() == &rhs.source(); }
+	template <typename U> friend bool operator!=(arena_allocator const& lhs, arena_allocator<U> const& rhs) noexcept { return &lhs.source() != &rhs.source(); }
+
+private:
+	arena* _arena = nullptr;
+};
+
+template <std::size_t SizeN>
+void* formatxx::monotonic_arena<SizeN>::allocate(std::size_t size, std::size_t alignment)
+{
+	std::uintptr_t const mask = alignment - 1;
+	std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(_next) + mask) & ~mask;
+
+	if (aligned + size > reinterpret_cast<std::uintptr_t>(_sentinel))
+	{
+		// start a new block large enough for the request, reusing the block kept by reset if it fits
+		block* header = _spare;
+		if (header != nullptr && header->size >= size + alignment)
+		{
+			_spare = nullptr;
+		}
+		else
+		{
+			std::size_t capacity = _block_size;
+			while (capacity < size + alignment)
+			{
+				capacity *= 2;
+			}
+			_block_size = capacity * 2;
+
+			header = static_cast<block*>(::operator new(sizeof(block) + capacity));
+			header->size = capacity;
+		}
+		header->previous = _blocks;
+		_blocks = header;
+
+		_first = _next = reinterpret_cast<unsigned char*>(header + 1);
+		_sentinel = _first + header->size;
+		aligned = (reinterpret_cast<std::uintptr_t>(_next) + mask) & ~mask;
+	}
+
+	unsigned char* const result = reinterpret_cast<unsigned char*>(aligned);
+	_next = result + size;
+	return result;
+}
+
+template <std::size_t SizeN>
+void formatxx::monotonic_arena<SizeN>::deallocate(void* ptr, std::size_t size, std::size_t) noexcept
+{
+	// only the most recent allocation can be returned
+	if (static_cast<unsigned char*>(ptr) + size == _next)
+	{
+		_next = static_cast<unsigned char*>(ptr);
+	}
+}
+
+template <std::size_t SizeN>
+void formatxx::monotonic_arena<SizeN>::reset() noexcept
+{
+	// blocks grow geometrically, so the newest is the largest; keep it or the spare, whichever is bigger
+	if (_blocks != nullptr)
+	{
+		block* const newest = _blocks;
+		_blocks = newest->previous;
+		_release_blocks();
+		if (_spare == nullptr || _spare->size < newest->size)
+		{
+			::operator delete(_spare);
+			_spare = newest;
+		}
+		else
+		{
+			::operator delete(newest);
+		}
+	}
+	_first = _next = _storage;
+	_sentinel = _storage + SizeN;
+	_block_size = _initial_block_size;
+}
+
+template <std::size_t SizeN>
+void formatxx::monotonic_arena<SizeN>::_release_blocks() noexcept
+{
+	while (_blocks != nullptr)
+	{
+		block* const previous = _blocks->previous;
+		::operator delete(_blocks);
+		_blocks = previous;
+	}
+}
+
+#endif // !defined(_guard_FORMATXX_ARENA_H)
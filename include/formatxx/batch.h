@@ -0,0 +1,242 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_BATCH_H)
+#define _guard_FORMATXX_BATCH_H
+#pragma once
+
+#include <formatxx/compiled.h>
+#include <formatxx/buffered.h>
+#include <vector>
+
+namespace formatxx
+{
+	class batch_executor;
+	class thread_executor;
+	template <typename CharT> class basic_row_chunks;
+
+	using row_chunks = basic_row_chunks<char>;
+
+	template <typename CharT, typename... Columns> result_code format_rows(basic_format_writer<CharT>& writer, basic_compiled_format<CharT> const& format, std::size_t rows, Columns const*... columns);
+	template <typename CharT, typename... Columns> result_code format_rows_parallel(basic_row_chunks<CharT>& chunks, batch_executor& executor, basic_compiled_format<CharT> const& format, std::size_t rows, std::size_t chunk_rows, Columns const*... columns);
+	template <typename CharT, typename... Columns> result_code format_rows_parallel(basic_format_writer<CharT>& writer, batch_executor& executor, basic_compiled_format<CharT> const& format, std::size_t rows, std::size_t chunk_rows, Columns const*... columns);
+
+	/// @internal
+	namespace _detail
+	{
+		/// One column of a batch: its values and the formatter for their type, resolved once per batch.
+		template <typename CharT>
+		struct batch_column
+		{
+			using format_type = void(FORMATXX_API *)(basic_format_writer<CharT>&, void const* values, std::size_t row, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec);
+
+			format_type format;
+			void const* values;
+		};
+
+		template <typename CharT, typename T>
+		void FORMATXX_API format_column_value(basic_format_writer<CharT>& out, void const* values, std::size_t row, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+		{
+			format_value_dispatch(out, static_cast<T const*>(values)[row], spec_string, spec, has_spec_format_value<CharT, T>());
+		}
+
+		template <typename CharT, typename T>
+		batch_column<CharT> make_batch_column(T const* values) { return {&format_column_value<CharT, T>, values}; }
+
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API format_rows_impl(basic_format_writer<CharT>& out, compiled_segment<CharT> const* segments, std::size_t count, batch_column<CharT> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row);
+
+		template <typename CharT>
+		struct parallel_rows
+		{
+			basic_row_chunks<CharT>* chunks;
+			compiled_segment<CharT> const* segments;
+			std::size_t count;
+			batch_column<CharT> const* columns;
+			std::size_t column_count;
+			std::size_t rows;
+			std::size_t chunk_rows;
+		};
+
+		template <typename CharT>
+		void FORMATXX_API format_chunk_task(void* context, std::size_t index);
+	}
+}
+
+/// Runs the chunks of a parallel batch.
+/// Implement this to hand the work to an existing thread pool.
+class FORMATXX_PUBLIC formatxx::batch_executor
+{
+public:
+	using task_type = void(FORMATXX_API *)(void* context, std::size_t index);
+
+	virtual ~batch_executor() = default;
+
+	/// Call task(context, index) once for every index in [0, count), in any order and on any
+	/// threads, returning only when every call has finished.
+	virtual void run(std::size_t count, task_type task, void* context) = 0;
+};
+
+/// An executor that starts threads for each run and joins them before returning.
+class FORMATXX_PUBLIC formatxx::thread_executor : public batch_executor
+{
+public:
+	/// @param threads The most threads to use; zero uses one per hardware thread.
+	explicit thread_executor(unsigned threads = 0);
+
+	void run(std::size_t count, task_type task, void* context) override;
+
+private:
+	unsigned _threads = 1;
+};
+
+/// The output of a parallel batch, one buffer per chunk of rows, in row order.
+/// The chunks can be written out one after another, or referenced directly, for example
+/// by writing them to an iovec_writer, which references rather than copies long stable spans.
+template <typename CharT>
+class formatxx::basic_row_chunks
+{
+public:
+	using chunk_type = basic_buffered_writer<CharT, 64>;
+
+	std::size_t size() const { return _chunks.size(); }
+	basic_string_view<CharT> operator[](std::size_t index) const { return {_chunks[index].data(), _chunks[index].size()}; }
+
+	/// The first failure of any chunk, in row order.
+	result_code result() const;
+
+	/// Write every chunk in order, as stable spans.
+	void write_to(basic_format_writer<CharT>& out) const;
+
+private:
+	template <typename> friend void FORMATXX_API _detail::format_chunk_task(void*, std::size_t);
+
+	template <typename C, typename... Columns>
+	friend result_code formatxx::format_rows_parallel(basic_row_chunks<C>& chunks, batch_executor& executor, basic_compiled_format<C> const& format, std::size_t rows, std::size_t chunk_rows, Columns const*... columns);
+
+	std::vector<chunk_type> _chunks;
+	std::vector<result_code> _results;
+};
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_rows_impl(basic_format_writer<char>& out, compiled_segment<char> const* segments, std::size_t count, batch_column<char> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_rows_impl(basic_format_writer<wchar_t>& out, compiled_segment<wchar_t> const* segments, std::size_t count, batch_column<wchar_t> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row);
+
+/// Write a compiled format once per row, taking argument N of row R from columns[N][R].
+/// The format is parsed once and each column's formatter is chosen once, so each row costs
+/// only its literal text and one direct call per value.
+/// @param writer The write buffer that will receive the formatted rows.
+/// @param format The compiled text and formatting controls to be written for each row.
+/// @param rows The number of rows, which every column must have.
+/// @param columns Pointers to the first value of each column.
+template <typename CharT, typename... Columns>
+formatxx::result_code formatxx::format_rows(basic_format_writer<CharT>& writer, basic_compiled_format<CharT> const& format, std::size_t rows, Columns const*... columns)
+{
+	_detail::batch_column<CharT> const packed[] = {_detail::make_batch_column<CharT>(columns)..., _detail::batch_column<CharT>()};
+
+	result_code const result = _detail::format_rows_impl(writer, format.segments(), format.size(), packed, sizeof...(columns), 0, rows);
+	return format.result() != result_code::success ? format.result() : result;
+}
+
+template <typename CharT>
+void FORMATXX_API formatxx::_detail::format_chunk_task(void* context, std::size_t index)
+{
+	parallel_rows<CharT> const& batch = *static_cast<parallel_rows<CharT> const*>(context);
+	std::size_t const first = index * batch.chunk_rows;
+	std::size_t const last = batch.rows - first < batch.chunk_rows ? batch.rows : first + batch.chunk_rows;
+	batch.chunks->_results[index] = format_rows_impl(batch.chunks->_chunks[index], batch.segments, batch.count, batch.columns, batch.column_count, first, last);
+}
+
+template <typename CharT>
+formatxx::result_code formatxx::basic_row_chunks<CharT>::result() const
+{
+	for (result_code const result : _results)
+	{
+		if (result != result_code::success)
+		{
+			return result;
+		}
+	}
+	return result_code::success;
+}
+
+template <typename CharT>
+void formatxx::basic_row_chunks<CharT>::write_to(basic_format_writer<CharT>& out) const
+{
+	for (chunk_type const& chunk : _chunks)
+	{
+		out.write_stable({chunk.data(), chunk.size()});
+	}
+}
+
+/// Write a compiled format once per row like format_rows, splitting the rows into chunks that
+/// the executor formats concurrently, each into its own buffer.
+/// @param chunks Receives one buffer per chunk, replacing its previous contents.
+/// @param executor Runs the chunks.
+/// @param format The compiled text and formatting controls to be written for each row.
+/// @param rows The number of rows, which every column must have.
+/// @param chunk_rows The number of rows per chunk; zero picks a default.
+/// @param columns Pointers to the first value of each column, which must be safe to read concurrently.
+template <typename CharT, typename... Columns>
+formatxx::result_code formatxx::format_rows_parallel(basic_row_chunks<CharT>& chunks, batch_executor& executor, basic_compiled_format<CharT> const& format, std::size_t rows, std::size_t chunk_rows, Columns const*... columns)
+{
+	_detail::batch_column<CharT> const packed[] = {_detail::make_batch_column<CharT>(columns)..., _detail::batch_column<CharT>()};
+
+	if (chunk_rows == 0)
+	{
+		chunk_rows = 4096;
+	}
+	std::size_t const chunk_count = rows / chunk_rows + (rows % chunk_rows != 0 ? 1 : 0);
+
+	chunks._chunks.clear();
+	chunks._chunks.resize(chunk_count);
+	chunks._results.assign(chunk_count, result_code::success);
+
+	_detail::parallel_rows<CharT> batch{&chunks, format.segments(), format.size(), packed, sizeof...(columns), rows, chunk_rows};
+	executor.run(chunk_count, &_detail::format_chunk_task<CharT>, &batch);
+
+	result_code const result = chunks.result();
+	return format.result() != result_code::success ? format.result() : result;
+}
+
+/// Write a compiled format once per row using format_rows_parallel, then copy the chunks to
+/// writer in order. The chunks are temporary, so they are not handed to write_stable.
+template <typename CharT, typename... Columns>
+formatxx::result_code formatxx::format_rows_parallel(basic_format_writer<CharT>& writer, batch_executor& executor, basic_compiled_format<CharT> const& format, std::size_t rows, std::size_t chunk_rows, Columns const*... columns)
+{
+	basic_row_chunks<CharT> chunks;
+	result_code const result = format_rows_parallel(chunks, executor, format, rows, chunk_rows, columns...);
+	for (std::size_t index = 0; index != chunks.size(); ++index)
+	{
+		writer.put(chunks[index]);
+	}
+	return result;
+}
+
+#endif // !defined(_guard_FORMATXX_BATCH_H)
@@ -0,0 +1,347 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_BINARY_H)
+#define _guard_FORMATXX_BINARY_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <formatxx/buffered.h>
+#include <formatxx/unicode.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring> // for std::memcpy
+#include <deque>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace formatxx
+{
+	/// Identifies the type of each argument in a binary record.
+	enum class binary_tag : std::uint8_t
+	{
+		boolean = 1,
+		character,
+		wide_character,
+		signed8,
+		signed16,
+		signed32,
+		signed64,
+		unsigned8,
+		unsigned16,
+		unsigned32,
+		unsigned64,
+		float32,
+		float64,
+		string,
+		wide_string,
+		pointer,
+		bytes,
+	};
+
+	class format_registry;
+
+	template <typename FormatT, typename... Args> result_code encode_format(format_writer& out, format_registry& registry, FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> result_code encode_printf(format_writer& out, format_registry& registry, FormatT const& format, Args const&... args);
+
+	/// Decode the binary record at the start of input into text, advancing input past it.
+	/// @returns malformed_input if the record is truncated, corrupt or references an unknown format.
+	FORMATXX_PUBLIC result_code FORMATXX_API decode_record(format_writer& out, format_registry const& registry, string_view& input);
+
+} // namespace formatxx
+
+/// Assigns stable numeric IDs to format strings for binary records.
+/// IDs are handed out in order of first use, so a decoder can rebuild the same table by
+/// interning the saved strings in ID order.
+class FORMATXX_PUBLIC formatxx::format_registry
+{
+public:
+	format_registry() : _serial(next_serial()) {}
+
+	format_registry(format_registry const&) = delete;
+	format_registry& operator=(format_registry const&) = delete;
+
+	/// Find or assign the ID of a format string. Thread-safe.
+	std::uint32_t intern(string_view format);
+
+	/// The format string with the given ID, or an empty view with a null data() if unknown.
+	string_view lookup(std::uint32_t id) const;
+
+	/// The number of interned format strings.
+	std::size_t size() const;
+
+	/// Distinguishes registries in per-thread caches, even when one reuses another's address.
+	std::uint64_t serial() const { return _serial; }
+
+private:
+	static std::uint64_t next_serial();
+
+	mutable std::mutex _mutex;
+	std::deque<std::string> _strings;
+	std::unordered_map<std::string, std::uint32_t> _ids;
+	std::uint64_t _serial = 0;
+};
+
+namespace formatxx
+{
+	namespace _detail
+	{
+		enum class binary_syntax : std::uint8_t { format, printf };
+
+		/// Looks up format string IDs, skipping the registry's lock after the first use.
+		/// Entries are found by address but matched on content, so a buffer reused for a
+		/// different format string of the same length is interned again.
+		inline std::uint32_t binary_format_id(format_registry& registry, string_view format)
+		{
+			struct entry
+			{
+				std::uint64_t serial = 0;
+				std::string text;
+				std::uint32_t id = 0;
+			};
+			constexpr std::size_t entry_count = 64;
+			static thread_local entry cache[entry_count];
+
+			std::uintptr_t const bits = reinterpret_cast<std::uintptr_t>(format.data());
+			entry& slot = cache[((bits >> 4) ^ (bits >> 10) ^ registry.serial()) % entry_count];
+			if (slot.serial != registry.serial() || slot.text.size() != format.size() || slot.text.compare(0, format.size(), format.data(), format.size()) != 0)
+			{
+				slot.id = registry.intern(format);
+				slot.serial = registry.serial();
+				slot.text.assign(format.data(), format.size());
+			}
+			return slot.id;
+		}
+
+		/// Builds the body of a binary record.
+		class binary_encoder
+		{
+		public:
+			void byte(std::uint8_t value) { char const ch = static_cast<char>(value); _body.write({&ch, 1}); }
+			void tag(binary_tag value) { byte(static_cast<std::uint8_t>(value)); }
+			void raw(void const* data, std::size_t size) { _body.write({static_cast<char const*>(data), size}); }
+
+			void varint(std::uint64_t value)
+			{
+				char buffer[10];
+				std::size_t length = 0;
+				while (value >= 0x80)
+				{
+					buffer[length++] = static_cast<char>((value & 0x7F) | 0x80);
+					value >>= 7;
+				}
+				buffer[length++] = static_cast<char>(value);
+				_body.write({buffer, length});
+			}
+
+			void zigzag(std::int64_t value) { varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63)); }
+
+			void fixed(std::uint64_t bits, std::size_t bytes)
+			{
+				char buffer[8];
+				for (std::size_t i = 0; i != bytes; ++i)
+				{
+					buffer[i] = static_cast<char>((bits >> (i * 8)) & 0xFF);
+				}
+				_body.write({buffer, bytes});
+			}
+
+			void string(string_view str) { tag(binary_tag::string); varint(str.size()); raw(str.data(), str.size()); }
+
+			template <typename C>
+			void wide_string(basic_string_view<C> str)
+			{
+				tag(binary_tag::wide_string);
+				varint(str.size());
+				for (C const ch : str)
+				{
+					varint(static_cast<std::uint64_t>(ch));
+				}
+			}
+
+			/// Writes the framed record: the body's length, then the body.
+			void finish(format_writer& out) const
+			{
+				binary_encoder length;
+				length.varint(_body.size());
+				out.write({length._body.data(), length._body.size()});
+				out.write({_body.data(), _body.size()});
+			}
+
+		private:
+			basic_buffered_writer<char, 256> _body;
+		};
+
+		template <binary_tag Signed, binary_tag Unsigned> struct binary_integer_tags { static constexpr binary_tag signed_tag = Signed; static constexpr binary_tag unsigned_tag = Unsigned; };
+		template <std::size_t Size> struct binary_integer;
+		template <> struct binary_integer<1> : binary_integer_tags<binary_tag::signed8, binary_tag::unsigned8> {};
+		template <> struct binary_integer<2> : binary_integer_tags<binary_tag::signed16, binary_tag::unsigned16> {};
+		template <> struct binary_integer<4> : binary_integer_tags<binary_tag::signed32, binary_tag::unsigned32> {};
+		template <> struct binary_integer<8> : binary_integer_tags<binary_tag::signed64, binary_tag::unsigned64> {};
+
+		template <typename IntegerT>
+		void encode_integer(binary_encoder& encoder, IntegerT value, std::true_type /*signed*/)
+		{
+			binary_tag const tag = binary_integer<sizeof(IntegerT)>::signed_tag;
+			encoder.tag(tag);
+			encoder.zigzag(static_cast<std::int64_t>(value));
+		}
+
+		template <typename IntegerT>
+		void encode_integer(binary_encoder& encoder, IntegerT value, std::false_type /*signed*/)
+		{
+			binary_tag const tag = binary_integer<sizeof(IntegerT)>::unsigned_tag;
+			encoder.tag(tag);
+			encoder.varint(static_cast<std::uint64_t>(value));
+		}
+
+		inline void encode_binary_value(binary_encoder& encoder, bool value) { encoder.tag(binary_tag::boolean); encoder.byte(value ? 1 : 0); }
+		inline void encode_binary_value(binary_encoder& encoder, char value) { encoder.tag(binary_tag::character); encoder.byte(static_cast<std::uint8_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, wchar_t value) { encoder.tag(binary_tag::wide_character); encoder.varint(static_cast<std::uint64_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, float value) { std::uint32_t bits; std::memcpy(&bits, &value, sizeof(bits)); encoder.tag(binary_tag::float32); encoder.fixed(bits, 4); }
+		inline void encode_binary_value(binary_encoder& encoder, double value) { std::uint64_t bits; std::memcpy(&bits, &value, sizeof(bits)); encoder.tag(binary_tag::float64); encoder.fixed(bits, 8); }
+		inline void encode_binary_value(binary_encoder& encoder, char const* value) { encoder.string(value); }
+		inline void encode_binary_value(binary_encoder& encoder, char* value) { encoder.string(value); }
+		inline void encode_binary_value(binary_encoder& encoder, string_view value) { encoder.string(value); }
+		inline void encode_binary_value(binary_encoder& encoder, wchar_t const* value) { encoder.wide_string(basic_string_view<wchar_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, wchar_t* value) { encoder.wide_string(basic_string_view<wchar_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, basic_string_view<wchar_t> value) { encoder.wide_string(value); }
+		/// UTF-8, UTF-16 and UTF-32 strings are transcoded to the narrow string they decode to.
+		template <typename C>
+		void encode_transcoded_string(binary_encoder& encoder, basic_string_view<C> value)
+		{
+			basic_buffered_writer<char, 256> text;
+			format_value(text, value, string_view());
+			encoder.string({text.c_str(), text.size()});
+		}
+
+		inline void encode_binary_value(binary_encoder& encoder, char16_t const* value) { encode_transcoded_string(encoder, basic_string_view<char16_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, char16_t* value) { encode_transcoded_string(encoder, basic_string_view<char16_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, basic_string_view<char16_t> value) { encode_transcoded_string(encoder, value); }
+		inline void encode_binary_value(binary_encoder& encoder, char32_t const* value) { encode_transcoded_string(encoder, basic_string_view<char32_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, char32_t* value) { encode_transcoded_string(encoder, basic_string_view<char32_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, basic_string_view<char32_t> value) { encode_transcoded_string(encoder, value); }
+#if defined(__cpp_char8_t)
+		inline void encode_binary_value(binary_encoder& encoder, char8_t const* value) { encode_transcoded_string(encoder, basic_string_view<char8_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, char8_t* value) { encode_transcoded_string(encoder, basic_string_view<char8_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, basic_string_view<char8_t> value) { encode_transcoded_string(encoder, value); }
+#endif
+		inline void encode_binary_value(binary_encoder& encoder, void const* value) { encoder.tag(binary_tag::pointer); encoder.varint(reinterpret_cast<std::uintptr_t>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, void* value) { encode_binary_value(encoder, static_cast<void const*>(value)); }
+		inline void encode_binary_value(binary_encoder& encoder, hex_bytes value) { encoder.tag(binary_tag::bytes); encoder.varint(value.size); encoder.raw(value.data, value.size); }
+
+		template <typename TraitsT, typename AllocatorT>
+		void encode_binary_value(binary_encoder& encoder, std::basic_string<char, TraitsT, AllocatorT> const& value) { encoder.string({value.c_str(), value.size()}); }
+
+		template <typename TraitsT, typename AllocatorT>
+		void encode_binary_value(binary_encoder& encoder, std::basic_string<wchar_t, TraitsT, AllocatorT> const& value) { encoder.wide_string(basic_string_view<wchar_t>(value.c_str(), value.size())); }
+
+		template <typename C, typename TraitsT, typename AllocatorT>
+		auto encode_binary_value(binary_encoder& encoder, std::basic_string<C, TraitsT, AllocatorT> const& value) -> typename std::enable_if<!std::is_same<C, char>::value && !std::is_same<C, wchar_t>::value>::type
+		{
+			encode_transcoded_string(encoder, basic_string_view<C>(value.c_str(), value.size()));
+		}
+
+		template <typename T>
+		auto encode_binary_value(binary_encoder& encoder, T const& value) -> typename std::enable_if<is_format_integer<T>::value>::type
+		{
+			encode_integer(encoder, value, std::is_signed<T>());
+		}
+
+		template <typename T>
+		auto encode_binary_value(binary_encoder& encoder, T const& value) -> typename std::enable_if<std::is_enum<T>::value>::type
+		{
+			encode_binary_value(encoder, static_cast<typename std::underlying_type<T>::type>(value));
+		}
+
+		template <typename T>
+		auto encode_binary_value(binary_encoder& encoder, T const& value) -> typename std::enable_if<std::is_pointer<T>::value>::type
+		{
+			encode_binary_value(encoder, static_cast<void const*>(value));
+		}
+
+		/// Types without a binary tag are rendered to text now, without their spec.
+		template <typename T>
+		auto encode_binary_value(binary_encoder& encoder, T const& value) -> typename std::enable_if<!is_format_integer<T>::value && !std::is_enum<T>::value && !std::is_pointer<T>::value && !std::is_array<T>::value>::type
+		{
+			basic_buffered_writer<char, 256> text;
+			format_value(text, value, string_view());
+			encoder.string({text.c_str(), text.size()});
+		}
+
+		inline void encode_binary_args(binary_encoder&) {}
+
+		template <typename T, typename... Rest>
+		void encode_binary_args(binary_encoder& encoder, T const& value, Rest const&... rest)
+		{
+			encode_binary_value(encoder, value);
+			encode_binary_args(encoder, rest...);
+		}
+
+		template <typename... Args>
+		result_code encode_binary(format_writer& out, format_registry& registry, binary_syntax syntax, string_view format, Args const&... args)
+		{
+			binary_encoder encoder;
+			encoder.varint(binary_format_id(registry, format));
+			encoder.byte(static_cast<std::uint8_t>(syntax));
+			encoder.varint(sizeof...(args));
+			encode_binary_args(encoder, args...);
+			encoder.finish(out);
+			return result_code::success;
+		}
+	}
+
+} // namespace formatxx
+
+/// Write a compact binary record of a string format call instead of its text.
+/// The record holds the format's registry ID and each argument tagged by type;
+/// decode_record turns it back into the same text. Arguments without a binary tag
+/// (user types) are rendered to text at encode time, ignoring their spec.
+/// @param out The write buffer that will receive the record bytes.
+/// @param registry The registry that assigns the format string's ID.
+/// @param format The primary text and formatting controls.
+/// @param args The arguments used by the formatting string.
+template <typename FormatT, typename... Args>
+formatxx::result_code formatxx::encode_format(format_writer& out, format_registry& registry, FormatT const& format, Args const&... args)
+{
+	return _detail::encode_binary(out, registry, _detail::binary_syntax::format, make_string_view(format), args...);
+}
+
+/// Write a compact binary record of a printf format call instead of its text.
+/// @see encode_format
+template <typename FormatT, typename... Args>
+formatxx::result_code formatxx::encode_printf(format_writer& out, format_registry& registry, FormatT const& format, Args const&... args)
+{
+	return _detail::encode_binary(out, registry, _detail::binary_syntax::printf, make_string_view(format), args...);
+}
+
+#endif // !defined(_guard_FORMATXX_BINARY_H)
@@ -42,6 +42,8 @@ namespace formatxx
 		template <typename T>
 		struct new_delete_allocator
 		{
+			using value_type = T;
+
 			T* allocate(std::size_t count) { return new T[count]; }
 			void deallocate(T* ptr, std::size_t) { delete[] ptr; }
 		};
@@ -55,27 +57,58 @@ namespace formatxx
 } // namespace formatxx
 
 /// A writer with a fixed buffer that will allocate when the buffer is exhausted.
+/// AllocatorT provides T* allocate(count) and deallocate(T*, count) for CharT; any
+/// std-compatible allocator works, including formatxx::arena_allocator.
 template <typename CharT, std::size_t SizeN, typename AllocatorT>
 class formatxx::basic_buffered_writer : public basic_format_writer<CharT>, private AllocatorT
 {
 public:
-	basic_buffered_writer() = default;
+	/// A heap buffer handed off by release().
+	/// The owner must free it with deallocate(data, capacity) on an equivalent allocator.
+	struct released_buffer
+	{
+		CharT* data = nullptr;
+		std::size_t size = 0;
+		std::size_t capacity = 0;
+	};
+
+	basic_buffered_writer() { this->_terminated = true; this->_window = _buffer; this->_window_end = _buffer + SizeN - 1; }
+	explicit basic_buffered_writer(AllocatorT const& allocator) : AllocatorT(allocator) { this->_terminated = true; this->_window = _buffer; this->_window_end = _buffer + SizeN - 1; }
 	~basic_buffered_writer();
 
 	basic_buffered_writer(basic_buffered_writer const&) = delete;
 	basic_buffered_writer& operator=(basic_buffered_writer const&) = delete;
 
-	void write(basic_string_view<CharT> str) override;
+	basic_buffered_writer(basic_buffered_writer&& rhs);
+	basic_buffered_writer& operator=(basic_buffered_writer&& rhs);
+
+	void write(basic_string_view<CharT> str) final;
+	void write_stable(basic_string_view<CharT> str) final { write(str); }
+	void write_fill(CharT ch, std::size_t count) final;
+	CharT* reserve(std::size_t count) final { _grow(count); return this->_window; }
+	void commit(std::size_t count) final { this->_window += count; *this->_window = CharT(0); }
+
+	void clear() { this->_window = _first; *_first = CharT(0); }
+	std::size_t size() const { return this->_window - _first; }
+	CharT const* data() const { return _first; }
 
-	void clear() { _last = _first; }
-	std::size_t size() const { return _last - _first; }
 	CharT const* c_str() const { return _first; }
 
+	/// The number of characters that can be held before the writer must allocate.
+	std::size_t capacity() const { return _sentinel - _first - 1; }
+
+	/// Hand the formatted NUL-terminated string to the caller.
+	/// If the contents still live in the inline buffer they are first copied into an allocation.
+	/// The writer is left empty.
+	released_buffer release();
+
+	AllocatorT get_allocator() const { return *this; }
+
 private:
 	void _grow(std::size_t amount);
+	void _take(basic_buffered_writer& rhs);
 
 	CharT* _first = _buffer;
-	CharT* _last = _buffer;
 	CharT* _sentinel = _buffer + SizeN;
 	CharT _buffer[SizeN] = {CharT(0),};
 };
@@ -87,10 +120,85 @@ formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::~basic_buffered_write
 		this->deallocate(_first, _sentinel - _first);
 }
 
+template <typename CharT, std::size_t SizeN, typename AllocatorT>
+formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::basic_buffered_writer(basic_buffered_writer&& rhs) : AllocatorT(static_cast<AllocatorT&&>(rhs))
+{
+	_take(rhs);
+}
+
+template <typename CharT, std::size_t SizeN, typename AllocatorT>
+auto formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::operator=(basic_buffered_writer&& rhs) -> basic_buffered_writer&
+{
+	if (this != &rhs)
+	{
+		if (_first != _buffer)
+		{
+			this->deallocate(_first, _sentinel - _first);
+		}
+		static_cast<AllocatorT&>(*this) = static_cast<AllocatorT&&>(rhs);
+		_take(rhs);
+	}
+	return *this;
+}
+
+template <typename CharT, std::size_t SizeN, typename AllocatorT>
+void formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::_take(basic_buffered_writer& rhs)
+{
+	std::size_t const size = rhs._window - rhs._first;
+
+	if (rhs._first == rhs._buffer)
+	{
+		// inline contents must be copied
+		_first = _buffer;
+		_sentinel = _buffer + SizeN;
+		std::copy_n(rhs._buffer, size, _buffer);
+	}
+	else
+	{
+		// heap contents are stolen outright
+		_first = rhs._first;
+		_sentinel = rhs._sentinel;
+	}
+	this->_window = _first + size;
+	this->_window_end = _sentinel - 1;
+	*this->_window = CharT(0);
+
+	rhs._first = rhs._window = rhs._buffer;
+	rhs._sentinel = rhs._buffer + SizeN;
+	rhs._window_end = rhs._sentinel - 1;
+	*rhs._window = CharT(0);
+}
+
+template <typename CharT, std::size_t SizeN, typename AllocatorT>
+auto formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::release() -> released_buffer
+{
+	released_buffer result;
+	result.size = this->_window - _first;
+	*this->_window = CharT(0);
+
+	if (_first == _buffer)
+	{
+		result.capacity = result.size + 1;
+		result.data = this->allocate(result.capacity);
+		std::copy_n(_first, result.size + 1, result.data);
+	}
+	else
+	{
+		result.data = _first;
+		result.capacity = _sentinel - _first;
+	}
+
+	_first = this->_window = _buffer;
+	_sentinel = _buffer + SizeN;
+	this->_window_end = _sentinel - 1;
+	*this->_window = CharT(0);
+	return result;
+}
+
 template <typename CharT, std::size_t SizeN, typename AllocatorT>
 void formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::_grow(std::size_t amount)
 {
-	std::size_t const size = _last - _first;
+	std::size_t const size = this->_window - _first;
 	std::size_t const capacity = _sentinel - _first;
 	std::size_t const required = size + amount + 1;
 
@@ -101,15 +209,16 @@ void formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::_grow(std::size_
 		if (newCapacity < required) // ensure we get the space we asked for
 			newCapacity = required;
 
-		char* newBuffer = this->allocate(newCapacity);
-		std::copy_n(_first, size + 1, newBuffer);
+		CharT* newBuffer = this->allocate(newCapacity);
+		std::copy_n(_first, size, newBuffer);
 
 		if (_first != _buffer)
 			this->deallocate(_first, capacity);
 
 		_first = newBuffer;
-		_last = _first + size;
+		this->_window = _first + size;
 		_sentinel = _first + newCapacity;
+		this->_window_end = _sentinel - 1;
 	}
 }
 
@@ -117,9 +226,18 @@ template <typename CharT, std::size_t SizeN, typename AllocatorT>
 void formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::write(basic_string_view<CharT> str)
 {
 	_grow(str.size());
-	std::copy_n(str.data(), str.size(), _last);
-	_last += str.size();
-	*_last = CharT(0);
+	std::copy_n(str.data(), str.size(), this->_window);
+	this->_window += str.size();
+	*this->_window = CharT(0);
+}
+
+template <typename CharT, std::size_t SizeN, typename AllocatorT>
+void formatxx::basic_buffered_writer<CharT, SizeN, AllocatorT>::write_fill(CharT ch, std::size_t count)
+{
+	_grow(count);
+	std::fill_n(this->_window, count, ch);
+	this->_window += count;
+	*this->_window = CharT(0);
 }
 
 #endif // !defined(_guard_FORMATXX_BUFFERED_H)
@@ -0,0 +1,110 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_COMPILED_H)
+#define _guard_FORMATXX_COMPILED_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <vector>
+
+namespace formatxx
+{
+	using compiled_format = basic_compiled_format<char>;
+
+	/// Selects the syntax of a format string being compiled.
+	enum class format_syntax
+	{
+		format,
+		printf,
+	};
+
+	/// @internal
+	namespace _detail
+	{
+		/// A single pre-parsed piece of a compiled format string.
+		template <typename CharT>
+		struct compiled_segment
+		{
+			static constexpr unsigned literal_index = ~0U;
+
+			basic_string_view<CharT> text; // literal text, or the raw spec string for an argument
+			basic_format_spec<CharT> spec; // parsed spec for an argument
+			unsigned index = literal_index; // argument index, or literal_index for literal text
+		};
+
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API compile_format_impl(std::vector<compiled_segment<CharT>>& segments, basic_string_view<CharT> format, format_syntax syntax);
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API compiled_format_impl(basic_format_writer<CharT>& out, compiled_segment<CharT> const* segments, std::size_t count, basic_format_args<CharT> args);
+	}
+}
+
+/// A format string that has been parsed once and can be executed many times.
+/// The compiled format refers to the original format string's memory for literal text,
+/// so the format string must outlive the compiled format.
+template <typename CharT>
+class formatxx::basic_compiled_format
+{
+public:
+	basic_compiled_format() = default;
+	explicit basic_compiled_format(basic_string_view<CharT> format, format_syntax syntax = format_syntax::format)
+		: _result(_detail::compile_format_impl(_segments, format, syntax)) {}
+
+	/// Result of compilation; malformed formats still compile the parts that could be parsed.
+	result_code result() const { return _result; }
+
+	_detail::compiled_segment<CharT> const* segments() const { return _segments.data(); }
+	std::size_t size() const { return _segments.size(); }
+
+private:
+	std::vector<_detail::compiled_segment<CharT>> _segments;
+	result_code _result = result_code::success;
+};
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::compile_format_impl(std::vector<compiled_segment<char>>& segments, basic_string_view<char> format, format_syntax syntax);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::compiled_format_impl(basic_format_writer<char>& out, compiled_segment<char> const* segments, std::size_t count, basic_format_args<char> args);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::compile_format_impl(std::vector<compiled_segment<wchar_t>>& segments, basic_string_view<wchar_t> format, format_syntax syntax);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::compiled_format_impl(basic_format_writer<wchar_t>& out, compiled_segment<wchar_t> const* segments, std::size_t count, basic_format_args<wchar_t> args);
+
+/// Write a compiled format using the given parameters into a buffer.
+/// @param writer The write buffer that will receive the formatted text.
+/// @param format The compiled text and formatting controls to be written.
+/// @param args The arguments used by the formatting string.
+template <typename CharT, typename... Args>
+formatxx::result_code formatxx::format(basic_format_writer<CharT>& writer, basic_compiled_format<CharT> const& format, Args const&... args)
+{
+	basic_format_arg<CharT> const packed[sizeof...(args) + (sizeof...(args) == 0)] = {_detail::make_format_arg<CharT>(args)...};
+
+	result_code const result = _detail::compiled_format_impl(writer, format.segments(), format.size(), basic_format_args<CharT>(sizeof...(args), packed));
+	return format.result() != result_code::success ? format.result() : result;
+}
+
+#endif // !defined(_guard_FORMATXX_COMPILED_H)
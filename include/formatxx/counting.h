@@ -0,0 +1,94 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_COUNTING_H)
+#define _guard_FORMATXX_COUNTING_H
+#pragma once
+
+#include <formatxx/format.h>
+
+namespace formatxx
+{
+	template <typename CharT> class basic_counting_writer;
+
+	using counting_writer = basic_counting_writer<char>;
+
+	template <typename FormatT, typename... Args> std::size_t formatted_size(FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> std::size_t printf_formatted_size(FormatT const& format, Args const&... args);
+
+} // namespace formatxx
+
+/// A writer that only counts the characters written to it.
+/// Reservations are served from a small scratch area that is never read back,
+/// so formatting against it costs about the same as writing into a fixed buffer.
+template <typename CharT>
+class formatxx::basic_counting_writer : public basic_format_writer<CharT>
+{
+public:
+	void write(basic_string_view<CharT> str) override { _size += str.size(); }
+	void write_fill(CharT, std::size_t count) override { _size += count; }
+	CharT* reserve(std::size_t count) override { return count <= scratch_size ? _scratch : nullptr; }
+	void commit(std::size_t count) override { _size += count; }
+
+	void clear() { _size = 0; }
+	std::size_t size() const { return _size; }
+
+private:
+	static constexpr std::size_t scratch_size = 256;
+
+	std::size_t _size = 0;
+	CharT _scratch[scratch_size];
+};
+
+/// Calculate the length of the string format's output without writing it anywhere.
+/// @param format The primary text and formatting controls.
+/// @param args The arguments used by the formatting string.
+/// @returns the number of characters the format would produce.
+template <typename FormatT, typename... Args>
+std::size_t formatxx::formatted_size(FormatT const& format, Args const&... args)
+{
+	basic_counting_writer<typename _detail::format_char<FormatT>::type> counter;
+	formatxx::format(counter, format, args...);
+	return counter.size();
+}
+
+/// Calculate the length of the printf format's output without writing it anywhere.
+/// @param format The primary text and printf controls.
+/// @param args The arguments used by the formatting string.
+/// @returns the number of characters the format would produce.
+template <typename FormatT, typename... Args>
+std::size_t formatxx::printf_formatted_size(FormatT const& format, Args const&... args)
+{
+	basic_counting_writer<typename _detail::format_char<FormatT>::type> counter;
+	formatxx::printf(counter, format, args...);
+	return counter.size();
+}
+
+#endif // !defined(_guard_FORMATXX_COUNTING_H)
@@ -0,0 +1,319 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_DEFERRED_H)
+#define _guard_FORMATXX_DEFERRED_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // for std::memcpy
+#include <string>
+#include <type_traits>
+
+namespace formatxx
+{
+	/// The alignment required of buffers holding deferred records.
+	constexpr std::size_t deferred_alignment = alignof(std::max_align_t);
+
+	template <typename FormatT, typename... Args> std::size_t capture_format(void* buffer, std::size_t capacity, FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> std::size_t capture_printf(void* buffer, std::size_t capacity, FormatT const& format, Args const&... args);
+	template <typename CharT> result_code replay_format(basic_format_writer<CharT>& out, void* record);
+	inline std::size_t deferred_record_size(void const* record);
+
+	namespace _detail
+	{
+		enum class deferred_syntax : std::uint8_t { format, printf };
+
+		template <typename CharT>
+		struct deferred_header
+		{
+			std::uint32_t size; // must be first, see deferred_record_size
+			std::uint16_t count;
+			std::uint8_t char_size;
+			deferred_syntax syntax;
+			CharT const* format;
+			std::size_t format_size;
+		};
+
+		/// Record layout: header, args[count], offsets[count], then argument payloads.
+		/// Each argument's pointer is rebuilt from the offsets on every replay, so records may be moved freely.
+		template <typename CharT>
+		struct deferred_layout
+		{
+			static std::size_t align(std::size_t offset, std::size_t alignment) { return (offset + alignment - 1) & ~(alignment - 1); }
+
+			explicit deferred_layout(std::size_t count) :
+				args(align(sizeof(deferred_header<CharT>), alignof(basic_format_arg<CharT>))),
+				offsets(args + count * sizeof(basic_format_arg<CharT>)),
+				payload(offsets + count * sizeof(std::uint32_t)) {}
+
+			std::size_t args;
+			std::size_t offsets;
+			std::size_t payload;
+		};
+
+		template <typename C> struct is_deferred_char : std::integral_constant<bool,
+			std::is_same<C, char>::value || std::is_same<C, wchar_t>::value ||
+			std::is_same<C, char16_t>::value || std::is_same<C, char32_t>::value
+#if defined(__cpp_char8_t)
+			|| std::is_same<C, char8_t>::value
+#endif
+			> {};
+
+		/// A copied string: its length followed by the characters and a NUL.
+		template <typename C>
+		struct deferred_string
+		{
+			static constexpr std::size_t alignment = alignof(std::size_t);
+
+			static std::size_t size(basic_string_view<C> str) { return sizeof(std::size_t) + (str.size() + 1) * sizeof(C); }
+			static void store(unsigned char* dest, basic_string_view<C> str)
+			{
+				std::size_t const length = str.size();
+				std::memcpy(dest, &length, sizeof(length));
+				std::memcpy(dest + sizeof(length), str.data(), length * sizeof(C));
+				reinterpret_cast<C*>(dest + sizeof(length))[length] = C(0);
+			}
+
+			static std::size_t length(void const* ptr) { return *static_cast<std::size_t const*>(ptr); }
+			static C const* chars(void const* ptr) { return reinterpret_cast<C const*>(static_cast<unsigned char const*>(ptr) + sizeof(std::size_t)); }
+		};
+
+		template <typename CharT, typename C>
+		result_code FORMATXX_API deferred_zstring_thunk(basic_format_writer<CharT>& out, void const* ptr, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+		{
+			format_value_dispatch(out, deferred_string<C>::chars(ptr), spec_string, spec, has_spec_format_value<CharT, C const*>());
+			return result_code::success;
+		}
+
+		template <typename CharT, typename C>
+		result_code FORMATXX_API deferred_view_thunk(basic_format_writer<CharT>& out, void const* ptr, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+		{
+			basic_string_view<C> const view(deferred_string<C>::chars(ptr), deferred_string<C>::length(ptr));
+			format_value_dispatch(out, view, spec_string, spec, has_spec_format_value<CharT, basic_string_view<C>>());
+			return result_code::success;
+		}
+
+		/// How an argument of type T is captured. Values are copied bit for bit, so they must be
+		/// trivially copyable; character pointers, strings and byte spans are handled below by deep copy.
+		template <typename CharT, typename T, typename = void>
+		struct deferred_arg
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "deferred format arguments must be trivially copyable or strings");
+
+			static constexpr std::size_t alignment = alignof(T);
+			static std::size_t size(T const&) { return sizeof(T); }
+			static void store(unsigned char* dest, T const& value) { std::memcpy(dest, std::addressof(value), sizeof(T)); }
+			static typename basic_format_arg<CharT>::thunk_type thunk() { return &format_value_thunk<CharT, T>; }
+		};
+
+		template <typename CharT, typename C>
+		struct deferred_arg<CharT, C const*, typename std::enable_if<is_deferred_char<C>::value>::type>
+		{
+			static constexpr std::size_t alignment = deferred_string<C>::alignment;
+			static std::size_t size(C const* value) { return deferred_string<C>::size(value); }
+			static void store(unsigned char* dest, C const* value) { deferred_string<C>::store(dest, value); }
+			static typename basic_format_arg<CharT>::thunk_type thunk() { return &deferred_zstring_thunk<CharT, C>; }
+		};
+
+		template <typename CharT, typename C>
+		struct deferred_arg<CharT, C*, typename std::enable_if<is_deferred_char<C>::value>::type> : deferred_arg<CharT, C const*> {};
+
+		template <typename CharT, typename C>
+		struct deferred_arg<CharT, basic_string_view<C>, typename std::enable_if<is_deferred_char<C>::value>::type>
+		{
+			static constexpr std::size_t alignment = deferred_string<C>::alignment;
+			static std::size_t size(basic_string_view<C> value) { return deferred_string<C>::size(value); }
+			static void store(unsigned char* dest, basic_string_view<C> value) { deferred_string<C>::store(dest, value); }
+			static typename basic_format_arg<CharT>::thunk_type thunk() { return &deferred_view_thunk<CharT, C>; }
+		};
+
+		template <typename CharT, typename C, typename TraitsT, typename AllocatorT>
+		struct deferred_arg<CharT, std::basic_string<C, TraitsT, AllocatorT>, typename std::enable_if<is_deferred_char<C>::value>::type>
+		{
+			static constexpr std::size_t alignment = deferred_string<C>::alignment;
+			static std::size_t size(std::basic_string<C, TraitsT, AllocatorT> const& value) { return deferred_string<C>::size({value.c_str(), value.size()}); }
+			static void store(unsigned char* dest, std::basic_string<C, TraitsT, AllocatorT> const& value) { deferred_string<C>::store(dest, {value.c_str(), value.size()}); }
+			static typename basic_format_arg<CharT>::thunk_type thunk() { return &deferred_view_thunk<CharT, C>; }
+		};
+
+		template <typename CharT>
+		result_code FORMATXX_API deferred_bytes_thunk(basic_format_writer<CharT>& out, void const* ptr, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+		{
+			std::size_t size = 0;
+			std::memcpy(&size, ptr, sizeof(size));
+			hex_bytes const bytes(static_cast<unsigned char const*>(ptr) + sizeof(size), size);
+			format_value_dispatch(out, bytes, spec_string, spec, has_spec_format_value<CharT, hex_bytes>());
+			return result_code::success;
+		}
+
+		/// Byte spans only point at their data, so the bytes are copied after their count.
+		template <typename CharT>
+		struct deferred_arg<CharT, hex_bytes>
+		{
+			static constexpr std::size_t alignment = alignof(std::size_t);
+			static std::size_t size(hex_bytes value) { return sizeof(std::size_t) + value.size; }
+			static void store(unsigned char* dest, hex_bytes value)
+			{
+				std::memcpy(dest, &value.size, sizeof(value.size));
+				if (value.size != 0)
+				{
+					std::memcpy(dest + sizeof(value.size), value.data, value.size);
+				}
+			}
+			static typename basic_format_arg<CharT>::thunk_type thunk() { return &deferred_bytes_thunk<CharT>; }
+		};
+
+		template <typename CharT>
+		std::size_t measure_deferred(std::size_t offset) { return offset; }
+
+		template <typename CharT, typename T, typename... Rest>
+		std::size_t measure_deferred(std::size_t offset, T const& value, Rest const&... rest)
+		{
+			using arg = deferred_arg<CharT, T>;
+			std::size_t const alignment = arg::alignment;
+			return measure_deferred<CharT>(deferred_layout<CharT>::align(offset, alignment) + arg::size(value), rest...);
+		}
+
+		template <typename CharT>
+		void store_deferred(unsigned char*, deferred_layout<CharT> const&, std::size_t, std::size_t) {}
+
+		template <typename CharT, typename T, typename... Rest>
+		void store_deferred(unsigned char* record, deferred_layout<CharT> const& layout, std::size_t index, std::size_t offset, T const& value, Rest const&... rest)
+		{
+			using arg = deferred_arg<CharT, T>;
+			std::size_t const alignment = arg::alignment;
+			offset = deferred_layout<CharT>::align(offset, alignment);
+
+			basic_format_arg<CharT> const packed(arg::thunk(), nullptr);
+			std::uint32_t const stored_offset = static_cast<std::uint32_t>(offset);
+			std::memcpy(record + layout.args + index * sizeof(packed), &packed, sizeof(packed));
+			std::memcpy(record + layout.offsets + index * sizeof(std::uint32_t), &stored_offset, sizeof(stored_offset));
+			arg::store(record + offset, value);
+
+			store_deferred<CharT>(record, layout, index + 1, offset + arg::size(value), rest...);
+		}
+
+		template <typename CharT, typename... Args>
+		std::size_t capture_deferred(void* buffer, std::size_t capacity, deferred_syntax syntax, basic_string_view<CharT> format, Args const&... args)
+		{
+			deferred_layout<CharT> const layout(sizeof...(args));
+			std::size_t const size = deferred_layout<CharT>::align(measure_deferred<CharT>(layout.payload, args...), deferred_alignment);
+			if (size > capacity || size > UINT32_MAX)
+			{
+				return size;
+			}
+
+			unsigned char* const record = static_cast<unsigned char*>(buffer);
+
+			deferred_header<CharT> header;
+			header.size = static_cast<std::uint32_t>(size);
+			header.count = static_cast<std::uint16_t>(sizeof...(args));
+			header.char_size = sizeof(CharT);
+			header.syntax = syntax;
+			header.format = format.data();
+			header.format_size = format.size();
+			std::memcpy(record, &header, sizeof(header));
+
+			store_deferred<CharT>(record, layout, 0, layout.payload, args...);
+			return size;
+		}
+
+		template <typename FormatT>
+		struct is_deferred_format : std::integral_constant<bool, !std::is_class<FormatT>::value || std::is_same<typename std::remove_cv<FormatT>::type, basic_string_view<typename format_char<FormatT>::type>>::value> {};
+	}
+
+} // namespace formatxx
+
+/// Capture a string format call into a position-independent record for later replay.
+/// Arguments are copied by value (they must be trivially copyable) and strings and hex_bytes are deep-copied,
+/// but the format string itself is referenced and must outlive the record (e.g. a literal).
+/// @param buffer Storage aligned to deferred_alignment.
+/// @param capacity The size of buffer in bytes.
+/// @param format The primary text and formatting controls.
+/// @param args The arguments used by the formatting string.
+/// @returns the size of the record; nothing is written if that exceeds capacity.
+template <typename FormatT, typename... Args>
+std::size_t formatxx::capture_format(void* buffer, std::size_t capacity, FormatT const& format, Args const&... args)
+{
+	static_assert(sizeof...(args) <= UINT16_MAX, "too many deferred format arguments");
+	static_assert(_detail::is_deferred_format<FormatT>::value, "deferred format strings must be pointers, literals or string views");
+	return _detail::capture_deferred<typename _detail::format_char<FormatT>::type>(buffer, capacity, _detail::deferred_syntax::format, make_string_view(format), args...);
+}
+
+/// Capture a printf format call into a position-independent record for later replay.
+/// @see capture_format
+template <typename FormatT, typename... Args>
+std::size_t formatxx::capture_printf(void* buffer, std::size_t capacity, FormatT const& format, Args const&... args)
+{
+	static_assert(sizeof...(args) <= UINT16_MAX, "too many deferred format arguments");
+	static_assert(_detail::is_deferred_format<FormatT>::value, "deferred format strings must be pointers, literals or string views");
+	return _detail::capture_deferred<typename _detail::format_char<FormatT>::type>(buffer, capacity, _detail::deferred_syntax::printf, make_string_view(format), args...);
+}
+
+/// Format a captured record into a writer.
+/// The record may be replayed more than once, from any address aligned to deferred_alignment.
+/// @param out The write buffer that will receive the formatted text.
+/// @param record A record produced by capture_format or capture_printf with the same character type.
+template <typename CharT>
+formatxx::result_code formatxx::replay_format(basic_format_writer<CharT>& out, void* record)
+{
+	unsigned char* const bytes = static_cast<unsigned char*>(record);
+	_detail::deferred_header<CharT> header;
+	std::memcpy(&header, bytes, sizeof(header));
+	if (header.char_size != sizeof(CharT))
+	{
+		return result_code::malformed_input;
+	}
+
+	_detail::deferred_layout<CharT> const layout(header.count);
+	basic_format_arg<CharT>* const packed = reinterpret_cast<basic_format_arg<CharT>*>(bytes + layout.args);
+	std::uint32_t const* const offsets = reinterpret_cast<std::uint32_t const*>(bytes + layout.offsets);
+	for (std::size_t i = 0; i != header.count; ++i)
+	{
+		packed[i].value.custom.pointer = bytes + offsets[i];
+	}
+
+	basic_format_args<CharT> const args(header.count, packed);
+	basic_string_view<CharT> const format(header.format, header.format_size);
+	return header.syntax == _detail::deferred_syntax::printf ? _detail::printf_impl(out, format, args) : _detail::format_impl(out, format, args);
+}
+
+/// The size in bytes of a captured record, for walking buffers of consecutive records.
+std::size_t formatxx::deferred_record_size(void const* record)
+{
+	std::uint32_t size = 0;
+	std::memcpy(&size, record, sizeof(size));
+	return size;
+}
+
+#endif // !defined(_guard_FORMATXX_DEFERRED_H)
@@ -0,0 +1,222 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_FILE_H)
+#define _guard_FORMATXX_FILE_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <cstdio>
+#include <cstring> // for std::memcpy
+
+namespace formatxx
+{
+	/// When a basic_fd_writer hands its buffer to the operating system.
+	enum class flush_policy
+	{
+		/// Only when the buffer is full, on flush(), and on destruction.
+		when_full,
+		/// Additionally after any write containing a newline.
+		each_line,
+	};
+
+	template <typename CharT, std::size_t SizeN = 4096> class basic_fd_writer;
+
+	template <std::size_t SizeN = 4096> using fd_writer = basic_fd_writer<char, SizeN>;
+
+	namespace _detail
+	{
+		/// An output destination: a POSIX file descriptor, a C stream, or a Win32 HANDLE.
+		struct file_target
+		{
+			enum class kind { fd, file, handle };
+
+			kind type = kind::fd;
+			int fd = -1;
+			std::FILE* file = nullptr;
+			void* handle = nullptr;
+		};
+
+		/// Write all bytes, retrying partial writes and interruptions.
+		/// @returns false if the destination reported an error.
+		FORMATXX_PUBLIC bool FORMATXX_API write_file_target(file_target const& target, void const* data, std::size_t bytes);
+
+		/// Flush any buffering below the writer (the C stream's own buffer).
+		FORMATXX_PUBLIC bool FORMATXX_API flush_file_target(file_target const& target);
+	}
+
+} // namespace formatxx
+
+/// A writer that buffers SizeN characters and writes them to a file descriptor, FILE*, or HANDLE.
+/// Characters are written as raw code units. The destination is not closed by the writer.
+template <typename CharT, std::size_t SizeN>
+class formatxx::basic_fd_writer : public basic_format_writer<CharT>
+{
+public:
+	explicit basic_fd_writer(int fd, flush_policy policy = flush_policy::when_full) : _policy(policy) { _target.type = _detail::file_target::kind::fd; _target.fd = fd; }
+	explicit basic_fd_writer(std::FILE* file, flush_policy policy = flush_policy::when_full) : _policy(policy) { _target.type = _detail::file_target::kind::file; _target.file = file; }
+#if defined(_WIN32)
+	explicit basic_fd_writer(void* handle, flush_policy policy = flush_policy::when_full) : _policy(policy) { _target.type = _detail::file_target::kind::handle; _target.handle = handle; }
+#endif
+	~basic_fd_writer() { flush(); }
+
+	basic_fd_writer(basic_fd_writer const&) = delete;
+	basic_fd_writer& operator=(basic_fd_writer const&) = delete;
+
+	void write(basic_string_view<CharT> str) override;
+	void write_fill(CharT ch, std::size_t count) override;
+	CharT* reserve(std::size_t count) override;
+	void commit(std::size_t count) override;
+
+	/// Write out everything buffered so far.
+	/// @returns false if this or any earlier write failed.
+	bool flush();
+
+	/// The number of characters waiting in the buffer.
+	std::size_t buffered() const { return _used; }
+	bool failed() const { return _failed; }
+
+private:
+	void _drain();
+	void _send(CharT const* data, std::size_t count);
+	void _after_write(CharT const* data, std::size_t count);
+
+	_detail::file_target _target;
+	flush_policy _policy = flush_policy::when_full;
+	bool _failed = false;
+	std::size_t _used = 0;
+	CharT _buffer[SizeN];
+};
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::_send(CharT const* data, std::size_t count)
+{
+	if (count != 0 && !_detail::write_file_target(_target, data, count * sizeof(CharT)))
+	{
+		_failed = true;
+	}
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::_drain()
+{
+	_send(_buffer, _used);
+	_used = 0;
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::_after_write(CharT const* data, std::size_t count)
+{
+	if (_policy == flush_policy::each_line && std::char_traits<CharT>::find(data, count, CharT('\n')) != nullptr)
+	{
+		flush();
+	}
+}
+
+template <typename CharT, std::size_t SizeN>
+bool formatxx::basic_fd_writer<CharT, SizeN>::flush()
+{
+	_drain();
+	if (!_detail::flush_file_target(_target))
+	{
+		_failed = true;
+	}
+	return !_failed;
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::write(basic_string_view<CharT> str)
+{
+	if (str.size() > SizeN - _used)
+	{
+		_drain();
+
+		// large writes bypass the buffer entirely
+		if (str.size() >= SizeN)
+		{
+			_send(str.data(), str.size());
+			_after_write(str.data(), str.size());
+			return;
+		}
+	}
+
+	std::memcpy(_buffer + _used, str.data(), str.size() * sizeof(CharT));
+	_used += str.size();
+	_after_write(str.data(), str.size());
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::write_fill(CharT ch, std::size_t count)
+{
+	while (count != 0)
+	{
+		if (_used == SizeN)
+		{
+			_drain();
+		}
+
+		std::size_t const length = SizeN - _used < count ? SizeN - _used : count;
+		for (CharT* ptr = _buffer + _used, * const end = ptr + length; ptr != end; ++ptr)
+		{
+			*ptr = ch;
+		}
+		_used += length;
+		count -= length;
+	}
+
+	if (ch == CharT('\n') && _policy == flush_policy::each_line)
+	{
+		flush();
+	}
+}
+
+template <typename CharT, std::size_t SizeN>
+CharT* formatxx::basic_fd_writer<CharT, SizeN>::reserve(std::size_t count)
+{
+	if (count > SizeN)
+	{
+		return nullptr;
+	}
+	if (count > SizeN - _used)
+	{
+		_drain();
+	}
+	return _buffer + _used;
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fd_writer<CharT, SizeN>::commit(std::size_t count)
+{
+	CharT const* const written = _buffer + _used;
+	_used += count;
+	_after_write(written, count);
+}
+
+#endif // !defined(_guard_FORMATXX_FILE_H)
@@ -42,29 +42,65 @@ namespace formatxx
 }
 
 /// A writer with a fixed buffer that will never allocate.
+/// The free space is the writer's window, so the library's formatters fill it without virtual calls;
+/// the NUL terminator is kept after the contents on every write.
 template <typename CharT, std::size_t SizeN>
 class formatxx::basic_fixed_writer : public basic_format_writer<CharT>
 {
 public:
-	void write(basic_string_view<CharT> str) override;
+	basic_fixed_writer() { this->_terminated = true; _reset(0); }
+	basic_fixed_writer(basic_fixed_writer const& rhs) { this->_terminated = true; std::memcpy(_buffer, rhs._buffer, rhs.size() * sizeof(CharT)); _reset(rhs.size()); }
+	basic_fixed_writer& operator=(basic_fixed_writer const& rhs);
+
+	void write(basic_string_view<CharT> str) final;
+	void write_stable(basic_string_view<CharT> str) final { write(str); }
+	void write_fill(CharT ch, std::size_t count) final;
+	CharT* reserve(std::size_t count) final { return count <= static_cast<std::size_t>(this->_window_end - this->_window) ? this->_window : nullptr; }
+	void commit(std::size_t count) final { this->_window += count; *this->_window = CharT(0); }
+
+	void clear() { _reset(0); }
+	std::size_t size() const { return this->_window - _buffer; }
+	CharT const* data() const { return _buffer; }
 
-	void clear() { _last = _buffer; }
-	std::size_t size() const { return _last - _buffer; }
 	CharT const* c_str() const { return _buffer; }
 
 private:
-	CharT* _last = _buffer;
+	void _reset(std::size_t size) { this->_window = _buffer + size; this->_window_end = _buffer + SizeN - 1; *this->_window = CharT(0); }
+
 	CharT _buffer[SizeN] = {CharT(0),};
 };
 
+template <typename CharT, std::size_t SizeN>
+auto formatxx::basic_fixed_writer<CharT, SizeN>::operator=(basic_fixed_writer const& rhs) -> basic_fixed_writer&
+{
+	if (this != &rhs)
+	{
+		std::memcpy(_buffer, rhs._buffer, rhs.size() * sizeof(CharT));
+		_reset(rhs.size());
+	}
+	return *this;
+}
+
 template <typename CharT, std::size_t SizeN>
 void formatxx::basic_fixed_writer<CharT, SizeN>::write(basic_string_view<CharT> str)
 {
-	std::size_t const remaining = SizeN - size() - 1;
+	std::size_t const remaining = this->_window_end - this->_window;
 	std::size_t const length = remaining < str.size() ? remaining : str.size();
-	std::memcpy(_last, str.data(), length * sizeof(CharT));
-	_last += length;
-	*_last = CharT(0);
+	std::memcpy(this->_window, str.data(), length * sizeof(CharT));
+	this->_window += length;
+	*this->_window = CharT(0);
+}
+
+template <typename CharT, std::size_t SizeN>
+void formatxx::basic_fixed_writer<CharT, SizeN>::write_fill(CharT ch, std::size_t count)
+{
+	std::size_t const remaining = this->_window_end - this->_window;
+	std::size_t const length = remaining < count ? remaining : count;
+	for (CharT* const end = this->_window + length; this->_window != end; ++this->_window)
+	{
+		*this->_window = ch;
+	}
+	*this->_window = CharT(0);
 }
 
 #endif // !defined(_guard_FORMATXX_FIXED_H)
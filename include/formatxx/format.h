@@ -64,7 +64,11 @@ namespace formatxx
 	template <typename CharT, typename TraitsT = std::char_traits<CharT>> class basic_string_view;
 	template <typename CharT> class basic_format_writer;
 	template <typename CharT> class basic_format_spec;
+	template <typename CharT> class basic_format_arg;
 	template <typename CharT> class basic_format_args;
+	template <typename CharT> class basic_compiled_format;
+	template <typename CharT, typename HolderT> class basic_static_format;
+	class hex_bytes;
 
 	enum class result_code;
 	
@@ -74,11 +78,25 @@ namespace formatxx
 
 	template <typename CharT, typename FormatT, typename... Args> result_code format(basic_format_writer<CharT>& writer, FormatT const& format, Args const&... args);
 	template <typename CharT, typename FormatT, typename... Args> result_code printf(basic_format_writer<CharT>& writer, FormatT const& format, Args const&... args);
+	template <typename CharT, typename... Args> result_code format(basic_format_writer<CharT>& writer, basic_compiled_format<CharT> const& format, Args const&... args);
+	template <typename CharT, typename HolderT, typename... Args> result_code format(basic_format_writer<CharT>& writer, basic_static_format<CharT, HolderT> const& format, Args const&... args);
 
 	template <typename CharT> FORMATXX_PUBLIC basic_format_spec<CharT> FORMATXX_API parse_format_spec(basic_string_view<CharT> spec);
 
 	template <typename CharT> basic_string_view<CharT> make_string_view(basic_string_view<CharT> str) { return str; }
 	template <typename CharT> basic_string_view<CharT> make_string_view(CharT const* zstr) { return zstr; }
+	template <typename CharT, typename TraitsT, typename AllocatorT>
+	basic_string_view<CharT> make_string_view(std::basic_string<CharT, TraitsT, AllocatorT> const& str) { return {str.c_str(), str.size()}; }
+
+	namespace _detail
+	{
+		/// The character type of any accepted format string type.
+		template <typename FormatT> struct format_char { using type = typename std::remove_cv<typename std::remove_pointer<typename std::decay<FormatT>::type>::type>::type; };
+		template <typename CharT, typename TraitsT> struct format_char<basic_string_view<CharT, TraitsT>> { using type = CharT; };
+		template <typename CharT, typename TraitsT, typename AllocatorT> struct format_char<std::basic_string<CharT, TraitsT, AllocatorT>> { using type = CharT; };
+		template <typename CharT> struct format_char<basic_compiled_format<CharT>> { using type = CharT; };
+		template <typename CharT, typename HolderT> struct format_char<basic_static_format<CharT, HolderT>> { using type = CharT; };
+	}
 }
 
 enum class formatxx::result_code
@@ -121,6 +139,148 @@ public:
 	/// Write a string slice.
 	/// @param str The string to write.
 	virtual void write(basic_string_view<CharT> str) = 0;
+
+	/// Write a string slice that stays valid and unchanged for as long as the writer's output is in use,
+	/// such as format string literals and string arguments. Writers may keep a reference instead of copying.
+	/// @param str The string to write.
+	virtual void write_stable(basic_string_view<CharT> str) { write(str); }
+
+	/// Write a character repeatedly.
+	/// @param ch The character to write.
+	/// @param count The number of times to write the character.
+	virtual void write_fill(CharT ch, std::size_t count)
+	{
+		constexpr std::size_t chunk_size = 32;
+		CharT chunk[chunk_size];
+		for (std::size_t i = 0; i != chunk_size && i != count; ++i)
+		{
+			chunk[i] = ch;
+		}
+
+		while (count != 0)
+		{
+			std::size_t const length = count < chunk_size ? count : chunk_size;
+			write({chunk, length});
+			count -= length;
+		}
+	}
+
+	/// Reserve contiguous space to be written directly.
+	/// A successful reserve must be followed by a call to commit before any other writes.
+	/// @param count The number of characters to reserve.
+	/// @returns A pointer to space for count characters, or nullptr if the writer cannot provide it.
+	virtual CharT* reserve(std::size_t /*count*/) { return nullptr; }
+
+	/// Complete a write into space returned by reserve.
+	/// @param count The number of characters actually written, which may be less than reserved.
+	virtual void commit(std::size_t /*count*/) {}
+
+	// The put functions are the non-virtual front ends used by the library's formatters.
+	// They copy straight into the writer's window when it has room, and otherwise fall
+	// back to the matching virtual function.
+
+	/// Write a string slice, as write does.
+	void put(basic_string_view<CharT> str)
+	{
+		if (str.size() <= static_cast<std::size_t>(_window_end - _window))
+		{
+			_window = _put(_window, str);
+			_terminate();
+		}
+		else
+		{
+			write(str);
+		}
+	}
+
+	/// Write a stable string slice, as write_stable does.
+	void put_stable(basic_string_view<CharT> str)
+	{
+		if (str.size() <= static_cast<std::size_t>(_window_end - _window))
+		{
+			_window = _put(_window, str);
+			_terminate();
+		}
+		else
+		{
+			write_stable(str);
+		}
+	}
+
+	/// Write a character repeatedly, as write_fill does.
+	void put_fill(CharT ch, std::size_t count)
+	{
+		if (count <= static_cast<std::size_t>(_window_end - _window))
+		{
+			for (CharT* const end = _window + count; _window != end; ++_window)
+			{
+				*_window = ch;
+			}
+			_terminate();
+		}
+		else
+		{
+			write_fill(ch, count);
+		}
+	}
+
+	/// Reserve contiguous space, as reserve does; the space must be completed with put_commit.
+	CharT* put_reserve(std::size_t count) { return count <= static_cast<std::size_t>(_window_end - _window) ? _window : reserve(count); }
+
+	/// Complete a write into space returned by put_reserve.
+	void put_commit(CharT* reserved, std::size_t count)
+	{
+		if (reserved == _window)
+		{
+			_window += count;
+			_terminate();
+		}
+		else
+		{
+			commit(count);
+		}
+	}
+
+protected:
+	/// Free space that the put functions fill without a virtual call, as [_window, _window_end).
+	/// Writers that provide a window keep their write position in _window, and must also return
+	/// _window from reserve whenever they return space at all. Writers without one leave both null.
+	/// The put functions bypass write, write_stable, write_fill, reserve and commit when the write
+	/// fits, so a writer with a window declares those final.
+	CharT* _window = nullptr;
+	CharT* _window_end = nullptr;
+
+	/// Set by writers that keep a NUL terminator at _window, so the put functions write one too.
+	/// Such writers must leave room for it at _window_end.
+	bool _terminated = false;
+
+	void _terminate()
+	{
+		if (_terminated)
+		{
+			*_window = CharT(0);
+		}
+	}
+
+private:
+	static CharT* _put(CharT* dest, basic_string_view<CharT> str)
+	{
+		return str.empty() ? dest : std::char_traits<CharT>::copy(dest, str.data(), str.size()) + str.size();
+	}
+};
+
+/// A span of raw bytes, formatted as two hexadecimal digits per byte.
+/// The spec code x (default) or X selects the case, the space flag separates
+/// bytes with a space, and the width breaks lines after that many bytes,
+/// e.g. "{:X}", "{: }" or "{: 16}".
+class formatxx::hex_bytes
+{
+public:
+	constexpr hex_bytes() = default;
+	constexpr hex_bytes(void const* bytes, std::size_t count) : data(bytes), size(count) {}
+
+	void const* data = nullptr;
+	std::size_t size = 0;
 };
 
 /// Extra formatting specifications.
@@ -132,6 +292,8 @@ public:
 	unsigned width = 0;
 	unsigned precision = 0;
 	CharT code = 0;
+	/// Separator between groups of three digits in decimal numbers, or 0 for none.
+	CharT grouping = 0;
 	bool has_precision = false;
 	bool left_justify = false;
 	bool prepend_sign = false;
@@ -140,25 +302,119 @@ public:
 	bool leading_zeroes = false;
 };
 
+/// A single format argument.
+/// Library-formatted primitives are stored by value with a tag saying which type they are,
+/// and are formatted by a switch in the compiled library. Other types are stored by address
+/// with a thunk that calls their format_value.
+template <typename CharT>
+class formatxx::basic_format_arg
+{
+public:
+	using thunk_type = result_code(FORMATXX_API *)(basic_format_writer<CharT>&, void const*, basic_string_view<CharT>, basic_format_spec<CharT> const*);
+
+	enum class type : unsigned char
+	{
+		custom,
+		boolean,
+		character,
+		signed_char,
+		signed_short,
+		signed_int,
+		signed_long,
+		signed_long_long,
+		unsigned_char,
+		unsigned_short,
+		unsigned_int,
+		unsigned_long,
+		unsigned_long_long,
+		single_float,
+		double_float,
+		zstring,
+		string,
+		pointer,
+		bytes,
+	};
+
+	basic_format_arg() : kind(type::custom) { value.custom = {nullptr, nullptr}; }
+	basic_format_arg(thunk_type thunk, void const* pointer) : kind(type::custom) { value.custom = {thunk, pointer}; }
+
+	explicit basic_format_arg(bool arg) : kind(type::boolean) { value.boolean = arg; }
+	explicit basic_format_arg(CharT arg) : kind(type::character) { value.character = arg; }
+	explicit basic_format_arg(signed char arg) : kind(type::signed_char) { value.signed_integer = arg; }
+	explicit basic_format_arg(signed short arg) : kind(type::signed_short) { value.signed_integer = arg; }
+	explicit basic_format_arg(signed int arg) : kind(type::signed_int) { value.signed_integer = arg; }
+	explicit basic_format_arg(signed long arg) : kind(type::signed_long) { value.signed_integer = arg; }
+	explicit basic_format_arg(signed long long arg) : kind(type::signed_long_long) { value.signed_integer = arg; }
+	explicit basic_format_arg(unsigned char arg) : kind(type::unsigned_char) { value.unsigned_integer = arg; }
+	explicit basic_format_arg(unsigned short arg) : kind(type::unsigned_short) { value.unsigned_integer = arg; }
+	explicit basic_format_arg(unsigned int arg) : kind(type::unsigned_int) { value.unsigned_integer = arg; }
+	explicit basic_format_arg(unsigned long arg) : kind(type::unsigned_long) { value.unsigned_integer = arg; }
+	explicit basic_format_arg(unsigned long long arg) : kind(type::unsigned_long_long) { value.unsigned_integer = arg; }
+	explicit basic_format_arg(float arg) : kind(type::single_float) { value.single_float = arg; }
+	explicit basic_format_arg(double arg) : kind(type::double_float) { value.double_float = arg; }
+	explicit basic_format_arg(CharT const* arg) : kind(type::zstring) { value.zstring = arg; }
+	explicit basic_format_arg(basic_string_view<CharT> arg) : kind(type::string) { value.string = {arg.data(), arg.size()}; }
+	explicit basic_format_arg(void const* arg) : kind(type::pointer) { value.pointer = arg; }
+	explicit basic_format_arg(hex_bytes arg) : kind(type::bytes) { value.bytes = {arg.data, arg.size}; }
+
+	type kind;
+	union
+	{
+		bool boolean;
+		CharT character;
+		signed long long signed_integer;
+		unsigned long long unsigned_integer;
+		float single_float;
+		double double_float;
+		CharT const* zstring;
+		struct { CharT const* data; std::size_t size; } string;
+		void const* pointer;
+		struct { void const* data; std::size_t size; } bytes;
+		struct { thunk_type thunk; void const* pointer; } custom;
+	} value;
+};
+
+namespace formatxx
+{
+	namespace _detail
+	{
+		/// Formats any argument that is not type::custom.
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API format_builtin_arg(basic_format_writer<CharT>& out, basic_format_arg<CharT> const& arg, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec);
+	}
+}
+
 /// Abstraction for a set of format arguments.
 template <typename CharT>
 class formatxx::basic_format_args
 {
 public:
-	using thunk_type = result_code(FORMATXX_API *)(basic_format_writer<CharT>&, void const*, basic_string_view<CharT>);
+	using thunk_type = typename basic_format_arg<CharT>::thunk_type;
 	using size_type = std::size_t;
 
 	basic_format_args() = default;
-	explicit basic_format_args(size_type count, thunk_type const* thunks, void const* const* args) : _thunks(thunks), _args(args), _count(count) {}
+	explicit basic_format_args(size_type count, basic_format_arg<CharT> const* args) : _args(args), _count(count) {}
 
-	result_code format_arg(basic_format_writer<CharT>& output, size_type index, basic_string_view<CharT> spec) const
+	/// Format an argument.
+	/// @param spec_string The raw format specification for the argument.
+	/// @param spec The parsed spec_string, if the caller has already parsed it, or nullptr.
+	result_code format_arg(basic_format_writer<CharT>& output, size_type index, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec = nullptr) const
 	{
-		return index < _count ? _thunks[index](output, _args[index], spec) : result_code::out_of_range;
+		if (index >= _count)
+		{
+			return result_code::out_of_range;
+		}
+
+		basic_format_arg<CharT> const& arg = _args[index];
+		if (arg.kind == basic_format_arg<CharT>::type::custom)
+		{
+			return arg.value.custom.thunk(output, arg.value.custom.pointer, spec_string, spec);
+		}
+		return _detail::format_builtin_arg(output, arg, spec_string, spec);
 	}
 
 private:
-	thunk_type const* _thunks = nullptr;
-	void const* const* _args = nullptr;
+	basic_format_arg<CharT> const* _args = nullptr;
 	size_type _count = 0;
 };
 
@@ -184,6 +440,29 @@ namespace formatxx
 	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long long value, string_view spec);
 	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void* value, string_view spec);
 	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void const* value, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, hex_bytes bytes, string_view spec);
+
+	/// Default format helpers for pre-parsed format specifications.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char const* zstr, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char* zstr, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, string_view str, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char ch, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, bool value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, float value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, double value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed char value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed int value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed short value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long long value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned char value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned int value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned short value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long long value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void* value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void const* value, format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, hex_bytes bytes, format_spec const& spec);
 
 	/// Formatting for enumerations, using their numeric value.
 	template <typename CharT, typename EnumT>
@@ -201,13 +480,71 @@ namespace formatxx
 	/// @internal
 	namespace _detail
 	{
+		/// Determines if T is one of the integer types with a library-provided format_value.
+		template <typename T>
+		struct is_format_integer : std::integral_constant<bool,
+			std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value ||
+			std::is_same<T, signed short>::value || std::is_same<T, unsigned short>::value ||
+			std::is_same<T, signed int>::value || std::is_same<T, unsigned int>::value ||
+			std::is_same<T, signed long>::value || std::is_same<T, unsigned long>::value ||
+			std::is_same<T, signed long long>::value || std::is_same<T, unsigned long long>::value> {};
+
+		/// Determines if the library provides a format_value for T that accepts a pre-parsed spec.
+		template <typename CharT, typename T>
+		struct has_spec_format_value : std::integral_constant<bool,
+			is_format_integer<T>::value ||
+			std::is_same<T, CharT>::value ||
+			std::is_same<T, bool>::value ||
+			std::is_same<T, float>::value ||
+			std::is_same<T, double>::value ||
+			std::is_same<T, CharT const*>::value ||
+			std::is_same<T, CharT*>::value ||
+			std::is_same<typename std::remove_cv<typename std::remove_extent<T>::type>::type, CharT>::value ||
+			std::is_same<T, basic_string_view<CharT>>::value ||
+			std::is_same<T, void*>::value ||
+			std::is_same<T, void const*>::value ||
+			std::is_same<T, hex_bytes>::value> {};
+
 		template <typename CharT, typename T>
-		result_code FORMATXX_API format_value_thunk(basic_format_writer<CharT>& out, void const* ptr, basic_string_view<CharT> spec)
+		void format_value_dispatch(basic_format_writer<CharT>& out, T const& value, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec, std::true_type)
 		{
-			format_value(out, *static_cast<T const*>(ptr), spec);
+			if (spec != nullptr)
+			{
+				format_value(out, value, *spec);
+			}
+			else
+			{
+				format_value(out, value, spec_string);
+			}
+		}
+
+		template <typename CharT, typename T>
+		void format_value_dispatch(basic_format_writer<CharT>& out, T const& value, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const*, std::false_type)
+		{
+			format_value(out, value, spec_string);
+		}
+
+		template <typename CharT, typename T>
+		result_code FORMATXX_API format_value_thunk(basic_format_writer<CharT>& out, void const* ptr, basic_string_view<CharT> spec_string, basic_format_spec<CharT> const* spec)
+		{
+			format_value_dispatch(out, *static_cast<T const*>(ptr), spec_string, spec, has_spec_format_value<CharT, T>());
 			return result_code::success;
 		}
 
+		template <typename CharT, typename T>
+		basic_format_arg<CharT> make_format_arg(T const& value, std::true_type /*builtin*/) { return basic_format_arg<CharT>(value); }
+
+		template <typename CharT, typename T>
+		basic_format_arg<CharT> make_format_arg(T const& value, std::false_type /*builtin*/) { return basic_format_arg<CharT>(&format_value_thunk<CharT, T>, std::addressof(value)); }
+
+		/// Packs an argument: the types with library-provided spec formatters are stored by value.
+		template <typename CharT, typename T>
+		basic_format_arg<CharT> make_format_arg(T const& value) { return make_format_arg<CharT>(value, has_spec_format_value<CharT, T>()); }
+
+		/// Strings of the output character type are packed as string views, so they need no thunk.
+		template <typename CharT, typename TraitsT, typename AllocatorT>
+		basic_format_arg<CharT> make_format_arg(std::basic_string<CharT, TraitsT, AllocatorT> const& value) { return basic_format_arg<CharT>(basic_string_view<CharT>(value.c_str(), value.size())); }
+
 		template <typename CharT>
 		FORMATXX_PUBLIC result_code FORMATXX_API format_impl(basic_format_writer<CharT>& out, basic_string_view<CharT> format, basic_format_args<CharT> args);
 		template <typename CharT>
@@ -215,6 +552,7 @@ namespace formatxx
 	}
 }
 
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_builtin_arg(basic_format_writer<char>& out, basic_format_arg<char> const& arg, basic_string_view<char> spec_string, basic_format_spec<char> const* spec);
 extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_impl(basic_format_writer<char>& out, basic_string_view<char> format, basic_format_args<char> args);
 extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::printf_impl(basic_format_writer<char>& out, basic_string_view<char> format, basic_format_args<char> args);	
 extern template FORMATXX_PUBLIC formatxx::basic_format_spec<char> FORMATXX_API formatxx::parse_format_spec(basic_string_view<char> spec);
@@ -226,10 +564,9 @@ extern template FORMATXX_PUBLIC formatxx::basic_format_spec<char> FORMATXX_API f
 template <typename CharT, typename FormatT, typename... Args>
 formatxx::result_code formatxx::format(basic_format_writer<CharT>& writer, FormatT const& format, Args const&... args)
 {
-	void const* const values[] = {std::addressof(args)..., nullptr};
-	typename basic_format_args<CharT>::thunk_type const funcs[] = {&_detail::format_value_thunk<CharT, Args>..., nullptr};
+	basic_format_arg<CharT> const packed[sizeof...(args) + (sizeof...(args) == 0)] = {_detail::make_format_arg<CharT>(args)...};
 
-	return _detail::format_impl(writer, make_string_view(format), basic_format_args<CharT>(sizeof...(args), funcs, values));
+	return _detail::format_impl(writer, make_string_view(format), basic_format_args<CharT>(sizeof...(args), packed));
 }
 
 /// Write the printf format using the given parameters into a buffer.
@@ -239,10 +576,9 @@ formatxx::result_code formatxx::format(basic_format_writer<CharT>& writer, Forma
 template <typename CharT, typename FormatT, typename... Args>
 formatxx::result_code formatxx::printf(basic_format_writer<CharT>& writer, FormatT const& format, Args const&... args)
 {
-	void const* const values[] = {std::addressof(args)..., nullptr};
-	typename basic_format_args<CharT>::thunk_type const funcs[] = {&_detail::format_value_thunk<CharT, Args>..., nullptr};
+	basic_format_arg<CharT> const packed[sizeof...(args) + (sizeof...(args) == 0)] = {_detail::make_format_arg<CharT>(args)...};
 
-	return _detail::printf_impl(writer, make_string_view(format), basic_format_args<CharT>(sizeof...(args), funcs, values));
+	return _detail::printf_impl(writer, make_string_view(format), basic_format_args<CharT>(sizeof...(args), packed));
 }
 
 #endif // !defined(_guard_FORMATXX_H)
@@ -0,0 +1,83 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_INSTRUMENT_H)
+#define _guard_FORMATXX_INSTRUMENT_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace formatxx
+{
+	struct format_site_stats;
+
+	/// Start recording statistics for every format and printf call.
+	/// Only has an effect when the library is built with FORMATXX_INSTRUMENT.
+	/// @param ticks Also time each call, in CPU timestamp ticks where available or nanoseconds otherwise.
+	/// @returns false if the library was built without instrumentation.
+	FORMATXX_PUBLIC bool FORMATXX_API enable_instrumentation(bool ticks = false);
+
+	/// Stop recording statistics; those already recorded are kept.
+	FORMATXX_PUBLIC void FORMATXX_API disable_instrumentation();
+
+	/// Discard all recorded statistics.
+	/// Calls that are in progress on other threads may still be counted.
+	FORMATXX_PUBLIC void FORMATXX_API reset_instrumentation();
+
+	/// Collect the statistics of every thread, one entry per format string, busiest first.
+	FORMATXX_PUBLIC void FORMATXX_API instrumentation_snapshot(std::vector<format_site_stats>& stats);
+
+	/// Write the snapshot as a text table.
+	FORMATXX_PUBLIC void FORMATXX_API dump_instrumentation(format_writer& out);
+
+} // namespace formatxx
+
+/// Totals for one format string, keyed by the address of its text.
+/// Strings at the same address are one site, so literals identify their call sites.
+struct formatxx::format_site_stats
+{
+	/// The address of the format string; nullptr collects sites that did not fit a thread's table.
+	void const* site = nullptr;
+	/// The start of the format string, converted to UTF-8.
+	std::string format;
+	std::uint64_t calls = 0;
+	std::uint64_t bytes = 0;
+	/// The number of write, write_stable, write_fill and commit calls made on the writer.
+	std::uint64_t writes = 0;
+	std::uint64_t out_of_range = 0;
+	std::uint64_t malformed = 0;
+	/// Zero unless enable_instrumentation was given ticks.
+	std::uint64_t ticks = 0;
+};
+
+#endif // !defined(_guard_FORMATXX_INSTRUMENT_H)
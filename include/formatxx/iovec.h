@@ -0,0 +1,189 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_IOVEC_H)
+#define _guard_FORMATXX_IOVEC_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <formatxx/arena.h>
+#include <cstring> // for std::memcpy
+#include <vector>
+
+#if !defined(_WIN32)
+#	include <sys/uio.h>
+#endif
+
+namespace formatxx
+{
+#if !defined(_WIN32)
+	using iovec = ::iovec;
+#else
+	/// Layout-compatible with POSIX struct iovec.
+	struct iovec
+	{
+		void* iov_base;
+		std::size_t iov_len;
+	};
+#endif
+
+	template <std::size_t SizeN = 1024> class iovec_writer;
+
+} // namespace formatxx
+
+/// A writer that produces a scatter-gather list for writev or sendmsg.
+/// Stable spans (format string literals and string arguments) are referenced rather than copied,
+/// as long as they are at least the reference threshold long; everything else, such as rendered
+/// numbers and padding, is copied into an internal arena with SizeN bytes of inline storage.
+/// The format string and string arguments must outlive the use of the iovec array, so avoid
+/// formatting temporaries such as a std::string returned by value.
+template <std::size_t SizeN>
+class formatxx::iovec_writer : public format_writer
+{
+public:
+	/// @param min_reference Stable spans shorter than this are copied, to keep the iovec count down.
+	explicit iovec_writer(std::size_t min_reference = 64) : _min_reference(min_reference != 0 ? min_reference : 1) {}
+
+	iovec_writer(iovec_writer const&) = delete;
+	iovec_writer& operator=(iovec_writer const&) = delete;
+
+	void write(string_view str) override;
+	void write_stable(string_view str) override;
+	void write_fill(char ch, std::size_t count) override;
+	char* reserve(std::size_t count) override { return _tail_space(count); }
+	void commit(std::size_t count) override { _append_tail(count); }
+
+	void clear();
+
+	/// The scatter-gather list, valid until the next write or clear.
+	iovec const* data() const { return _segments.data(); }
+	/// The number of entries in the scatter-gather list.
+	std::size_t count() const { return _segments.size(); }
+	/// The total number of bytes described by the list.
+	std::size_t size() const { return _size; }
+
+private:
+	static constexpr std::size_t block_size = 256;
+
+	char* _tail_space(std::size_t count);
+	void _append_tail(std::size_t count);
+
+	std::vector<iovec> _segments;
+	monotonic_arena<SizeN> _arena;
+	char* _tail = nullptr;
+	char* _tail_end = nullptr;
+	bool _tail_open = false; // whether the last segment ends at _tail and can be extended
+	std::size_t _size = 0;
+	std::size_t _min_reference = 64;
+};
+
+template <std::size_t SizeN>
+char* formatxx::iovec_writer<SizeN>::_tail_space(std::size_t count)
+{
+	if (count > static_cast<std::size_t>(_tail_end - _tail))
+	{
+		std::size_t const capacity = count > block_size ? count : block_size;
+		_tail = static_cast<char*>(_arena.allocate(capacity, 1));
+		_tail_end = _tail + capacity;
+		_tail_open = false;
+	}
+	return _tail;
+}
+
+template <std::size_t SizeN>
+void formatxx::iovec_writer<SizeN>::_append_tail(std::size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (_tail_open)
+	{
+		_segments.back().iov_len += count;
+	}
+	else
+	{
+		_segments.push_back({_tail, count});
+		_tail_open = true;
+	}
+	_tail += count;
+	_size += count;
+}
+
+template <std::size_t SizeN>
+void formatxx::iovec_writer<SizeN>::write(string_view str)
+{
+	if (str.empty())
+	{
+		return;
+	}
+
+	std::memcpy(_tail_space(str.size()), str.data(), str.size());
+	_append_tail(str.size());
+}
+
+template <std::size_t SizeN>
+void formatxx::iovec_writer<SizeN>::write_stable(string_view str)
+{
+	if (str.size() < _min_reference)
+	{
+		write(str);
+		return;
+	}
+
+	_segments.push_back({const_cast<char*>(str.data()), str.size()});
+	_tail_open = false;
+	_size += str.size();
+}
+
+template <std::size_t SizeN>
+void formatxx::iovec_writer<SizeN>::write_fill(char ch, std::size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	std::memset(_tail_space(count), ch, count);
+	_append_tail(count);
+}
+
+template <std::size_t SizeN>
+void formatxx::iovec_writer<SizeN>::clear()
+{
+	_segments.clear();
+	_arena.reset();
+	_tail = _tail_end = nullptr;
+	_tail_open = false;
+	_size = 0;
+}
+
+#endif // !defined(_guard_FORMATXX_IOVEC_H)
@@ -0,0 +1,203 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_LOG_SINK_H)
+#define _guard_FORMATXX_LOG_SINK_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <formatxx/file.h>
+#include <formatxx/deferred.h>
+#include <formatxx/wide.h> // string.h depends on it
+#include <formatxx/string.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace formatxx
+{
+	class log_sink;
+
+	/// What a log_sink producer does when the ring is full.
+	enum class overflow_policy
+	{
+		/// Wait for the flusher to make room.
+		block,
+		/// Discard the record and count it in dropped().
+		drop,
+	};
+
+} // namespace formatxx
+
+/// A multi-producer log back-end.
+/// Records are either formatted by the calling thread (format, printf) or captured with
+/// capture_format and rendered by the background thread (defer, defer_printf).
+/// Each thread formats a complete record into its own scratch buffer, then copies it into a
+/// lock-free ring of fixed-size slots. A background thread drains the ring into a buffered
+/// fd_writer. Records occupy consecutive slots, so they are never interleaved, except records
+/// larger than the entire ring, which are submitted in pieces.
+class FORMATXX_PUBLIC formatxx::log_sink
+{
+public:
+	/// @param capacity The number of ring slots, rounded up to a power of two.
+	explicit log_sink(int fd, std::size_t capacity = 1024, overflow_policy overflow = overflow_policy::block);
+	explicit log_sink(std::FILE* file, std::size_t capacity = 1024, overflow_policy overflow = overflow_policy::block);
+	~log_sink();
+
+	log_sink(log_sink const&) = delete;
+	log_sink& operator=(log_sink const&) = delete;
+
+	template <typename FormatT, typename... Args> result_code format(FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> result_code printf(FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> bool defer(FormatT const& format, Args const&... args);
+	template <typename FormatT, typename... Args> bool defer_printf(FormatT const& format, Args const&... args);
+
+	/// Queue an already formatted record.
+	/// @returns false if the record was dropped because the ring was full.
+	bool submit(string_view record);
+
+	/// Block until every record submitted before the call has been written out.
+	void flush();
+
+	/// The number of records discarded under overflow_policy::drop.
+	std::size_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+	/// The bytes carried per ring slot.
+	static constexpr std::size_t slot_payload = 112;
+
+private:
+	struct slot
+	{
+		std::atomic<std::size_t> sequence;
+		std::uint32_t length;
+		std::uint32_t deferred; // nonzero on the first slot of a captured record
+		char data[slot_payload];
+	};
+
+	/// Per-thread storage for capturing deferred records.
+	static void* _capture_buffer(std::size_t size);
+
+	void _start(std::size_t capacity);
+	bool _enqueue(char const* data, std::size_t size, bool deferred);
+	void _consume(slot const& source);
+	void _run();
+
+	basic_fd_writer<char, 64 * 1024> _out;
+	overflow_policy _overflow = overflow_policy::block;
+	std::unique_ptr<slot[]> _slots;
+	std::size_t _mask = 0;
+
+	std::atomic<std::size_t> _enqueue_pos;
+	std::atomic<std::size_t> _flushed_pos;
+	std::atomic<std::size_t> _dropped;
+	std::atomic<bool> _waiting;
+	std::atomic<bool> _stop;
+	std::size_t _dequeue_pos = 0; // owned by the flusher thread
+
+	// a deferred record being reassembled by the flusher thread
+	std::unique_ptr<std::max_align_t[]> _record;
+	std::size_t _record_capacity = 0;
+	std::size_t _record_size = 0;
+	std::size_t _record_pending = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::condition_variable _flushed;
+	std::thread _thread;
+};
+
+/// Format a record with the string format and queue it.
+/// @param format The primary text and formatting controls to be written.
+/// @param args The arguments used by the formatting string.
+template <typename FormatT, typename... Args>
+formatxx::result_code formatxx::log_sink::format(FormatT const& format, Args const&... args)
+{
+	_detail::scratch_writer<char> scratch;
+	if (auto* const writer = scratch.get())
+	{
+		result_code const result = formatxx::format(*writer, format, args...);
+		submit({writer->c_str(), writer->size()});
+		return result;
+	}
+
+	buffered_writer<256> local;
+	result_code const result = formatxx::format(local, format, args...);
+	submit({local.c_str(), local.size()});
+	return result;
+}
+
+/// Format a record with the printf format and queue it.
+/// @param format The primary text and printf controls to be written.
+/// @param args The arguments used by the formatting string.
+template <typename FormatT, typename... Args>
+formatxx::result_code formatxx::log_sink::printf(FormatT const& format, Args const&... args)
+{
+	_detail::scratch_writer<char> scratch;
+	if (auto* const writer = scratch.get())
+	{
+		result_code const result = formatxx::printf(*writer, format, args...);
+		submit({writer->c_str(), writer->size()});
+		return result;
+	}
+
+	buffered_writer<256> local;
+	result_code const result = formatxx::printf(local, format, args...);
+	submit({local.c_str(), local.size()});
+	return result;
+}
+
+/// Capture a string format call and queue it to be formatted by the background thread.
+/// Arguments follow the rules of capture_format: values are copied, strings deep-copied,
+/// and the format string must outlive the sink.
+/// @returns false if the record was dropped because the ring was full.
+template <typename FormatT, typename... Args>
+bool formatxx::log_sink::defer(FormatT const& format, Args const&... args)
+{
+	std::size_t const size = capture_format(nullptr, 0, format, args...);
+	void* const buffer = _capture_buffer(size);
+	capture_format(buffer, size, format, args...);
+	return _enqueue(static_cast<char const*>(buffer), size, true);
+}
+
+/// Capture a printf format call and queue it to be formatted by the background thread.
+/// @see defer
+template <typename FormatT, typename... Args>
+bool formatxx::log_sink::defer_printf(FormatT const& format, Args const&... args)
+{
+	std::size_t const size = capture_printf(nullptr, 0, format, args...);
+	void* const buffer = _capture_buffer(size);
+	capture_printf(buffer, size, format, args...);
+	return _enqueue(static_cast<char const*>(buffer), size, true);
+}
+
+#endif // !defined(_guard_FORMATXX_LOG_SINK_H)
@@ -0,0 +1,190 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+
+#if !defined(_guard_FORMATXX_MMAP_H)
+#define _guard_FORMATXX_MMAP_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <cstring> // for std::memcpy
+
+namespace formatxx
+{
+	template <typename CharT> class basic_mmap_writer;
+
+	using mmap_writer = basic_mmap_writer<char>;
+
+	namespace _detail
+	{
+		/// A file mapped into memory from its start: a POSIX file descriptor, or a Win32 HANDLE.
+		struct mapped_file
+		{
+			int fd = -1;
+			void* handle = nullptr;
+			void* mapping = nullptr; // the Win32 file mapping object
+			void* data = nullptr;
+			std::size_t bytes = 0;
+		};
+
+		/// Resize the file to bytes and map all of it, replacing any current view.
+		/// @returns false if the file could not be resized or mapped, leaving nothing mapped.
+		FORMATXX_PUBLIC bool FORMATXX_API remap_file(mapped_file& file, std::size_t bytes);
+
+		/// Unmap the view and truncate the file to bytes.
+		/// @returns false if the file could not be truncated.
+		FORMATXX_PUBLIC bool FORMATXX_API unmap_file(mapped_file& file, std::size_t bytes);
+	}
+
+} // namespace formatxx
+
+/// A writer that formats directly into a memory-mapped file, for very large outputs.
+/// Output starts at the beginning of the file. The mapping grows by whole steps as it fills,
+/// so growing never copies the output, and close() truncates the file to the characters written.
+/// Characters are written as raw code units. The file descriptor or handle is not closed by the writer.
+template <typename CharT>
+class formatxx::basic_mmap_writer : public basic_format_writer<CharT>
+{
+public:
+	/// The default mapping growth, in bytes.
+	static constexpr std::size_t default_step = std::size_t(64) << 20;
+
+	/// @param fd A file descriptor opened for reading and writing (O_RDWR); a shared writable
+	///           mapping can't be made from a read-only or write-only descriptor, so every write fails.
+	/// @param step How many bytes to grow the file and mapping by each time it fills.
+	explicit basic_mmap_writer(int fd, std::size_t step = default_step) : _step(step) { _file.fd = fd; }
+#if defined(_WIN32)
+	/// @param handle A file handle opened with GENERIC_READ | GENERIC_WRITE, for the same reason.
+	/// @param step How many bytes to grow the file and mapping by each time it fills.
+	explicit basic_mmap_writer(void* handle, std::size_t step = default_step) : _step(step) { _file.handle = handle; }
+#endif
+	~basic_mmap_writer() { close(); }
+
+	basic_mmap_writer(basic_mmap_writer const&) = delete;
+	basic_mmap_writer& operator=(basic_mmap_writer const&) = delete;
+
+	void write(basic_string_view<CharT> str) final;
+	void write_stable(basic_string_view<CharT> str) final { write(str); }
+	void write_fill(CharT ch, std::size_t count) final;
+	CharT* reserve(std::size_t count) final { return _fits(count) ? this->_window : nullptr; }
+	void commit(std::size_t count) final { this->_window += count; }
+
+	/// Unmap the file and truncate it to the characters written.
+	/// Further writes are dropped.
+	/// @returns false if this or any earlier mapping or truncation failed.
+	bool close();
+
+	/// The number of characters written so far.
+	std::size_t size() const { return this->_window != nullptr ? static_cast<std::size_t>(this->_window - _first()) : _length; }
+	bool failed() const { return _failed; }
+
+private:
+	CharT* _first() const { return static_cast<CharT*>(_file.data); }
+	bool _fits(std::size_t count) { return count <= static_cast<std::size_t>(this->_window_end - this->_window) || _grow(count); }
+	bool _grow(std::size_t count);
+
+	_detail::mapped_file _file;
+	std::size_t _step = default_step;
+	std::size_t _length = 0; // the size once nothing is mapped
+	bool _failed = false;
+	bool _closed = false;
+};
+
+template <typename CharT>
+bool formatxx::basic_mmap_writer<CharT>::_grow(std::size_t count)
+{
+	if (_failed || _closed)
+	{
+		return false;
+	}
+
+	std::size_t const used = size();
+	std::size_t const required = (used + count) * sizeof(CharT);
+	std::size_t const step = _step != 0 ? _step : default_step;
+
+	// grow by whole steps, so large formats settle into few remaps
+	std::size_t bytes = _file.bytes + step;
+	if (bytes < required)
+	{
+		bytes = (required + step - 1) / step * step;
+	}
+
+	if (!_detail::remap_file(_file, bytes))
+	{
+		_failed = true;
+		_length = used;
+		this->_window = this->_window_end = nullptr;
+		return false;
+	}
+
+	this->_window = _first() + used;
+	this->_window_end = _first() + _file.bytes / sizeof(CharT);
+	return true;
+}
+
+template <typename CharT>
+bool formatxx::basic_mmap_writer<CharT>::close()
+{
+	if (!_closed)
+	{
+		_closed = true;
+		_length = size();
+		if (!_detail::unmap_file(_file, _length * sizeof(CharT)))
+		{
+			_failed = true;
+		}
+		this->_window = this->_window_end = nullptr;
+	}
+	return !_failed;
+}
+
+template <typename CharT>
+void formatxx::basic_mmap_writer<CharT>::write(basic_string_view<CharT> str)
+{
+	if (!str.empty() && _fits(str.size()))
+	{
+		std::memcpy(this->_window, str.data(), str.size() * sizeof(CharT));
+		this->_window += str.size();
+	}
+}
+
+template <typename CharT>
+void formatxx::basic_mmap_writer<CharT>::write_fill(CharT ch, std::size_t count)
+{
+	if (count != 0 && _fits(count))
+	{
+		for (CharT* const end = this->_window + count; this->_window != end; ++this->_window)
+		{
+			*this->_window = ch;
+		}
+	}
+}
+
+#endif // !defined(_guard_FORMATXX_MMAP_H)
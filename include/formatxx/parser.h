@@ -0,0 +1,175 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+
+#if !defined(_guard_FORMATXX_PARSER_H)
+#define _guard_FORMATXX_PARSER_H
+#pragma once
+
+#include <formatxx/format.h>
+
+namespace formatxx
+{
+	template <typename CharT, std::size_t CountN> class basic_format_arg_list;
+	template <typename CharT> class basic_format_parser;
+
+	using format_parser = basic_format_parser<char>;
+	using wformat_parser = basic_format_parser<wchar_t>;
+
+	template <typename CharT, typename... Args> basic_format_arg_list<CharT, sizeof...(Args)> make_format_args(Args const&... args);
+
+	/// @internal
+	namespace _detail
+	{
+		/// Where a streamed format string left off at the end of the last chunk.
+		template <typename CharT>
+		struct parser_state
+		{
+			/// The longest directive that can be split across chunks; longer split directives are malformed.
+			/// A directive that lies within one chunk is formatted in place, whatever its length.
+			static constexpr std::size_t capacity = 256;
+
+			enum class mode : unsigned char
+			{
+				literal, // copying literal text
+				brace, // just after a {
+				index, // reading the argument index
+				spec, // buffering the spec after the :
+				skip, // discarding an overlong directive up to its }
+			};
+
+			mode state = mode::literal;
+			bool has_index = false;
+			unsigned index = 0;
+			unsigned next_index = 0;
+			std::size_t spec_begin = 0;
+			std::size_t size = 0;
+			CharT text[capacity]; // the directive so far, after its {
+		};
+
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API parse_format_chunk(basic_format_writer<CharT>& out, basic_format_args<CharT> const& args, parser_state<CharT>& state, basic_string_view<CharT> chunk);
+	}
+}
+
+/// A set of packed format arguments that outlives a single call, for use with basic_format_parser.
+/// Arguments that are not library primitives are stored by address, so they must outlive the list.
+template <typename CharT, std::size_t CountN>
+class formatxx::basic_format_arg_list
+{
+public:
+	template <typename... Args>
+	explicit basic_format_arg_list(Args const&... args) : _args{_detail::make_format_arg<CharT>(args)...} {}
+
+	operator basic_format_args<CharT>() const { return basic_format_args<CharT>(CountN, _args); }
+
+private:
+	basic_format_arg<CharT> _args[CountN + (CountN == 0)];
+};
+
+/// Formats a {}-style format string that arrives in pieces, such as one streamed from a file or socket.
+/// Literal text is written as soon as it is fed; only a directive split across chunks is buffered,
+/// so memory use does not depend on the size of the format string. The result is the same as
+/// formatting the whole string at once with format, except that a directive split across chunks
+/// may be at most 256 characters long; a longer one is malformed and dropped.
+template <typename CharT>
+class formatxx::basic_format_parser
+{
+public:
+	/// @param writer The write buffer that will receive the formatted text.
+	/// @param args The arguments used by the formatting string, which must outlive the parser.
+	basic_format_parser(basic_format_writer<CharT>& writer, basic_format_args<CharT> args) : _writer(writer), _args(args) {}
+
+	/// Format the next piece of the format string. The piece need not outlive the call.
+	/// @return The first error encountered so far, or success.
+	result_code feed(basic_string_view<CharT> chunk);
+
+	/// Complete the format string; an unterminated directive is malformed, and written out as literal text.
+	/// The parser is then reset so it can format another string with the same arguments.
+	/// @return The first error encountered, or success.
+	result_code finish();
+
+	result_code result() const { return _result; }
+
+private:
+	basic_format_writer<CharT>& _writer;
+	basic_format_args<CharT> _args;
+	_detail::parser_state<CharT> _state;
+	result_code _result = result_code::success;
+};
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::parse_format_chunk(basic_format_writer<char>& out, basic_format_args<char> const& args, parser_state<char>& state, basic_string_view<char> chunk);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::parse_format_chunk(basic_format_writer<wchar_t>& out, basic_format_args<wchar_t> const& args, parser_state<wchar_t>& state, basic_string_view<wchar_t> chunk);
+
+/// Pack arguments for a basic_format_parser.
+/// @param args The arguments used by the formatting string, which must outlive the returned list.
+template <typename CharT, typename... Args>
+formatxx::basic_format_arg_list<CharT, sizeof...(Args)> formatxx::make_format_args(Args const&... args)
+{
+	return basic_format_arg_list<CharT, sizeof...(Args)>(args...);
+}
+
+template <typename CharT>
+formatxx::result_code formatxx::basic_format_parser<CharT>::feed(basic_string_view<CharT> chunk)
+{
+	result_code const result = _detail::parse_format_chunk(_writer, _args, _state, chunk);
+	if (_result == result_code::success)
+	{
+		_result = result;
+	}
+	return _result;
+}
+
+template <typename CharT>
+formatxx::result_code formatxx::basic_format_parser<CharT>::finish()
+{
+	using mode = typename _detail::parser_state<CharT>::mode;
+
+	if (_state.state != mode::literal)
+	{
+		if (_state.state != mode::skip)
+		{
+			CharT const brace = CharT('{');
+			_writer.write({&brace, 1});
+			_writer.write({_state.text, _state.size});
+		}
+		if (_result == result_code::success)
+		{
+			_result = result_code::malformed_input;
+		}
+	}
+
+	result_code const result = _result;
+	_state = _detail::parser_state<CharT>();
+	_result = result_code::success;
+	return result;
+}
+
+#endif // !defined(_guard_FORMATXX_PARSER_H)
@@ -0,0 +1,141 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_SPAN_H)
+#define _guard_FORMATXX_SPAN_H
+#pragma once
+
+#include <formatxx/format.h>
+#include <cstring> // for std::memcpy
+
+namespace formatxx
+{
+	template <typename CharT> class basic_span_writer;
+	template <typename CharT> struct format_to_n_result;
+
+	using span_writer = basic_span_writer<char>;
+
+	template <typename CharT, typename FormatT, typename... Args> format_to_n_result<CharT> format_to_n(CharT* buffer, std::size_t capacity, FormatT const& format, Args const&... args);
+	template <typename CharT, typename FormatT, typename... Args> format_to_n_result<CharT> printf_to_n(CharT* buffer, std::size_t capacity, FormatT const& format, Args const&... args);
+
+} // namespace formatxx
+
+/// The outcome of format_to_n and printf_to_n.
+template <typename CharT>
+struct formatxx::format_to_n_result
+{
+	/// One past the last character written.
+	CharT* out;
+	/// The length of the complete output, which exceeds the capacity when truncated.
+	std::size_t size;
+	/// out_of_space when the output was truncated, or any error from formatting.
+	result_code result;
+};
+
+/// A writer into a caller-provided buffer of fixed capacity.
+/// Output past the end is dropped but still counted, so truncation can be detected
+/// and the required size reported. No NUL terminator is written.
+template <typename CharT>
+class formatxx::basic_span_writer : public basic_format_writer<CharT>
+{
+public:
+	basic_span_writer(CharT* buffer, std::size_t capacity) : _first(buffer) { this->_window = buffer; this->_window_end = buffer + capacity; }
+
+	void write(basic_string_view<CharT> str) final;
+	void write_stable(basic_string_view<CharT> str) final { write(str); }
+	void write_fill(CharT ch, std::size_t count) final;
+	CharT* reserve(std::size_t count) final { return count <= static_cast<std::size_t>(this->_window_end - this->_window) ? this->_window : nullptr; }
+	void commit(std::size_t count) final { this->_window += count; }
+
+	void clear() { this->_window = _first; _dropped = 0; }
+	std::size_t size() const { return this->_window - _first; }
+	CharT* data() const { return _first; }
+	CharT* end() const { return this->_window; }
+
+	/// The number of characters that were written or would have been, had there been room.
+	std::size_t required_size() const { return size() + _dropped; }
+	bool truncated() const { return _dropped != 0; }
+
+private:
+	CharT* _first = nullptr;
+	std::size_t _dropped = 0;
+};
+
+template <typename CharT>
+void formatxx::basic_span_writer<CharT>::write(basic_string_view<CharT> str)
+{
+	std::size_t const remaining = this->_window_end - this->_window;
+	std::size_t const length = remaining < str.size() ? remaining : str.size();
+	std::memcpy(this->_window, str.data(), length * sizeof(CharT));
+	this->_window += length;
+	_dropped += str.size() - length;
+}
+
+template <typename CharT>
+void formatxx::basic_span_writer<CharT>::write_fill(CharT ch, std::size_t count)
+{
+	std::size_t const remaining = this->_window_end - this->_window;
+	std::size_t const length = remaining < count ? remaining : count;
+	for (CharT* const end = this->_window + length; this->_window != end; ++this->_window)
+	{
+		*this->_window = ch;
+	}
+	_dropped += count - length;
+}
+
+/// Write the string format directly into a caller buffer, reporting truncation.
+/// @param buffer The destination, which receives at most capacity characters and no NUL terminator.
+/// @param capacity The number of characters available in buffer.
+/// @param format The primary text and formatting controls to be written.
+/// @param args The arguments used by the formatting string.
+/// @returns the end of the written characters, the untruncated length, and the result.
+template <typename CharT, typename FormatT, typename... Args>
+formatxx::format_to_n_result<CharT> formatxx::format_to_n(CharT* buffer, std::size_t capacity, FormatT const& format, Args const&... args)
+{
+	basic_span_writer<CharT> out(buffer, capacity);
+	result_code const result = formatxx::format(out, format, args...);
+	return {out.end(), out.required_size(), result == result_code::success && out.truncated() ? result_code::out_of_space : result};
+}
+
+/// Write the printf format directly into a caller buffer, reporting truncation.
+/// @param buffer The destination, which receives at most capacity characters and no NUL terminator.
+/// @param capacity The number of characters available in buffer.
+/// @param format The primary text and printf controls to be written.
+/// @param args The arguments used by the formatting string.
+/// @returns the end of the written characters, the untruncated length, and the result.
+template <typename CharT, typename FormatT, typename... Args>
+formatxx::format_to_n_result<CharT> formatxx::printf_to_n(CharT* buffer, std::size_t capacity, FormatT const& format, Args const&... args)
+{
+	basic_span_writer<CharT> out(buffer, capacity);
+	result_code const result = formatxx::printf(out, format, args...);
+	return {out.end(), out.required_size(), result == result_code::success && out.truncated() ? result_code::out_of_space : result};
+}
+
+#endif // !defined(_guard_FORMATXX_SPAN_H)
@@ -0,0 +1,284 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_STATIC_FORMAT_H)
+#define _guard_FORMATXX_STATIC_FORMAT_H
+#pragma once
+
+#include <formatxx/format.h>
+
+/// Creates a format string that is parsed and checked against its arguments at compile time.
+/// The argument must be a string literal.
+#define FORMATXX_STRING(str) \
+	([]{ \
+		struct _formatxx_static_string \
+		{ \
+			using char_type = typename std::remove_cv<typename std::remove_reference<decltype(*(str))>::type>::type; \
+			static constexpr char_type const* data() { return str; } \
+			static constexpr std::size_t size() { return sizeof(str) / sizeof(char_type) - 1; } \
+		}; \
+		return ::formatxx::basic_static_format<_formatxx_static_string::char_type, _formatxx_static_string>(); \
+	}())
+
+namespace formatxx
+{
+	template <typename CharT, typename HolderT>
+	constexpr basic_string_view<CharT> make_string_view(basic_static_format<CharT, HolderT> const&) { return {HolderT::data(), HolderT::size()}; }
+
+	/// @internal
+	namespace _detail
+	{
+		/// A literal or argument reference within a static format string.
+		struct static_segment
+		{
+			static constexpr unsigned literal_index = ~0U;
+
+			constexpr static_segment() = default;
+			constexpr static_segment(std::size_t offset, std::size_t length, unsigned index) : offset(offset), length(length), index(index) {}
+
+			std::size_t offset = 0; // offset of the literal text or the spec string
+			std::size_t length = 0;
+			unsigned index = literal_index;
+		};
+
+		/// The result of parsing one segment at compile time.
+		struct static_token
+		{
+			constexpr static_token() = default;
+			constexpr static_token(static_segment segment, std::size_t next, unsigned next_index) : segment(segment), next(next), next_index(next_index), valid(true) {}
+
+			static_segment segment;
+			std::size_t next = 0;
+			unsigned next_index = 0;
+			bool valid = false;
+		};
+
+		// the parsing functions are restricted to C++11 constexpr rules, so
+		// everything is written as recursive single expressions; the format
+		// grammar matches parse_format, except that any error is fatal
+
+		template <typename CharT>
+		constexpr std::size_t static_find_linear(CharT const* str, std::size_t first, std::size_t last, CharT ch)
+		{
+			return first == last ? last : str[first] == ch ? first : static_find_linear(str, first + 1, last, ch);
+		}
+
+		template <typename CharT>
+		constexpr std::size_t static_find(CharT const* str, std::size_t first, std::size_t last, CharT ch);
+
+		template <typename CharT>
+		constexpr std::size_t static_find_pick(CharT const* str, std::size_t found, std::size_t mid, std::size_t last, CharT ch)
+		{
+			return found != mid ? found : static_find(str, mid, last, ch);
+		}
+
+		// split the search in halves to keep the recursion depth logarithmic in the string length
+		template <typename CharT>
+		constexpr std::size_t static_find(CharT const* str, std::size_t first, std::size_t last, CharT ch)
+		{
+			return last - first <= 16 ?
+				static_find_linear(str, first, last, ch) :
+				static_find_pick(str, static_find(str, first, first + (last - first) / 2, ch), first + (last - first) / 2, last, ch);
+		}
+
+		template <typename CharT>
+		constexpr std::size_t static_digits_end(CharT const* str, std::size_t pos, std::size_t size)
+		{
+			return pos != size && str[pos] >= CharT('0') && str[pos] <= CharT('9') ? static_digits_end(str, pos + 1, size) : pos;
+		}
+
+		template <typename CharT>
+		constexpr unsigned static_digits_value(CharT const* str, std::size_t first, std::size_t last, unsigned value)
+		{
+			return first == last ? value : static_digits_value(str, first + 1, last, value * 10 + unsigned(str[first] - CharT('0')));
+		}
+
+		template <typename CharT>
+		constexpr static_token static_literal(std::size_t first, std::size_t last, unsigned next_index)
+		{
+			return static_token(static_segment(first, last - first, static_segment::literal_index), last, next_index);
+		}
+
+		template <typename CharT>
+		constexpr static_token static_argument_end(CharT const* str, std::size_t size, std::size_t sep, std::size_t close, unsigned index)
+		{
+			return close == size || str[close] != CharT('}') ? static_token() :
+				str[sep] == CharT(':') ?
+					static_token(static_segment(sep + 1, close - sep - 1, index), close + 1, index + 1) :
+					static_token(static_segment(sep, 0, index), close + 1, index + 1);
+		}
+
+		template <typename CharT>
+		constexpr static_token static_argument(CharT const* str, std::size_t size, std::size_t start, std::size_t sep, unsigned next_index)
+		{
+			return sep == size ? static_token() :
+				static_argument_end(str, size, sep,
+					str[sep] == CharT(':') ? static_find(str, sep + 1, size, CharT('}')) : sep,
+					sep == start ? next_index : static_digits_value(str, start, sep, 0));
+		}
+
+		template <typename CharT>
+		constexpr static_token static_next_token(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index)
+		{
+			return str[pos] != CharT('{') ? static_literal<CharT>(pos, static_find(str, pos, size, CharT('{')), next_index) :
+				pos + 1 == size ? static_token() :
+				str[pos + 1] == CharT('{') ? static_literal<CharT>(pos + 1, static_find(str, pos + 2, size, CharT('{')), next_index) :
+				static_argument(str, size, pos + 1, static_digits_end(str, pos + 1, size), next_index);
+		}
+
+		template <typename CharT>
+		constexpr bool static_valid(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index);
+
+		template <typename CharT>
+		constexpr bool static_valid_token(CharT const* str, std::size_t size, static_token token)
+		{
+			return token.valid && static_valid(str, size, token.next, token.next_index);
+		}
+
+		/// Determines if the format string can be parsed without errors.
+		template <typename CharT>
+		constexpr bool static_valid(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index)
+		{
+			return pos >= size ? true : static_valid_token(str, size, static_next_token(str, size, pos, next_index));
+		}
+
+		template <typename CharT>
+		constexpr std::size_t static_count(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index);
+
+		template <typename CharT>
+		constexpr std::size_t static_count_token(CharT const* str, std::size_t size, static_token token)
+		{
+			return token.valid ? 1 + static_count(str, size, token.next, token.next_index) : 0;
+		}
+
+		/// Counts the segments in the format string.
+		template <typename CharT>
+		constexpr std::size_t static_count(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index)
+		{
+			return pos >= size ? 0 : static_count_token(str, size, static_next_token(str, size, pos, next_index));
+		}
+
+		template <typename CharT>
+		constexpr std::size_t static_required(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index);
+
+		constexpr std::size_t static_required_token(static_token token, std::size_t rest)
+		{
+			return token.segment.index != static_segment::literal_index && token.segment.index + std::size_t(1) > rest ? token.segment.index + std::size_t(1) : rest;
+		}
+
+		template <typename CharT>
+		constexpr std::size_t static_required_next(CharT const* str, std::size_t size, static_token token)
+		{
+			return token.valid ? static_required_token(token, static_required(str, size, token.next, token.next_index)) : 0;
+		}
+
+		/// Calculates the number of arguments required by the format string.
+		template <typename CharT>
+		constexpr std::size_t static_required(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index)
+		{
+			return pos >= size ? 0 : static_required_next(str, size, static_next_token(str, size, pos, next_index));
+		}
+
+		template <typename CharT>
+		constexpr static_segment static_nth(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index, std::size_t nth);
+
+		template <typename CharT>
+		constexpr static_segment static_nth_token(CharT const* str, std::size_t size, static_token token, std::size_t nth)
+		{
+			return nth == 0 ? token.segment : static_nth(str, size, token.next, token.next_index, nth - 1);
+		}
+
+		/// Retrieves the nth segment of the format string.
+		template <typename CharT>
+		constexpr static_segment static_nth(CharT const* str, std::size_t size, std::size_t pos, unsigned next_index, std::size_t nth)
+		{
+			return static_nth_token(str, size, static_next_token(str, size, pos, next_index), nth);
+		}
+
+		template <std::size_t... Indices> struct index_sequence {};
+
+		template <std::size_t Count, std::size_t... Indices>
+		struct make_index_sequence : make_index_sequence<Count - 1, Count - 1, Indices...> {};
+
+		template <std::size_t... Indices>
+		struct make_index_sequence<0, Indices...> { using type = index_sequence<Indices...>; };
+
+		/// Table of the segments of a static format string, generated at compile time.
+		template <typename HolderT, typename IndicesT> struct static_format_table;
+
+		template <typename HolderT, std::size_t... Indices>
+		struct static_format_table<HolderT, index_sequence<Indices...>>
+		{
+			static constexpr std::size_t count = sizeof...(Indices);
+			static constexpr static_segment segments[sizeof...(Indices) + 1] = {static_nth(HolderT::data(), HolderT::size(), 0, 0, Indices)..., static_segment()};
+		};
+
+		template <typename HolderT, std::size_t... Indices>
+		constexpr static_segment static_format_table<HolderT, index_sequence<Indices...>>::segments[];
+
+		template <typename CharT>
+		FORMATXX_PUBLIC result_code FORMATXX_API static_format_impl(basic_format_writer<CharT>& out, CharT const* format, static_segment const* segments, std::size_t count, basic_format_args<CharT> args);
+	}
+}
+
+/// A format string whose segments are computed at compile time; see FORMATXX_STRING.
+template <typename CharT, typename HolderT>
+class formatxx::basic_static_format
+{
+public:
+	static constexpr bool valid = _detail::static_valid(HolderT::data(), HolderT::size(), 0, 0);
+	static constexpr std::size_t required_args = _detail::static_required(HolderT::data(), HolderT::size(), 0, 0);
+
+	static_assert(valid, "malformed format string");
+
+	using table = _detail::static_format_table<HolderT, typename _detail::make_index_sequence<_detail::static_count(HolderT::data(), HolderT::size(), 0, 0)>::type>;
+};
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::static_format_impl(basic_format_writer<char>& out, char const* format, static_segment const* segments, std::size_t count, basic_format_args<char> args);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::static_format_impl(basic_format_writer<wchar_t>& out, wchar_t const* format, static_segment const* segments, std::size_t count, basic_format_args<wchar_t> args);
+
+/// Write a static format using the given parameters into a buffer.
+/// @param writer The write buffer that will receive the formatted text.
+/// @param format The static format created by FORMATXX_STRING.
+/// @param args The arguments used by the formatting string.
+template <typename CharT, typename HolderT, typename... Args>
+formatxx::result_code formatxx::format(basic_format_writer<CharT>& writer, basic_static_format<CharT, HolderT> const&, Args const&... args)
+{
+	using format_type = basic_static_format<CharT, HolderT>;
+	using table = typename format_type::table;
+
+	static_assert(format_type::required_args <= sizeof...(Args), "format string references more arguments than were provided");
+
+	basic_format_arg<CharT> const packed[sizeof...(args) + (sizeof...(args) == 0)] = {_detail::make_format_arg<CharT>(args)...};
+
+	return _detail::static_format_impl(writer, HolderT::data(), table::segments, table::count, basic_format_args<CharT>(sizeof...(args), packed));
+}
+
+#endif // !defined(_guard_FORMATXX_STATIC_FORMAT_H)
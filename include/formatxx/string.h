@@ -33,7 +33,10 @@
 #pragma once
 
 #include <formatxx/format.h>
+#include <formatxx/buffered.h>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace formatxx
 {
@@ -43,18 +46,126 @@ namespace formatxx
 
 	template <typename StringT = std::string, typename FormatT, typename... Args> StringT format_string(FormatT const& format, Args const&... args);
 	template <typename StringT = std::string, typename FormatT, typename... Args> StringT printf_string(FormatT const& format, Args const&... args);
+	template <typename StringT = std::string, typename FormatT, typename... Args> StringT scratch_format_string(FormatT const& format, Args const&... args);
+	template <typename StringT = std::string, typename FormatT, typename... Args> StringT scratch_printf_string(FormatT const& format, Args const&... args);
 
-	template <typename CharT, typename TraitsT, typename AllocatorT>
-	basic_string_view<CharT> make_string_view(std::basic_string<CharT, TraitsT, AllocatorT> const& str) { return {str.c_str(), str.size()}; }
-
-	template <typename CharT, typename TraitsT, typename AllocatorT>
-	void format_value(format_writer& out, std::basic_string<CharT, TraitsT, AllocatorT> const& string, string_view spec)
+	namespace _detail
 	{
-		format_value(out, basic_string_view<CharT>(string.c_str(), string.size()), spec);
-	}
+		/// Remembers the last result length per format string, so repeated calls reserve once.
+		/// A small direct-mapped table per thread; collisions simply replace the old entry.
+		/// A null key is never stored, and hints are capped so one huge result can't inflate later calls.
+		class size_hint_cache
+		{
+		public:
+			std::size_t lookup(void const* key) const
+			{
+				entry const& slot = _entries[_index(key)];
+				return key != nullptr && slot.key == key ? slot.size : 0;
+			}
+
+			void store(void const* key, std::size_t size)
+			{
+				if (key == nullptr)
+				{
+					return;
+				}
+				entry& slot = _entries[_index(key)];
+				slot.key = key;
+				slot.size = size < size_limit ? size : std::size_t(size_limit);
+			}
+
+			static size_hint_cache& local()
+			{
+				static thread_local size_hint_cache cache;
+				return cache;
+			}
+
+		private:
+			static constexpr std::size_t entry_count = 64;
+			static constexpr std::size_t size_limit = 64 * 1024;
+
+			struct entry
+			{
+				void const* key = nullptr;
+				std::size_t size = 0;
+			};
+
+			static std::size_t _index(void const* key)
+			{
+				std::uintptr_t const bits = reinterpret_cast<std::uintptr_t>(key);
+				return static_cast<std::size_t>((bits >> 4) ^ (bits >> 10)) % entry_count;
+			}
+
+			entry _entries[entry_count];
+		};
+
+		/// The format string's own address for pointers and literals; other formats may be temporaries and get no key.
+		inline void const* size_hint_pointer(void const* format, std::true_type) { return format; }
+		template <typename FormatT> void const* size_hint_pointer(FormatT const&, std::false_type) { return nullptr; }
+		template <typename FormatT> void const* size_hint_key(FormatT const& format) { return size_hint_pointer(format, std::is_pointer<typename std::decay<FormatT>::type>()); }
+
+		/// A per-thread writer whose buffer is reused across calls.
+		/// Reentrant calls (from within a format_value) find it busy and get nullptr.
+		template <typename CharT>
+		class scratch_writer
+		{
+		public:
+			using writer_type = basic_buffered_writer<CharT, 512>;
+
+			scratch_writer() : _state(_local()), _owner(!_state.busy)
+			{
+				if (_owner)
+				{
+					_state.busy = true;
+					_state.writer.clear();
+				}
+			}
 
-	template <typename CharT, typename TraitsT, typename AllocatorT>
-	void format_value(wformat_writer& out, std::basic_string<CharT, TraitsT, AllocatorT> const& string, wstring_view spec)
+			~scratch_writer()
+			{
+				if (_owner)
+				{
+					// don't let one oversized result pin its buffer for the thread's lifetime
+					if (_state.writer.capacity() > retain_limit)
+					{
+						_state.writer = writer_type();
+					}
+					_state.busy = false;
+				}
+			}
+
+			scratch_writer(scratch_writer const&) = delete;
+			scratch_writer& operator=(scratch_writer const&) = delete;
+
+			writer_type* get() { return _owner ? &_state.writer : nullptr; }
+
+		private:
+			static constexpr std::size_t retain_limit = 64 * 1024;
+
+			struct state
+			{
+				writer_type writer;
+				bool busy = false;
+			};
+
+			static state& _local()
+			{
+				static thread_local state local;
+				return local;
+			}
+
+			state& _state;
+			bool _owner = false;
+		};
+
+		/// Keeps the spec parameter from taking part in deduction, so literal specs convert.
+		template <typename CharT> struct writer_spec { using type = basic_string_view<CharT>; };
+
+	} // namespace _detail
+
+	/// Strings of any character type, in writers of any character type; the spec is deduced from the writer only.
+	template <typename OutCharT, typename CharT, typename TraitsT, typename AllocatorT>
+	void format_value(basic_format_writer<OutCharT>& out, std::basic_string<CharT, TraitsT, AllocatorT> const& string, typename _detail::writer_spec<OutCharT>::type spec)
 	{
 		format_value(out, basic_string_view<CharT>(string.c_str(), string.size()), spec);
 	}
@@ -70,6 +181,9 @@ public:
     basic_string_writer(StringT init) : _string(std::move(init)) {}
 
 	void write(basic_string_view<typename StringT::value_type> str) override { _string.append(str.data(), str.size()); }
+	void write_fill(typename StringT::value_type ch, std::size_t count) override { _string.append(count, ch); }
+	typename StringT::value_type* reserve(std::size_t count) override;
+	void commit(std::size_t count) override { _string.resize(_string.size() - _reserved + count); _reserved = 0; }
 
 	StringT const& str() const& { return _string; }
 	StringT& str() & { return _string; }
@@ -81,8 +195,18 @@ public:
 
 private:
 	StringT _string;
+	std::size_t _reserved = 0;
 };
 
+template <typename StringT>
+typename StringT::value_type* formatxx::basic_string_writer<StringT>::reserve(std::size_t count)
+{
+	std::size_t const size = _string.size();
+	_string.resize(size + count);
+	_reserved = count;
+	return &_string[0] + size;
+}
+
 /// Write the string format using the given parameters and return a string with the result.
 /// @param format The primary text and formatting controls to be written.
 /// @param args The arguments used by the formatting string.
@@ -90,8 +214,13 @@ private:
 template <typename StringT, typename FormatT, typename... Args>
 StringT formatxx::format_string(FormatT const& format, Args const&... args)
 {
+	_detail::size_hint_cache& hints = _detail::size_hint_cache::local();
+	void const* const key = _detail::size_hint_key(format);
+
 	basic_string_writer<StringT> tmp;
-	formatxx::format(tmp, make_string_view(format), args...);
+	tmp.str().reserve(hints.lookup(key));
+	formatxx::format(tmp, format, args...);
+	hints.store(key, tmp.size());
 	return static_cast<StringT&&>(tmp.str());
 }
 
@@ -101,9 +230,50 @@ StringT formatxx::format_string(FormatT const& format, Args const&... args)
 template <typename StringT, typename FormatT, typename... Args>
 StringT formatxx::printf_string(FormatT const& format, Args const&... args)
 {
+	_detail::size_hint_cache& hints = _detail::size_hint_cache::local();
+	void const* const key = _detail::size_hint_key(format);
+
 	basic_string_writer<StringT> tmp;
-	formatxx::printf(tmp, make_string_view(format), args...);
+	tmp.str().reserve(hints.lookup(key));
+	formatxx::printf(tmp, format, args...);
+	hints.store(key, tmp.size());
 	return static_cast<StringT&&>(tmp.str());
 }
 
+/// Write the string format into a reused per-thread buffer and return a string allocated exactly once.
+/// @param format The primary text and formatting controls to be written.
+/// @param args The arguments used by the formatting string.
+/// @returns a formatted string.
+template <typename StringT, typename FormatT, typename... Args>
+StringT formatxx::scratch_format_string(FormatT const& format, Args const&... args)
+{
+	_detail::scratch_writer<typename StringT::value_type> scratch;
+	auto* const writer = scratch.get();
+	if (writer == nullptr)
+	{
+		return format_string<StringT>(format, args...);
+	}
+
+	formatxx::format(*writer, format, args...);
+	return StringT(writer->c_str(), writer->size());
+}
+
+/// Write the printf format into a reused per-thread buffer and return a string allocated exactly once.
+/// @param format The primary text and printf controls to be written.
+/// @param args The arguments used by the formatting string.
+/// @returns a formatted string.
+template <typename StringT, typename FormatT, typename... Args>
+StringT formatxx::scratch_printf_string(FormatT const& format, Args const&... args)
+{
+	_detail::scratch_writer<typename StringT::value_type> scratch;
+	auto* const writer = scratch.get();
+	if (writer == nullptr)
+	{
+		return printf_string<StringT>(format, args...);
+	}
+
+	formatxx::printf(*writer, format, args...);
+	return StringT(writer->c_str(), writer->size());
+}
+
 #endif // !defined(_guard_FORMATXX_STRING_H)
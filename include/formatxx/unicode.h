@@ -0,0 +1,262 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#if !defined(_guard_FORMATXX_UNICODE_H)
+#define _guard_FORMATXX_UNICODE_H
+#pragma once
+
+#include <formatxx/format.h>
+
+namespace formatxx
+{
+	namespace _detail { template <typename T> struct new_delete_allocator; }
+	template <typename CharT, std::size_t> class basic_fixed_writer;
+	template <typename StringT> class basic_string_writer;
+	template <typename CharT, std::size_t Size, typename AllocatorT> class basic_buffered_writer;
+
+	using u16string_view = basic_string_view<char16_t>;
+	using u16format_writer = basic_format_writer<char16_t>;
+	using u16format_spec = basic_format_spec<char16_t>;
+	using u16string_writer = basic_string_writer<std::basic_string<char16_t>>;
+	template <std::size_t Size = 512> using u16fixed_writer = basic_fixed_writer<char16_t, Size>;
+	template <std::size_t Size = 512, typename AllocatorT = _detail::new_delete_allocator<char16_t>> using u16buffered_writer = basic_buffered_writer<char16_t, Size, AllocatorT>;
+
+	using u32string_view = basic_string_view<char32_t>;
+	using u32format_writer = basic_format_writer<char32_t>;
+	using u32format_spec = basic_format_spec<char32_t>;
+	using u32string_writer = basic_string_writer<std::basic_string<char32_t>>;
+	template <std::size_t Size = 512> using u32fixed_writer = basic_fixed_writer<char32_t, Size>;
+	template <std::size_t Size = 512, typename AllocatorT = _detail::new_delete_allocator<char32_t>> using u32buffered_writer = basic_buffered_writer<char32_t, Size, AllocatorT>;
+
+#if defined(__cpp_char8_t)
+	using u8string_view = basic_string_view<char8_t>;
+	using u8format_writer = basic_format_writer<char8_t>;
+	using u8format_spec = basic_format_spec<char8_t>;
+	using u8string_writer = basic_string_writer<std::basic_string<char8_t>>;
+	template <std::size_t Size = 512> using u8fixed_writer = basic_fixed_writer<char8_t, Size>;
+	template <std::size_t Size = 512, typename AllocatorT = _detail::new_delete_allocator<char8_t>> using u8buffered_writer = basic_buffered_writer<char8_t, Size, AllocatorT>;
+#endif
+}
+
+namespace formatxx
+{
+	/// Default format helpers.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t const* zstr, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t* zstr, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, u16string_view str, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t ch, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, bool value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, float value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, double value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed char value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed int value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed short value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long long value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned char value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned int value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned short value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long long value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void* value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void const* value, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, hex_bytes bytes, u16string_view spec);
+
+	/// Default format helpers for pre-parsed format specifications.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t const* zstr, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t* zstr, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, u16string_view str, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t ch, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, bool value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, float value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, double value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed char value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed int value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed short value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long long value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned char value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned int value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned short value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long long value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void* value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void const* value, u16format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, hex_bytes bytes, u16format_spec const& spec);
+
+	/// Format UTF-8 narrow characters into UTF-16 writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char const* zstr, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char* zstr, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, string_view str, u16string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char ch, u16string_view spec);
+
+	/// Format UTF-16 characters into UTF-8 narrow writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t const* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u16string_view str, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t ch, string_view spec);
+}
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_builtin_arg(basic_format_writer<char16_t>& out, basic_format_arg<char16_t> const& arg, basic_string_view<char16_t> spec_string, basic_format_spec<char16_t> const* spec);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_impl(basic_format_writer<char16_t>& out, basic_string_view<char16_t> format, basic_format_args<char16_t> args);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::printf_impl(basic_format_writer<char16_t>& out, basic_string_view<char16_t> format, basic_format_args<char16_t> args);
+extern template FORMATXX_PUBLIC formatxx::basic_format_spec<char16_t> FORMATXX_API formatxx::parse_format_spec(basic_string_view<char16_t> spec);
+
+namespace formatxx
+{
+	/// Default format helpers.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t const* zstr, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t* zstr, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, u32string_view str, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t ch, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, bool value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, float value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, double value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed char value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed int value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed short value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long long value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned char value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned int value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned short value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long long value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void* value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void const* value, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, hex_bytes bytes, u32string_view spec);
+
+	/// Default format helpers for pre-parsed format specifications.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t const* zstr, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t* zstr, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, u32string_view str, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t ch, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, bool value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, float value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, double value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed char value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed int value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed short value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long long value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned char value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned int value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned short value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long long value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void* value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void const* value, u32format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, hex_bytes bytes, u32format_spec const& spec);
+
+	/// Format UTF-8 narrow characters into UTF-32 writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char const* zstr, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char* zstr, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, string_view str, u32string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char ch, u32string_view spec);
+
+	/// Format UTF-32 characters into UTF-8 narrow writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t const* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u32string_view str, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t ch, string_view spec);
+}
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_builtin_arg(basic_format_writer<char32_t>& out, basic_format_arg<char32_t> const& arg, basic_string_view<char32_t> spec_string, basic_format_spec<char32_t> const* spec);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_impl(basic_format_writer<char32_t>& out, basic_string_view<char32_t> format, basic_format_args<char32_t> args);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::printf_impl(basic_format_writer<char32_t>& out, basic_string_view<char32_t> format, basic_format_args<char32_t> args);
+extern template FORMATXX_PUBLIC formatxx::basic_format_spec<char32_t> FORMATXX_API formatxx::parse_format_spec(basic_string_view<char32_t> spec);
+
+#if defined(__cpp_char8_t)
+namespace formatxx
+{
+	/// Default format helpers.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t const* zstr, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t* zstr, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, u8string_view str, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t ch, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, bool value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, float value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, double value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed char value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed int value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed short value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long long value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned char value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned int value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned short value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long long value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void* value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void const* value, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, hex_bytes bytes, u8string_view spec);
+
+	/// Default format helpers for pre-parsed format specifications.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t const* zstr, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t* zstr, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, u8string_view str, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t ch, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, bool value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, float value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, double value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed char value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed int value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed short value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long long value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned char value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned int value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned short value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long long value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void* value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void const* value, u8format_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, hex_bytes bytes, u8format_spec const& spec);
+
+	/// Format UTF-8 narrow characters into UTF-8 writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char const* zstr, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char* zstr, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, string_view str, u8string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char ch, u8string_view spec);
+
+	/// Format UTF-8 characters into UTF-8 narrow writers
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t const* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t* zstr, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u8string_view str, string_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t ch, string_view spec);
+}
+
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_builtin_arg(basic_format_writer<char8_t>& out, basic_format_arg<char8_t> const& arg, basic_string_view<char8_t> spec_string, basic_format_spec<char8_t> const* spec);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_impl(basic_format_writer<char8_t>& out, basic_string_view<char8_t> format, basic_format_args<char8_t> args);
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::printf_impl(basic_format_writer<char8_t>& out, basic_string_view<char8_t> format, basic_format_args<char8_t> args);
+extern template FORMATXX_PUBLIC formatxx::basic_format_spec<char8_t> FORMATXX_API formatxx::parse_format_spec(basic_string_view<char8_t> spec);
+#endif
+
+#endif // !defined(_guard_FORMATXX_UNICODE_H)
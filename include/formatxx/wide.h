@@ -71,6 +71,29 @@ namespace formatxx
 	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long long value, wstring_view spec);
 	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void* value, wstring_view spec);
 	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void const* value, wstring_view spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, hex_bytes bytes, wstring_view spec);
+
+	/// Default format helpers for pre-parsed format specifications.
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t const* zstr, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t* zstr, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wstring_view str, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t ch, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, bool value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, float value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, double value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed char value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed int value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed short value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long long value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned char value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned int value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned short value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long long value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void* value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void const* value, wformat_spec const& spec);
+	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, hex_bytes bytes, wformat_spec const& spec);
 
 	/// Format narrow characters into wide writers
 	FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char const* zstr, wstring_view spec);
@@ -85,6 +108,7 @@ namespace formatxx
 	FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t ch, string_view spec);
 }
 
+extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_builtin_arg(basic_format_writer<wchar_t>& out, basic_format_arg<wchar_t> const& arg, basic_string_view<wchar_t> spec_string, basic_format_spec<wchar_t> const* spec);
 extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::format_impl(basic_format_writer<wchar_t>& out, basic_string_view<wchar_t> format, basic_format_args<wchar_t> args);
 extern template FORMATXX_PUBLIC formatxx::result_code FORMATXX_API formatxx::_detail::printf_impl(basic_format_writer<wchar_t>& out, basic_string_view<wchar_t> format, basic_format_args<wchar_t> args);
 extern template FORMATXX_PUBLIC formatxx::basic_format_spec<wchar_t> FORMATXX_API formatxx::parse_format_spec(basic_string_view<wchar_t> spec);
@@ -0,0 +1,70 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/batch.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+formatxx::thread_executor::thread_executor(unsigned threads)
+	: _threads(threads != 0 ? threads : std::thread::hardware_concurrency())
+{
+	if (_threads == 0)
+	{
+		_threads = 1;
+	}
+}
+
+void formatxx::thread_executor::run(std::size_t count, task_type task, void* context)
+{
+	std::atomic<std::size_t> next(0);
+	auto work = [&]()
+	{
+		for (std::size_t index = next.fetch_add(1, std::memory_order_relaxed); index < count; index = next.fetch_add(1, std::memory_order_relaxed))
+		{
+			task(context, index);
+		}
+	};
+
+	// the calling thread works too, so a single chunk never starts a thread
+	std::size_t const helpers = (count < _threads ? count : _threads) - (count != 0 ? 1 : 0);
+	std::vector<std::thread> threads;
+	threads.reserve(helpers);
+	for (std::size_t i = 0; i != helpers; ++i)
+	{
+		threads.emplace_back(work);
+	}
+	work();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
@@ -0,0 +1,408 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/format.h>
+#include <formatxx/fixed.h>
+#include <formatxx/buffered.h>
+#include <formatxx/wide.h>
+#include <formatxx/string.h>
+#include <formatxx/counting.h>
+#include <formatxx/span.h>
+#include <formatxx/deferred.h>
+#include <formatxx/batch.h>
+#include <formatxx/append.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(FORMATXX_BENCH_FMT)
+#	include <fmt/format.h>
+#endif
+
+// formatxx_bench: throughput and per-call latency of formatxx against snprintf, iostreams and
+// (when found at configure time) fmtlib, plus the compile-time and object-size cost of the
+// headers. Results are emitted as JSON (default) or CSV for regression tracking.
+//
+// usage: formatxx_bench [--csv] [--filter <substring>] [--iterations <count>] [--no-compile]
+
+namespace {
+	using clock_type = std::chrono::steady_clock;
+
+	// calls per timed batch; per-call latency percentiles are per-batch averages,
+	// as timing individual calls would measure mostly the clock itself
+	constexpr std::size_t batch_size = 64;
+	constexpr std::size_t value_count = 1024;
+
+	struct bench_result
+	{
+		std::string benchmark;
+		std::string library;
+		std::string writer;
+		std::size_t iterations = 0;
+		double ns_per_call = 0;
+		double p50_ns = 0;
+		double p99_ns = 0;
+		double mb_per_sec = 0;
+	};
+
+	struct compile_result
+	{
+		std::string benchmark;
+		double seconds = 0;
+		std::size_t object_bytes = 0;
+		bool ok = false;
+	};
+
+	struct bench_options
+	{
+		bool csv = false;
+		bool compile = true;
+		std::string filter;
+		std::size_t iterations = 200000;
+	};
+
+	// pre-generated inputs, indexed per call so no value is a compile-time constant
+	struct bench_values
+	{
+		std::vector<int> small_ints;
+		std::vector<std::int64_t> ints;
+		std::vector<double> doubles;
+		std::vector<std::string> strings;
+
+		bench_values()
+		{
+			std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+			auto next = [&state]() { state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+
+			for (std::size_t i = 0; i != value_count; ++i)
+			{
+				small_ints.push_back(static_cast<int>(next() % 1000));
+				ints.push_back(static_cast<std::int64_t>(next() >> 1));
+				doubles.push_back(static_cast<double>(next() % 100000000) / 1000.0);
+				strings.push_back(std::string("value-") + std::to_string(next() % 100000));
+			}
+		}
+	};
+
+	// accumulated output sizes keep the optimizer from discarding the work
+	std::size_t volatile bench_sink = 0;
+
+	/// Runs fn(index) repeatedly, unless filtered out; fn returns the number of characters produced.
+	void run_bench(std::vector<bench_result>& results, bench_options const& options, std::string benchmark, std::string library, std::string writer, std::function<std::size_t(std::size_t)> const& fn)
+	{
+		if (benchmark.find(options.filter) == std::string::npos)
+		{
+			return;
+		}
+
+		bench_result result;
+		result.benchmark = std::move(benchmark);
+		result.library = std::move(library);
+		result.writer = std::move(writer);
+
+		std::size_t const batches = (options.iterations + batch_size - 1) / batch_size;
+		result.iterations = batches * batch_size;
+
+		// warm up caches and any lazily-allocated writer storage
+		std::size_t bytes = 0;
+		for (std::size_t i = 0; i != batch_size * 4; ++i)
+		{
+			bytes += fn(i % value_count);
+		}
+		bytes = 0;
+
+		std::vector<double> samples;
+		samples.reserve(batches);
+
+		std::size_t index = 0;
+		auto const start = clock_type::now();
+		for (std::size_t batch = 0; batch != batches; ++batch)
+		{
+			auto const batch_start = clock_type::now();
+			for (std::size_t i = 0; i != batch_size; ++i)
+			{
+				bytes += fn(index);
+				index = (index + 1) % value_count;
+			}
+			auto const batch_end = clock_type::now();
+			samples.push_back(std::chrono::duration<double, std::nano>(batch_end - batch_start).count() / batch_size);
+		}
+		auto const end = clock_type::now();
+		bench_sink = bench_sink + bytes;
+
+		double const total_ns = std::chrono::duration<double, std::nano>(end - start).count();
+		result.ns_per_call = total_ns / static_cast<double>(result.iterations);
+		result.mb_per_sec = total_ns > 0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (total_ns * 1e-9) : 0;
+
+		std::sort(samples.begin(), samples.end());
+		result.p50_ns = samples[samples.size() / 2];
+		result.p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+		results.push_back(std::move(result));
+	}
+
+	/// Formats the same call through every formatxx writer type.
+	template <typename FormatFn>
+	void bench_formatxx_writers(std::vector<bench_result>& results, bench_options const& options, std::string const& benchmark, FormatFn fn)
+	{
+		formatxx::fixed_writer<256> fixed;
+		formatxx::buffered_writer<256> buffered;
+		formatxx::string_writer string;
+		formatxx::counting_writer counting;
+		char span_buffer[256];
+
+		run_bench(results, options, benchmark, "formatxx", "fixed_writer", [&](std::size_t i) { fixed.clear(); fn(fixed, i); return fixed.size(); });
+		run_bench(results, options, benchmark, "formatxx", "buffered_writer", [&](std::size_t i) { buffered.clear(); fn(buffered, i); return buffered.size(); });
+		run_bench(results, options, benchmark, "formatxx", "string_writer", [&](std::size_t i) { string.clear(); fn(string, i); return string.size(); });
+		run_bench(results, options, benchmark, "formatxx", "counting_writer", [&](std::size_t i) { counting.clear(); fn(counting, i); return counting.size(); });
+		run_bench(results, options, benchmark, "formatxx", "span_writer", [&](std::size_t i) { formatxx::span_writer span(span_buffer, sizeof(span_buffer)); fn(span, i); return span.size(); });
+	}
+
+	std::size_t snprintf_size(int result) { return result > 0 ? static_cast<std::size_t>(result) : 0; }
+
+	void run_format_benches(std::vector<bench_result>& results, bench_options const& options, bench_values const& values)
+	{
+		char buffer[256];
+		alignas(formatxx::deferred_alignment) char record[256];
+		std::ostringstream stream;
+
+		auto stream_size = [&stream]() { std::size_t const size = static_cast<std::size_t>(stream.tellp()); stream.str(std::string()); return size; };
+
+		// integers
+		bench_formatxx_writers(results, options, "int64", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{}", values.ints[i]); });
+		run_bench(results, options, "int64", "formatxx-printf", "fixed_writer", [&](std::size_t i) { formatxx::fixed_writer<256> out; formatxx::printf(out, "%d", values.ints[i]); return out.size(); });
+		run_bench(results, options, "int64", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(values.ints[i]))); });
+		run_bench(results, options, "int64", "iostream", "ostringstream", [&](std::size_t i) { stream << values.ints[i]; return stream_size(); });
+
+		bench_formatxx_writers(results, options, "small_int", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{}", values.small_ints[i]); });
+		run_bench(results, options, "small_int", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%d", values.small_ints[i])); });
+
+		bench_formatxx_writers(results, options, "hex64", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{:x}", values.ints[i]); });
+		run_bench(results, options, "hex64", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%llx", static_cast<unsigned long long>(values.ints[i]))); });
+
+		// floats
+		bench_formatxx_writers(results, options, "double_shortest", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{}", values.doubles[i]); });
+		run_bench(results, options, "double_shortest", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%.17g", values.doubles[i])); });
+		run_bench(results, options, "double_shortest", "iostream", "ostringstream", [&](std::size_t i) { stream.precision(17); stream << values.doubles[i]; return stream_size(); });
+
+		bench_formatxx_writers(results, options, "double_fixed", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{:.3f}", values.doubles[i]); });
+		run_bench(results, options, "double_fixed", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%.3f", values.doubles[i])); });
+
+		// strings
+		bench_formatxx_writers(results, options, "strings", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "{}={}", values.strings[i], values.strings[(i + 1) % value_count]); });
+		run_bench(results, options, "strings", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "%s=%s", values.strings[i].c_str(), values.strings[(i + 1) % value_count].c_str())); });
+		run_bench(results, options, "strings", "iostream", "ostringstream", [&](std::size_t i) { stream << values.strings[i] << '=' << values.strings[(i + 1) % value_count]; return stream_size(); });
+
+		// padding-heavy specs
+		bench_formatxx_writers(results, options, "padded", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "[{:24}|{:-24}|{:#018x}]", values.small_ints[i], values.strings[i], values.ints[i]); });
+		run_bench(results, options, "padded", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "[%24d|%-24s|%#018llx]", values.small_ints[i], values.strings[i].c_str(), static_cast<unsigned long long>(values.ints[i]))); });
+
+		// narrow strings into wide output, transcoded in blocks
+		run_bench(results, options, "wide_strings", "formatxx", "wbuffered_writer", [&](std::size_t i) { formatxx::basic_buffered_writer<wchar_t, 256> out; formatxx::format(out, L"{}={}", values.strings[i], values.strings[(i + 1) % value_count]); return out.size() * sizeof(wchar_t); });
+		run_bench(results, options, "wide_strings", "swprintf", "wchar_t[256]", [&](std::size_t i) { wchar_t wide[256]; return snprintf_size(std::swprintf(wide, 256, L"%s=%s", values.strings[i].c_str(), values.strings[(i + 1) % value_count].c_str())) * sizeof(wchar_t); });
+
+		// mixed log-line, {} syntax against printf syntax
+		bench_formatxx_writers(results, options, "log_line", [&](formatxx::format_writer& out, std::size_t i) { formatxx::format(out, "[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]); });
+		run_bench(results, options, "log_line", "formatxx-deferred", "capture_format", [&](std::size_t i) { return formatxx::capture_format(record, sizeof(record), "[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]); });
+		run_bench(results, options, "log_line", "formatxx-printf", "fixed_writer", [&](std::size_t i) { formatxx::fixed_writer<256> out; formatxx::printf(out, "[%d] %s: request %d took %.2fms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]); return out.size(); });
+		run_bench(results, options, "log_line", "snprintf", "char[256]", [&](std::size_t i) { return snprintf_size(std::snprintf(buffer, sizeof(buffer), "[%d] %s: request %lld took %.2fms", values.small_ints[i], values.strings[i].c_str(), static_cast<long long>(values.ints[i]), values.doubles[i])); });
+		run_bench(results, options, "log_line", "iostream", "ostringstream", [&](std::size_t i) { stream.precision(2); stream << '[' << values.small_ints[i] << "] " << values.strings[i] << ": request " << values.ints[i] << " took " << std::fixed << values.doubles[i] << "ms" << std::defaultfloat; return stream_size(); });
+
+		// CSV export of 16 rows, a call per row against one batch call
+		constexpr std::size_t csv_rows = 16;
+		formatxx::compiled_format const csv("{},{},{:.3f}\n");
+		formatxx::buffered_writer<1024> rows_out;
+		run_bench(results, options, "csv_rows", "formatxx", "format loop", [&](std::size_t i) { rows_out.clear(); std::size_t const first = i % (value_count - csv_rows); for (std::size_t row = first; row != first + csv_rows; ++row) formatxx::format(rows_out, "{},{},{:.3f}\n", values.small_ints[row], values.ints[row], values.doubles[row]); return rows_out.size(); });
+		run_bench(results, options, "csv_rows", "formatxx", "format_rows", [&](std::size_t i) { rows_out.clear(); std::size_t const first = i % (value_count - csv_rows); formatxx::format_rows(rows_out, csv, csv_rows, &values.small_ints[first], &values.ints[first], &values.doubles[first]); return rows_out.size(); });
+
+		// a response built from 16 appends into one caller-owned string
+		std::string response;
+		run_bench(results, options, "append", "formatxx", "string_writer", [&](std::size_t i) { response.clear(); for (std::size_t part = 0; part != 16; ++part) { formatxx::string_writer out(std::move(response)); formatxx::format(out, "{}: {}\n", values.strings[(i + part) % value_count], values.ints[(i + part) % value_count]); response = std::move(out.str()); } return response.size(); });
+		run_bench(results, options, "append", "formatxx", "format_append", [&](std::size_t i) { response.clear(); for (std::size_t part = 0; part != 16; ++part) { formatxx::format_append(response, "{}: {}\n", values.strings[(i + part) % value_count], values.ints[(i + part) % value_count]); } return response.size(); });
+
+		// string-returning convenience APIs
+		run_bench(results, options, "format_string", "formatxx", "format_string", [&](std::size_t i) { return formatxx::format_string("[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]).size(); });
+		run_bench(results, options, "format_string", "formatxx", "scratch_format_string", [&](std::size_t i) { return formatxx::scratch_format_string("[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]).size(); });
+		run_bench(results, options, "format_string", "iostream", "ostringstream", [&](std::size_t i) { std::ostringstream out; out.precision(2); out << '[' << values.small_ints[i] << "] " << values.strings[i] << ": request " << values.ints[i] << " took " << std::fixed << values.doubles[i] << "ms"; return out.str().size(); });
+
+#if defined(FORMATXX_BENCH_FMT)
+		run_bench(results, options, "format_string", "fmt", "std::string", [&](std::size_t i) { return fmt::format("[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]).size(); });
+		run_bench(results, options, "int64", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "{}", values.ints[i]).size; });
+		run_bench(results, options, "hex64", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "{:x}", values.ints[i]).size; });
+		run_bench(results, options, "double_shortest", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "{}", values.doubles[i]).size; });
+		run_bench(results, options, "double_fixed", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "{:.3f}", values.doubles[i]).size; });
+		run_bench(results, options, "strings", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "{}={}", values.strings[i], values.strings[(i + 1) % value_count]).size; });
+		run_bench(results, options, "log_line", "fmt", "char[256]", [&](std::size_t i) { return fmt::format_to_n(buffer, sizeof(buffer), "[{}] {}: request {} took {:.2f}ms", values.small_ints[i], values.strings[i], values.ints[i], values.doubles[i]).size; });
+#endif
+	}
+
+#if defined(FORMATXX_BENCH_CXX)
+	/// Compiles the probe translation unit with extra_flags, measuring wall time and object size.
+	compile_result run_compile(std::string benchmark, char const* extra_flags)
+	{
+		compile_result result;
+		result.benchmark = std::move(benchmark);
+
+		std::string const object = std::string(FORMATXX_BENCH_OBJECT_DIR) + "/" + result.benchmark + ".o";
+		std::string const command = std::string("\"") + FORMATXX_BENCH_CXX + "\" -std=c++11 -O2 -c " + extra_flags +
+			" -I\"" FORMATXX_BENCH_INCLUDE "\" \"" FORMATXX_BENCH_PROBE "\" -o \"" + object + "\"";
+
+		auto const start = clock_type::now();
+		int const status = std::system(command.c_str());
+		auto const end = clock_type::now();
+
+		result.seconds = std::chrono::duration<double>(end - start).count();
+		result.ok = status == 0;
+
+		std::ifstream file(object, std::ios::binary | std::ios::ate);
+		if (file)
+		{
+			result.object_bytes = static_cast<std::size_t>(file.tellg());
+		}
+		return result;
+	}
+#endif
+
+	void run_compile_benches(std::vector<compile_result>& results, bench_options const& options)
+	{
+#if defined(FORMATXX_BENCH_CXX)
+		// the baseline probe includes only the standard headers, so the difference is the cost of formatxx
+		if (std::string("compile").find(options.filter) != std::string::npos)
+		{
+			results.push_back(run_compile("compile_baseline", "-DFORMATXX_BENCH_BASELINE"));
+			results.push_back(run_compile("compile_formatxx", ""));
+		}
+#else
+		(void)results;
+		(void)options;
+#endif
+	}
+
+	bool parse_options(int argc, char** argv, bench_options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--csv") == 0)
+			{
+				options.csv = true;
+			}
+			else if (std::strcmp(argv[i], "--no-compile") == 0)
+			{
+				options.compile = false;
+			}
+			else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			{
+				options.filter = argv[++i];
+			}
+			else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+			{
+				options.iterations = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+			}
+			else
+			{
+				std::fprintf(stderr, "usage: %s [--csv] [--filter <substring>] [--iterations <count>] [--no-compile]\n", argv[0]);
+				return false;
+			}
+		}
+		options.iterations = std::max(options.iterations, batch_size);
+		return true;
+	}
+
+	void print_json(std::vector<bench_result> const& results, std::vector<compile_result> const& compiles)
+	{
+		std::printf("{\n\t\"benchmarks\": [\n");
+		for (std::size_t i = 0; i != results.size(); ++i)
+		{
+			bench_result const& r = results[i];
+			std::printf("\t\t{\"benchmark\": \"%s\", \"library\": \"%s\", \"writer\": \"%s\", \"iterations\": %zu, \"ns_per_call\": %.2f, \"p50_ns\": %.2f, \"p99_ns\": %.2f, \"mb_per_sec\": %.2f}%s\n",
+				r.benchmark.c_str(), r.library.c_str(), r.writer.c_str(), r.iterations, r.ns_per_call, r.p50_ns, r.p99_ns, r.mb_per_sec, i + 1 != results.size() ? "," : "");
+		}
+		std::printf("\t],\n\t\"compile\": [\n");
+		for (std::size_t i = 0; i != compiles.size(); ++i)
+		{
+			compile_result const& c = compiles[i];
+			std::printf("\t\t{\"benchmark\": \"%s\", \"ok\": %s, \"seconds\": %.3f, \"object_bytes\": %zu}%s\n",
+				c.benchmark.c_str(), c.ok ? "true" : "false", c.seconds, c.object_bytes, i + 1 != compiles.size() ? "," : "");
+		}
+		std::printf("\t]\n}\n");
+	}
+
+	void print_csv(std::vector<bench_result> const& results, std::vector<compile_result> const& compiles)
+	{
+		std::printf("benchmark,library,writer,iterations,ns_per_call,p50_ns,p99_ns,mb_per_sec,seconds,object_bytes\n");
+		for (bench_result const& r : results)
+		{
+			std::printf("%s,%s,%s,%zu,%.2f,%.2f,%.2f,%.2f,,\n", r.benchmark.c_str(), r.library.c_str(), r.writer.c_str(), r.iterations, r.ns_per_call, r.p50_ns, r.p99_ns, r.mb_per_sec);
+		}
+		for (compile_result const& c : compiles)
+		{
+			std::printf("%s,%s,,,,,,,%.3f,%zu\n", c.benchmark.c_str(), c.ok ? "compiler" : "failed", c.seconds, c.object_bytes);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bench_options options;
+	if (!parse_options(argc, argv, options))
+	{
+		return 1;
+	}
+
+	bench_values const values;
+
+	std::vector<bench_result> results;
+	run_format_benches(results, options, values);
+
+	std::vector<compile_result> compiles;
+	if (options.compile)
+	{
+		run_compile_benches(compiles, options);
+	}
+
+	if (options.csv)
+	{
+		print_csv(results, compiles);
+	}
+	else
+	{
+		print_json(results, compiles);
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+// Translation unit compiled by formatxx_bench to measure the compile-time and
+// object-size cost of the formatxx headers. With FORMATXX_BENCH_BASELINE only the
+// equivalent standard headers are used, giving the reference point.
+
+#include <string>
+#include <cstdio>
+
+#if !defined(FORMATXX_BENCH_BASELINE)
+#	include <formatxx/format.h>
+#	include <formatxx/fixed.h>
+#	include <formatxx/buffered.h>
+#	include <formatxx/wide.h>
+#	include <formatxx/string.h>
+
+std::string bench_probe(int a, double b, char const* c)
+{
+	formatxx::fixed_writer<128> fixed;
+	formatxx::format(fixed, "{} {:.2f} {:-8}", a, b, c);
+
+	formatxx::buffered_writer<64> buffered;
+	formatxx::printf(buffered, "%d %s", a, c);
+
+	return formatxx::format_string("{}{}{}", fixed.c_str(), buffered.c_str(), b);
+}
+#else
+std::string bench_probe(int a, double b, char const* c)
+{
+	char buffer[128];
+	std::snprintf(buffer, sizeof(buffer), "%d %.2f %-8s", a, b, c);
+	return buffer;
+}
+#endif
@@ -0,0 +1,258 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/format.h>
+#include <formatxx/wide.h>
+#include <formatxx/binary.h>
+
+#include <vector>
+
+namespace formatxx {
+
+namespace {
+
+/// Reads the fields of one record body, failing sticky on truncation.
+class binary_reader
+{
+public:
+	binary_reader(char const* first, char const* last) : _iter(first), _end(last) {}
+
+	bool ok() const { return _ok; }
+	char const* position() const { return _iter; }
+
+	std::uint8_t byte()
+	{
+		if (_iter == _end)
+		{
+			_ok = false;
+			return 0;
+		}
+		return static_cast<std::uint8_t>(*_iter++);
+	}
+
+	std::uint64_t varint()
+	{
+		std::uint64_t value = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7)
+		{
+			std::uint8_t const next = byte();
+			value |= static_cast<std::uint64_t>(next & 0x7F) << shift;
+			if ((next & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+		_ok = false;
+		return 0;
+	}
+
+	std::int64_t zigzag()
+	{
+		std::uint64_t const value = varint();
+		return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+	}
+
+	std::uint64_t fixed(std::size_t bytes)
+	{
+		std::uint64_t bits = 0;
+		for (std::size_t i = 0; i != bytes; ++i)
+		{
+			bits |= static_cast<std::uint64_t>(byte()) << (i * 8);
+		}
+		return bits;
+	}
+
+	char const* skip(std::size_t size)
+	{
+		if (static_cast<std::size_t>(_end - _iter) < size)
+		{
+			_ok = false;
+			return _iter;
+		}
+		char const* const result = _iter;
+		_iter += size;
+		return result;
+	}
+
+private:
+	char const* _iter = nullptr;
+	char const* _end = nullptr;
+	bool _ok = true;
+};
+
+/// Storage for decoded arguments that the packed argument cannot hold by value.
+struct decoded_storage
+{
+	std::wstring wide_text;
+	basic_string_view<wchar_t> wide_view;
+};
+
+bool decode_arg(binary_reader& reader, basic_format_arg<char>& arg, decoded_storage& storage)
+{
+	switch (static_cast<binary_tag>(reader.byte()))
+	{
+	case binary_tag::boolean: arg = basic_format_arg<char>(reader.byte() != 0); break;
+	case binary_tag::character: arg = basic_format_arg<char>(static_cast<char>(reader.byte())); break;
+	case binary_tag::wide_character:
+		storage.wide_text.assign(1, static_cast<wchar_t>(reader.varint()));
+		arg = basic_format_arg<char>(&_detail::format_value_thunk<char, wchar_t>, storage.wide_text.c_str());
+		break;
+	case binary_tag::signed8: arg = basic_format_arg<char>(static_cast<signed char>(reader.zigzag())); break;
+	case binary_tag::signed16: arg = basic_format_arg<char>(static_cast<signed short>(reader.zigzag())); break;
+	case binary_tag::signed32: arg = basic_format_arg<char>(static_cast<signed int>(reader.zigzag())); break;
+	case binary_tag::signed64: arg = basic_format_arg<char>(static_cast<signed long long>(reader.zigzag())); break;
+	case binary_tag::unsigned8: arg = basic_format_arg<char>(static_cast<unsigned char>(reader.varint())); break;
+	case binary_tag::unsigned16: arg = basic_format_arg<char>(static_cast<unsigned short>(reader.varint())); break;
+	case binary_tag::unsigned32: arg = basic_format_arg<char>(static_cast<unsigned int>(reader.varint())); break;
+	case binary_tag::unsigned64: arg = basic_format_arg<char>(static_cast<unsigned long long>(reader.varint())); break;
+	case binary_tag::float32:
+	{
+		std::uint32_t const bits = static_cast<std::uint32_t>(reader.fixed(4));
+		float value;
+		std::memcpy(&value, &bits, sizeof(bits));
+		arg = basic_format_arg<char>(value);
+		break;
+	}
+	case binary_tag::float64:
+	{
+		std::uint64_t const bits = reader.fixed(8);
+		double value;
+		std::memcpy(&value, &bits, sizeof(bits));
+		arg = basic_format_arg<char>(value);
+		break;
+	}
+	case binary_tag::string:
+	{
+		std::size_t const size = static_cast<std::size_t>(reader.varint());
+		arg = basic_format_arg<char>(string_view(reader.skip(size), size));
+		break;
+	}
+	case binary_tag::wide_string:
+	{
+		std::size_t const size = static_cast<std::size_t>(reader.varint());
+		for (std::size_t i = 0; i != size && reader.ok(); ++i)
+		{
+			storage.wide_text.push_back(static_cast<wchar_t>(reader.varint()));
+		}
+		storage.wide_view = basic_string_view<wchar_t>(storage.wide_text.c_str(), storage.wide_text.size());
+		arg = basic_format_arg<char>(&_detail::format_value_thunk<char, basic_string_view<wchar_t>>, &storage.wide_view);
+		break;
+	}
+	case binary_tag::pointer: arg = basic_format_arg<char>(reinterpret_cast<void const*>(static_cast<std::uintptr_t>(reader.varint()))); break;
+	case binary_tag::bytes:
+	{
+		std::size_t const size = static_cast<std::size_t>(reader.varint());
+		arg = basic_format_arg<char>(hex_bytes(reader.skip(size), size));
+		break;
+	}
+	default:
+		return false;
+	}
+	return reader.ok();
+}
+
+} // anonymous namespace
+
+std::uint64_t format_registry::next_serial()
+{
+	static std::atomic<std::uint64_t> serial(0);
+	return ++serial;
+}
+
+std::uint32_t format_registry::intern(string_view format)
+{
+	std::string key(format.data(), format.size());
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto const found = _ids.find(key);
+	if (found != _ids.end())
+	{
+		return found->second;
+	}
+
+	std::uint32_t const id = static_cast<std::uint32_t>(_strings.size());
+	_strings.push_back(key);
+	_ids.emplace(std::move(key), id);
+	return id;
+}
+
+string_view format_registry::lookup(std::uint32_t id) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (id >= _strings.size())
+	{
+		return {};
+	}
+	return {_strings[id].c_str(), _strings[id].size()};
+}
+
+std::size_t format_registry::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _strings.size();
+}
+
+FORMATXX_PUBLIC result_code FORMATXX_API decode_record(format_writer& out, format_registry const& registry, string_view& input)
+{
+	binary_reader framing(input.data(), input.data() + input.size());
+	std::size_t const body_size = static_cast<std::size_t>(framing.varint());
+	char const* const body = framing.skip(body_size);
+	if (!framing.ok())
+	{
+		return result_code::malformed_input;
+	}
+
+	// the record is consumed even if its contents turn out to be bad
+	input = string_view(framing.position(), input.data() + input.size());
+
+	binary_reader reader(body, body + body_size);
+	string_view const format = registry.lookup(static_cast<std::uint32_t>(reader.varint()));
+	std::uint8_t const syntax = reader.byte();
+	std::size_t const count = static_cast<std::size_t>(reader.varint());
+	if (!reader.ok() || format.data() == nullptr || count > body_size)
+	{
+		return result_code::malformed_input;
+	}
+
+	std::vector<basic_format_arg<char>> packed(count);
+	std::vector<decoded_storage> storage(count);
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		if (!decode_arg(reader, packed[i], storage[i]))
+		{
+			return result_code::malformed_input;
+		}
+	}
+
+	basic_format_args<char> const args(count, packed.data());
+	return syntax == static_cast<std::uint8_t>(_detail::binary_syntax::printf) ? _detail::printf_impl(out, format, args) : _detail::format_impl(out, format, args);
+}
+
+} // namespace formatxx
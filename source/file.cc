@@ -0,0 +1,119 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/file.h>
+
+#include <cerrno>
+
+#if defined(_WIN32)
+#	if !defined(WIN32_LEAN_AND_MEAN)
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace formatxx {
+namespace _detail {
+
+namespace {
+
+bool write_fd(int fd, char const* data, std::size_t bytes)
+{
+	while (bytes != 0)
+	{
+#if defined(_WIN32)
+		unsigned const chunk = bytes > 0x40000000 ? 0x40000000U : static_cast<unsigned>(bytes);
+		int const written = ::_write(fd, data, chunk);
+#else
+		auto const written = ::write(fd, data, bytes);
+#endif
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		data += written;
+		bytes -= static_cast<std::size_t>(written);
+	}
+	return true;
+}
+
+#if defined(_WIN32)
+bool write_handle(void* handle, char const* data, std::size_t bytes)
+{
+	while (bytes != 0)
+	{
+		DWORD const chunk = bytes > 0x40000000 ? 0x40000000UL : static_cast<DWORD>(bytes);
+		DWORD written = 0;
+		if (!::WriteFile(static_cast<HANDLE>(handle), data, chunk, &written, nullptr))
+		{
+			return false;
+		}
+		data += written;
+		bytes -= written;
+	}
+	return true;
+}
+#endif
+
+} // anonymous namespace
+
+FORMATXX_PUBLIC bool FORMATXX_API write_file_target(file_target const& target, void const* data, std::size_t bytes)
+{
+	char const* const first = static_cast<char const*>(data);
+
+	switch (target.type)
+	{
+	case file_target::kind::fd:
+		return write_fd(target.fd, first, bytes);
+	case file_target::kind::file:
+		return std::fwrite(first, 1, bytes, target.file) == bytes;
+#if defined(_WIN32)
+	case file_target::kind::handle:
+		return write_handle(target.handle, first, bytes);
+#endif
+	default:
+		return false;
+	}
+}
+
+FORMATXX_PUBLIC bool FORMATXX_API flush_file_target(file_target const& target)
+{
+	return target.type != file_target::kind::file || std::fflush(target.file) == 0;
+}
+
+} // namespace _detail
+} // namespace formatxx
@@ -30,6 +30,10 @@
 
 #include <formatxx/format.h>
 #include <formatxx/wide.h>
+#include <formatxx/compiled.h>
+#include <formatxx/batch.h>
+#include <formatxx/static_format.h>
+#include <formatxx/parser.h>
 
 #include <formatxx/_detail/format_traits.h>
 #include <formatxx/_detail/parse_unsigned.h>
@@ -37,43 +41,79 @@
 #include <formatxx/_detail/write_integer.h>
 #include <formatxx/_detail/write_string.h>
 #include <formatxx/_detail/write_float.h>
+#include <formatxx/_detail/write_hex_bytes.h>
+#include <formatxx/_detail/format_arg_impl.h>
 #include <formatxx/_detail/format_impl.h>
 #include <formatxx/_detail/printf_impl.h>
+#include <formatxx/_detail/compile_impl.h>
+#include <formatxx/_detail/parser_impl.h>
 
 #include <cstdio>
 
 namespace formatxx {
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char value, string_view spec) { _detail::write_char(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char const* value, string_view spec) { _detail::write_string<char>(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char* value, string_view spec) { _detail::write_string<char>(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, string_view value, string_view spec) { _detail::write_string<char>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char value, string_view spec) { _detail::write_char(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char value, format_spec const& spec) { _detail::write_char(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char const* value, string_view spec) { _detail::write_string<char>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char const* value, format_spec const& spec) { _detail::write_string<char>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char* value, string_view spec) { _detail::write_string<char>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char* value, format_spec const& spec) { _detail::write_string<char>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, string_view value, string_view spec) { _detail::write_string<char>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, string_view value, format_spec const& spec) { _detail::write_string<char>(out, value, spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed int value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed char value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed short value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long long value, string_view spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed int value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed int value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed char value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed char value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed short value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed short value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long long value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, signed long long value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned int value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned char value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned short value, string_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long long value, string_view spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned int value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned int value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned char value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned char value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned short value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned short value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long long value, string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, unsigned long long value, format_spec const& spec) { _detail::write_integer(out, value, spec); }
 
 FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, bool value, string_view spec)
 {
-	format_value(out, value ? _detail::FormatTraits<char>::sTrue : _detail::FormatTraits<char>::sFalse, spec);
+	_detail::write_string(out, value ? _detail::FormatTraits<char>::sTrue : _detail::FormatTraits<char>::sFalse, parse_format_spec(spec));
 }
 
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, bool value, format_spec const& spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char>::sTrue : _detail::FormatTraits<char>::sFalse, spec);
+}
+
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, float value, string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, float value, format_spec const& spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, double value, string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, double value, format_spec const& spec) { _detail::write_float(out, value, spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, float value, string_view spec) { _detail::write_float(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, double value, string_view spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void* ptr, string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void* ptr, format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void const* ptr, string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void const* ptr, format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void* ptr, string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, void const* ptr, string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, hex_bytes bytes, string_view spec) { _detail::write_hex_bytes(out, bytes, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, hex_bytes bytes, format_spec const& spec) { _detail::write_hex_bytes(out, bytes, spec); }
 
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_builtin_arg(basic_format_writer<char>& out, basic_format_arg<char> const& arg, basic_string_view<char> spec_string, basic_format_spec<char> const* spec);
 template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_impl(basic_format_writer<char>& out, basic_string_view<char> format, basic_format_args<char> args);
 template FORMATXX_PUBLIC result_code FORMATXX_API _detail::printf_impl(basic_format_writer<char>& out, basic_string_view<char> format, basic_format_args<char> args);
 template FORMATXX_PUBLIC basic_format_spec<char> FORMATXX_API parse_format_spec(basic_string_view<char>);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::compile_format_impl(std::vector<_detail::compiled_segment<char>>& segments, basic_string_view<char> format, format_syntax syntax);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::compiled_format_impl(basic_format_writer<char>& out, _detail::compiled_segment<char> const* segments, std::size_t count, basic_format_args<char> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_rows_impl(basic_format_writer<char>& out, _detail::compiled_segment<char> const* segments, std::size_t count, _detail::batch_column<char> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::static_format_impl(basic_format_writer<char>& out, char const* format, _detail::static_segment const* segments, std::size_t count, basic_format_args<char> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::parse_format_chunk(basic_format_writer<char>& out, basic_format_args<char> const& args, _detail::parser_state<char>& state, basic_string_view<char> chunk);
 } // namespace formatxx
\ No newline at end of file
@@ -0,0 +1,284 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/format.h>
+#include <formatxx/instrument.h>
+#include <formatxx/_detail/format_traits.h>
+#include <formatxx/_detail/instrument_impl.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace formatxx {
+namespace _detail {
+
+namespace {
+
+constexpr std::size_t table_size = 256;
+constexpr std::size_t max_probes = 16;
+
+/// One thread's entries. Tables are never freed; a thread that exits returns its table for reuse.
+struct instrument_table
+{
+	instrument_entry entries[table_size];
+	instrument_entry overflow;
+	instrument_table* next = nullptr;
+	instrument_table* next_free = nullptr;
+};
+
+struct instrument_registry
+{
+	std::mutex mutex;
+	instrument_table* tables = nullptr;
+	instrument_table* free = nullptr;
+};
+
+std::atomic<unsigned> mode(0);
+
+/// Leaked, so that threads exiting during static destruction can still return their tables.
+instrument_registry& registry()
+{
+	static instrument_registry* const instance = new instrument_registry;
+	return *instance;
+}
+
+instrument_table* acquire_table()
+{
+	instrument_registry& shared = registry();
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	if (shared.free != nullptr)
+	{
+		instrument_table* const table = shared.free;
+		shared.free = table->next_free;
+		return table;
+	}
+
+	instrument_table* const table = new instrument_table();
+	char const other[] = "(other)";
+	std::copy_n(other, sizeof(other) - 1, table->overflow.text);
+	table->overflow.text_size = sizeof(other) - 1;
+	table->next = shared.tables;
+	shared.tables = table;
+	return table;
+}
+
+struct thread_table
+{
+	~thread_table()
+	{
+		if (table != nullptr)
+		{
+			instrument_registry& shared = registry();
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			table->next_free = shared.free;
+			shared.free = table;
+		}
+	}
+
+	instrument_table* table = nullptr;
+};
+
+instrument_table& local_table()
+{
+	static thread_local thread_table local;
+	if (local.table == nullptr)
+	{
+		local.table = acquire_table();
+	}
+	return *local.table;
+}
+
+std::size_t site_hash(void const* site)
+{
+	std::uint64_t const bits = reinterpret_cast<std::uintptr_t>(site);
+	return static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> 32) & (table_size - 1);
+}
+
+} // anonymous namespace
+
+unsigned instrument_mode() { return mode.load(std::memory_order_relaxed); }
+
+instrument_entry* instrument_lookup(void const* site)
+{
+	instrument_table& table = local_table();
+	std::size_t const start = site_hash(site);
+	for (std::size_t probe = 0; probe != max_probes; ++probe)
+	{
+		instrument_entry& entry = table.entries[(start + probe) & (table_size - 1)];
+		void const* const key = entry.site.load(std::memory_order_relaxed);
+		if (key == site)
+		{
+			return &entry;
+		}
+		if (key == nullptr)
+		{
+			return nullptr;
+		}
+	}
+	return &table.overflow;
+}
+
+instrument_entry* instrument_insert(void const* site, string_view text)
+{
+	instrument_table& table = local_table();
+	std::size_t const start = site_hash(site);
+	for (std::size_t probe = 0; probe != max_probes; ++probe)
+	{
+		instrument_entry& entry = table.entries[(start + probe) & (table_size - 1)];
+		if (entry.site.load(std::memory_order_relaxed) == nullptr)
+		{
+			// the text is complete before the site is published to snapshots
+			entry.text_size = text.size() < instrument_entry::text_capacity ? text.size() : instrument_entry::text_capacity;
+			std::copy_n(text.data(), entry.text_size, entry.text);
+			entry.site.store(site, std::memory_order_release);
+			return &entry;
+		}
+	}
+	return &table.overflow;
+}
+
+} // namespace _detail
+
+FORMATXX_PUBLIC bool FORMATXX_API enable_instrumentation(bool ticks)
+{
+#if defined(FORMATXX_INSTRUMENT)
+	_detail::mode.store(_detail::instrument_counts | (ticks ? _detail::instrument_ticks : 0u), std::memory_order_relaxed);
+	return true;
+#else
+	(void)ticks;
+	return false;
+#endif
+}
+
+FORMATXX_PUBLIC void FORMATXX_API disable_instrumentation()
+{
+	_detail::mode.store(0, std::memory_order_relaxed);
+}
+
+FORMATXX_PUBLIC void FORMATXX_API reset_instrumentation()
+{
+	_detail::instrument_registry& shared = _detail::registry();
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	auto clear = [](_detail::instrument_entry& entry)
+	{
+		entry.calls.store(0, std::memory_order_relaxed);
+		entry.bytes.store(0, std::memory_order_relaxed);
+		entry.writes.store(0, std::memory_order_relaxed);
+		entry.out_of_range.store(0, std::memory_order_relaxed);
+		entry.malformed.store(0, std::memory_order_relaxed);
+		entry.ticks.store(0, std::memory_order_relaxed);
+	};
+
+	for (_detail::instrument_table* table = shared.tables; table != nullptr; table = table->next)
+	{
+		for (_detail::instrument_entry& entry : table->entries)
+		{
+			clear(entry);
+		}
+		clear(table->overflow);
+	}
+}
+
+FORMATXX_PUBLIC void FORMATXX_API instrumentation_snapshot(std::vector<format_site_stats>& stats)
+{
+	stats.clear();
+	std::unordered_map<void const*, std::size_t> index;
+
+	auto collect = [&](_detail::instrument_entry const& entry, void const* site)
+	{
+		std::uint64_t const calls = entry.calls.load(std::memory_order_relaxed);
+		if (calls == 0)
+		{
+			return;
+		}
+
+		auto const found = index.emplace(site, stats.size());
+		if (found.second)
+		{
+			stats.emplace_back();
+			stats.back().site = site;
+			stats.back().format.assign(entry.text, entry.text_size);
+		}
+
+		format_site_stats& totals = stats[found.first->second];
+		totals.calls += calls;
+		totals.bytes += entry.bytes.load(std::memory_order_relaxed);
+		totals.writes += entry.writes.load(std::memory_order_relaxed);
+		totals.out_of_range += entry.out_of_range.load(std::memory_order_relaxed);
+		totals.malformed += entry.malformed.load(std::memory_order_relaxed);
+		totals.ticks += entry.ticks.load(std::memory_order_relaxed);
+	};
+
+	{
+		_detail::instrument_registry& shared = _detail::registry();
+		std::lock_guard<std::mutex> lock(shared.mutex);
+		for (_detail::instrument_table const* table = shared.tables; table != nullptr; table = table->next)
+		{
+			for (_detail::instrument_entry const& entry : table->entries)
+			{
+				void const* const site = entry.site.load(std::memory_order_acquire);
+				if (site != nullptr)
+				{
+					collect(entry, site);
+				}
+			}
+			collect(table->overflow, nullptr);
+		}
+	}
+
+	std::sort(stats.begin(), stats.end(), [](format_site_stats const& lhs, format_site_stats const& rhs)
+	{
+		if (lhs.ticks != rhs.ticks)
+		{
+			return lhs.ticks > rhs.ticks;
+		}
+		if (lhs.bytes != rhs.bytes)
+		{
+			return lhs.bytes > rhs.bytes;
+		}
+		return lhs.calls > rhs.calls;
+	});
+}
+
+FORMATXX_PUBLIC void FORMATXX_API dump_instrumentation(format_writer& out)
+{
+	// snapshot first, since formatting the table may itself be instrumented
+	std::vector<format_site_stats> stats;
+	instrumentation_snapshot(stats);
+
+	format(out, "{:12} {:14} {:12} {:8} {:9} {:16}  format\n", "calls", "bytes", "writes", "range", "malformed", "ticks");
+	for (format_site_stats const& site : stats)
+	{
+		format(out, "{:12} {:14} {:12} {:8} {:9} {:16}  {}\n", site.calls, site.bytes, site.writes, site.out_of_range, site.malformed, site.ticks, string_view(site.format.c_str(), site.format.size()));
+	}
+}
+
+} // namespace formatxx
@@ -0,0 +1,269 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/log_sink.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace formatxx {
+
+constexpr std::size_t log_sink::slot_payload;
+
+log_sink::log_sink(int fd, std::size_t capacity, overflow_policy overflow) : _out(fd), _overflow(overflow)
+{
+	_start(capacity);
+}
+
+log_sink::log_sink(std::FILE* file, std::size_t capacity, overflow_policy overflow) : _out(file), _overflow(overflow)
+{
+	_start(capacity);
+}
+
+log_sink::~log_sink()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop.store(true, std::memory_order_release);
+	}
+	_wake.notify_one();
+	_thread.join();
+	_out.flush();
+}
+
+void log_sink::_start(std::size_t capacity)
+{
+	std::size_t size = 2;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+
+	_slots.reset(new slot[size]);
+	_mask = size - 1;
+	for (std::size_t i = 0; i != size; ++i)
+	{
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	_enqueue_pos.store(0, std::memory_order_relaxed);
+	_flushed_pos.store(0, std::memory_order_relaxed);
+	_dropped.store(0, std::memory_order_relaxed);
+	_waiting.store(false, std::memory_order_relaxed);
+	_stop.store(false, std::memory_order_relaxed);
+
+	_thread = std::thread([this]() { _run(); });
+}
+
+bool log_sink::submit(string_view record)
+{
+	// a record that cannot fit in the ring at all is queued in ring-sized pieces
+	std::size_t const max_bytes = (_mask + 1) * slot_payload;
+	char const* data = record.data();
+	std::size_t remaining = record.size();
+	bool queued = true;
+
+	while (remaining > max_bytes)
+	{
+		queued = _enqueue(data, max_bytes, false) && queued;
+		data += max_bytes;
+		remaining -= max_bytes;
+	}
+	return _enqueue(data, remaining, false) && queued;
+}
+
+void* log_sink::_capture_buffer(std::size_t size)
+{
+	static thread_local std::unique_ptr<std::max_align_t[]> buffer;
+	static thread_local std::size_t capacity = 0;
+
+	if (size > capacity)
+	{
+		capacity = size > 256 ? size : 256;
+		buffer.reset(new std::max_align_t[(capacity + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+	}
+	return buffer.get();
+}
+
+bool log_sink::_enqueue(char const* data, std::size_t size, bool deferred)
+{
+	if (size == 0)
+	{
+		return true;
+	}
+
+	std::size_t const count = (size + slot_payload - 1) / slot_payload;
+
+	// a captured record can't be split, so it must fit in the ring
+	if (deferred && count > _mask + 1)
+	{
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// claim count consecutive positions; the flusher frees slots in order, so the
+	// whole run is free once its last slot is
+	std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		std::size_t const last = pos + count - 1;
+		std::size_t const sequence = _slots[last & _mask].sequence.load(std::memory_order_acquire);
+		std::intptr_t const difference = static_cast<std::intptr_t>(sequence - last);
+
+		if (difference == 0)
+		{
+			if (_enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (difference < 0)
+		{
+			// the ring is full
+			if (_overflow == overflow_policy::drop)
+			{
+				_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			_wake.notify_one();
+			std::this_thread::yield();
+			pos = _enqueue_pos.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			pos = _enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	for (std::size_t i = 0; i != count; ++i)
+	{
+		slot& target = _slots[(pos + i) & _mask];
+		std::size_t const length = size < slot_payload ? size : slot_payload;
+		std::memcpy(target.data, data, length);
+		target.length = static_cast<std::uint32_t>(length);
+		target.deferred = deferred && i == 0;
+		target.sequence.store(pos + i + 1, std::memory_order_release);
+		data += length;
+		size -= length;
+	}
+
+	if (_waiting.load(std::memory_order_acquire))
+	{
+		_wake.notify_one();
+	}
+	return true;
+}
+
+void log_sink::flush()
+{
+	std::size_t const target = _enqueue_pos.load(std::memory_order_acquire);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_wake.notify_one();
+	_flushed.wait(lock, [this, target]() { return _flushed_pos.load(std::memory_order_acquire) >= target; });
+}
+
+void log_sink::_consume(slot const& source)
+{
+	if (_record_pending == 0 && source.deferred == 0)
+	{
+		_out.write({source.data, source.length});
+		return;
+	}
+
+	// reassemble the captured record into aligned storage
+	if (_record_pending == 0)
+	{
+		_record_size = deferred_record_size(source.data);
+		_record_pending = _record_size;
+		if (_record_size > _record_capacity)
+		{
+			_record_capacity = _record_size;
+			_record.reset(new std::max_align_t[(_record_capacity + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+		}
+	}
+
+	char* const record = reinterpret_cast<char*>(_record.get());
+	std::memcpy(record + (_record_size - _record_pending), source.data, source.length);
+	_record_pending -= source.length;
+
+	if (_record_pending == 0)
+	{
+		replay_format(_out, record);
+	}
+}
+
+void log_sink::_run()
+{
+	std::size_t const capacity = _mask + 1;
+
+	for (;;)
+	{
+		bool progressed = false;
+		for (;;)
+		{
+			slot& source = _slots[_dequeue_pos & _mask];
+			if (source.sequence.load(std::memory_order_acquire) != _dequeue_pos + 1)
+			{
+				break;
+			}
+
+			_consume(source);
+			source.sequence.store(_dequeue_pos + capacity, std::memory_order_release);
+			++_dequeue_pos;
+			progressed = true;
+		}
+
+		if (progressed)
+		{
+			_out.flush();
+			std::lock_guard<std::mutex> lock(_mutex);
+			_flushed_pos.store(_dequeue_pos, std::memory_order_release);
+			_flushed.notify_all();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_stop.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		// producers notify without the lock, so a missed wake-up only costs the timeout
+		_waiting.store(true, std::memory_order_seq_cst);
+		if (_slots[_dequeue_pos & _mask].sequence.load(std::memory_order_seq_cst) != _dequeue_pos + 1)
+		{
+			_wake.wait_for(lock, std::chrono::milliseconds(5));
+		}
+		_waiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+} // namespace formatxx
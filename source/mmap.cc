@@ -0,0 +1,130 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+
+#include <formatxx/mmap.h>
+
+#if defined(_WIN32)
+#	if !defined(WIN32_LEAN_AND_MEAN)
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#	include <io.h>
+#else
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+namespace formatxx {
+namespace _detail {
+
+namespace {
+
+#if defined(_WIN32)
+HANDLE os_handle(mapped_file const& file)
+{
+	return file.handle != nullptr ? static_cast<HANDLE>(file.handle) : reinterpret_cast<HANDLE>(::_get_osfhandle(file.fd));
+}
+#endif
+
+void unmap_view(mapped_file& file)
+{
+	if (file.data != nullptr)
+	{
+#if defined(_WIN32)
+		::UnmapViewOfFile(file.data);
+		::CloseHandle(static_cast<HANDLE>(file.mapping));
+		file.mapping = nullptr;
+#else
+		::munmap(file.data, file.bytes);
+#endif
+		file.data = nullptr;
+	}
+	file.bytes = 0;
+}
+
+bool resize_file(mapped_file const& file, std::size_t bytes)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER size;
+	size.QuadPart = static_cast<LONGLONG>(bytes);
+	return ::SetFilePointerEx(os_handle(file), size, nullptr, FILE_BEGIN) && ::SetEndOfFile(os_handle(file));
+#else
+	return ::ftruncate(file.fd, static_cast<off_t>(bytes)) == 0;
+#endif
+}
+
+} // anonymous namespace
+
+FORMATXX_PUBLIC bool FORMATXX_API remap_file(mapped_file& file, std::size_t bytes)
+{
+	unmap_view(file);
+	if (bytes == 0 || !resize_file(file, bytes))
+	{
+		return false;
+	}
+
+#if defined(_WIN32)
+	ULARGE_INTEGER size;
+	size.QuadPart = bytes;
+	HANDLE const mapping = ::CreateFileMappingW(os_handle(file), nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+	if (mapping == nullptr)
+	{
+		return false;
+	}
+
+	void* const data = ::MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, bytes);
+	if (data == nullptr)
+	{
+		::CloseHandle(mapping);
+		return false;
+	}
+	file.mapping = mapping;
+#else
+	void* const data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+#endif
+
+	file.data = data;
+	file.bytes = bytes;
+	return true;
+}
+
+FORMATXX_PUBLIC bool FORMATXX_API unmap_file(mapped_file& file, std::size_t bytes)
+{
+	unmap_view(file);
+	return resize_file(file, bytes);
+}
+
+} // namespace _detail
+} // namespace formatxx
@@ -31,13 +31,34 @@
 #include <formatxx/format.h>
 #include <formatxx/fixed.h>
 #include <formatxx/buffered.h>
+#include <formatxx/arena.h>
 #include <formatxx/wide.h>
+#include <formatxx/unicode.h>
 #include <formatxx/string.h>
+#include <formatxx/append.h>
+#include <formatxx/counting.h>
+#include <formatxx/span.h>
+#include <formatxx/iovec.h>
+#include <formatxx/file.h>
+#include <formatxx/log_sink.h>
+#include <formatxx/mmap.h>
+#include <formatxx/deferred.h>
+#include <formatxx/binary.h>
+#include <formatxx/compiled.h>
+#include <formatxx/batch.h>
+#include <formatxx/static_format.h>
+#include <formatxx/instrument.h>
+#include <formatxx/parser.h>
 
 #include <iostream>
 #include <string>
 #include <cstdint>
 #include <limits>
+#include <cstdio>
+#include <set>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 static int formatxx_tests = 0;
 static int formatxx_failed = 0;
@@ -49,8 +70,8 @@ static std::basic_string<CharT> format_into(WriterT& writer, FormatT const& form
 	return {writer.c_str(), writer.size()};
 }
 
-template <typename CharT, typename ValueT>
-static std::basic_string<CharT> format_value_string(ValueT const& value, formatxx::basic_string_view<CharT> spec = {})
+template <typename CharT, typename ValueT, typename SpecT = formatxx::basic_string_view<CharT>>
+static std::basic_string<CharT> format_value_string(ValueT const& value, SpecT const& spec = {})
 {
 	formatxx::basic_string_writer<std::basic_string<CharT>> writer;
 	format_value(writer, value, spec);
@@ -85,6 +106,13 @@ static std::ostream& operator<<(std::ostream& os, formatxx::result_code result)
 	return os;
 }
 
+// UTF-16 and UTF-32 results are reported as UTF-8
+static std::ostream& operator<<(std::ostream& os, std::u16string const& str) { return os << formatxx::format_string("{}", str); }
+static std::ostream& operator<<(std::ostream& os, std::u32string const& str) { return os << formatxx::format_string("{}", str); }
+#if defined(__cpp_char8_t)
+static std::ostream& operator<<(std::ostream& os, std::u8string const& str) { return os << formatxx::format_string("{}", str); }
+#endif
+
 #define CHECK_FORMAT_HELPER(out, expected, expr) \
 	do{ \
 		++formatxx_tests; \
@@ -104,6 +132,15 @@ static std::ostream& operator<<(std::ostream& os, formatxx::result_code result)
 #define CHECK_WFORMAT(expected, ...) \
 	CHECK_FORMAT_HELPER(std::wcerr, (expected), formatxx::format_string<std::wstring>(__VA_ARGS__))
 
+#define CHECK_U16FORMAT(expected, ...) \
+	CHECK_FORMAT_HELPER(std::cerr, std::u16string(expected), formatxx::format_string<std::u16string>(__VA_ARGS__))
+
+#define CHECK_U32FORMAT(expected, ...) \
+	CHECK_FORMAT_HELPER(std::cerr, std::u32string(expected), formatxx::format_string<std::u32string>(__VA_ARGS__))
+
+#define CHECK_U8FORMAT(expected, ...) \
+	CHECK_FORMAT_HELPER(std::cerr, std::u8string(expected), formatxx::format_string<std::u8string>(__VA_ARGS__))
+
 #define CHECK_FORMAT_RESULT(expected, ...) \
 	CHECK_FORMAT_HELPER(std::cerr, (expected), format_result<char>(__VA_ARGS__))
 
@@ -136,6 +173,35 @@ static void test_fixed()
 	// should truncate
 	buffer.clear();
 	CHECK_FORMAT_WRITER("test 1234", buffer, "test {0}", /*too big*/1234567890LL);
+
+	// padding should truncate too
+	buffer.clear();
+	CHECK_FORMAT_WRITER("x        ", buffer, "x{:20}", 7);
+	buffer.clear();
+	CHECK_FORMAT_WRITER("ab     42", buffer, "ab{:7}", 42);
+
+	// the put functions fill the window and still truncate at the end
+	buffer.clear();
+	buffer.put("abc");
+	buffer.put_fill('-', 3);
+	buffer.put("wxyz");
+	CHECK_FORMAT_HELPER(std::cerr, std::string("abc---wxy"), std::string(buffer.c_str()));
+
+	// copies carry their own window
+	formatxx::fixed_writer<10> copy(buffer);
+	copy.clear();
+	CHECK_FORMAT_WRITER("7", copy, "{}", 7);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("abc---wxy"), std::string(buffer.c_str()));
+	copy = buffer;
+	copy.clear();
+	copy.put("no");
+	CHECK_FORMAT_HELPER(std::cerr, std::string("no"), std::string(copy.c_str()));
+	CHECK_FORMAT_HELPER(std::cerr, 9, buffer.size());
+
+	// const access to the contents, with or without the NUL terminator
+	formatxx::fixed_writer<10> const& view = buffer;
+	CHECK_FORMAT_HELPER(std::cerr, std::string("abc---wxy"), std::string(view.data(), view.size()));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("abc---wxy"), std::string(view.c_str()));
 }
 
 static void test_integers()
@@ -163,6 +229,13 @@ static void test_integers()
 	CHECK_FORMAT("-2147483648", "{}", std::numeric_limits<std::int32_t>::min());
 	CHECK_FORMAT("-9223372036854775808", "{}", std::numeric_limits<std::int64_t>::min());
 
+	// digit count boundaries on both the 32-bit and 64-bit paths
+	CHECK_FORMAT("9 10 99 100 999999999 1000000000", "{} {} {} {} {} {}", 9, 10, 99, 100, 999999999, 1000000000);
+	CHECK_FORMAT("4294967295 4294967296", "{} {}", std::numeric_limits<std::uint32_t>::max(), std::uint64_t(1) << 32);
+	CHECK_FORMAT("9999999999999999999 10000000000000000000", "{} {}", 9999999999999999999ULL, 10000000000000000000ULL);
+	CHECK_FORMAT("18446744073709551615", "{}", std::numeric_limits<std::uint64_t>::max());
+	CHECK_FORMAT("  -7|42  |-0042|+00000099", "{:4}|{:-4}|{:05}|{:+.8}", -7, 42, -42, 99);
+
 	CHECK_FORMAT("0", "{:x}", 0);
 	CHECK_FORMAT("0x0", "{:#x}", 0);
 	CHECK_FORMAT("ff", "{:x}", 255);
@@ -175,6 +248,14 @@ static void test_integers()
 	CHECK_FORMAT("-10", "{:b}", -2);
 	CHECK_FORMAT("-0b10", "{:#b}", -2);
 
+	// digit counts at nibble, 6-bit and byte boundaries, including the wide 64-bit paths
+	CHECK_FORMAT("f 10 fff 1000 ffffffff 100000000", "{:x} {:x} {:x} {:x} {:x} {:x}", 15, 16, 0xFFF, 0x1000, 0xFFFFFFFFU, 0x100000000ULL);
+	CHECK_FORMAT("FEDCBA9876543210 123456789ABCDEF", "{:X} {:X}", 0xFEDCBA9876543210ULL, 0x123456789ABCDEFULL);
+	CHECK_FORMAT("0x00000000deadbeef", "{:#018x}", 0xDEADBEEFULL);
+	CHECK_FORMAT("7 10 77 100 1777777777777777777777", "{:o} {:o} {:o} {:o} {:o}", 7, 8, 63, 64, std::numeric_limits<std::uint64_t>::max());
+	CHECK_FORMAT("1111 10000 11111111111111111111111111111111", "{:b} {:b} {:b}", 15, 16, 0xFFFFFFFFU);
+	CHECK_WFORMAT(L"deadbeefcafe 755 101", L"{:x} {:o} {:b}", 0xDEADBEEFCAFEULL, 0755, 5);
+
 	CHECK_FORMAT("11", "{:o}", 9);
 	CHECK_FORMAT("-33", "{:o}", -27);
 	CHECK_FORMAT("-0o10", "{:#o}", -8);
@@ -190,11 +271,28 @@ static void test_integers()
 
 static void test_floats()
 {
-	CHECK_FORMAT("123987.456000", "{}", 123987.456);
+	// shortest round-trip representation by default
+	CHECK_FORMAT("123987.456", "{}", 123987.456);
+	CHECK_FORMAT("0", "{}", 0.0);
+	CHECK_FORMAT("-0", "{}", -0.0);
+	CHECK_FORMAT("1", "{}", 1.0);
+	CHECK_FORMAT("-1", "{}", -1.0);
+	CHECK_FORMAT("0.1", "{}", 0.1);
+	CHECK_FORMAT("0.3", "{}", 0.3f);
+	CHECK_FORMAT("0.30000000000000004", "{}", 0.1 + 0.2);
+	CHECK_FORMAT("0.0001", "{}", 1e-4);
+	CHECK_FORMAT("1e-05", "{}", 1e-5);
+	CHECK_FORMAT("1e+16", "{}", 1e16);
+	CHECK_FORMAT("5e-324", "{}", 5e-324);
 
-	CHECK_FORMAT("0.000000", "{}", 0.0);
-	CHECK_FORMAT("1.000000", "{}", 1.0);
-	CHECK_FORMAT("-1.000000", "{}", -1.0);
+	// values Grisu3 cannot decide, which take the exact path
+	CHECK_FORMAT("6.137688561080735e-109", "{}", 6.1376885610807355e-109);
+	CHECK_FORMAT("1.242277923277529e-235", "{}", 1.2422779232775289e-235);
+	CHECK_FORMAT("5.2268534037011774e+45", "{}", 5.2268534037011774e+45);
+	CHECK_FORMAT("1220581332901020.8", "{}", 1220581332901020.8);
+	CHECK_FORMAT("9007199254740992 2.2250738585072014e-308", "{} {}", 9007199254740992.0, 2.2250738585072014e-308);
+	CHECK_FORMAT("   -17.5", "{:8}", -17.5);
+	CHECK_FORMAT("-00017.5", "{:08}", -17.5);
 
 	CHECK_FORMAT("12.34", "{:2.2}", 12.34);
 	CHECK_FORMAT("12.00", "{:#2.2}", 12.0);
@@ -204,12 +302,15 @@ static void test_floats()
 	CHECK_FORMAT("12.34 ;", "{:-6.2};", 12.34);
 
 	// assumes IEEE754 single- and double-precision types
-	CHECK_FORMAT("340282346638528859811704183484516925440.000000", "{}", std::numeric_limits<float>::max());
+	CHECK_FORMAT("3.4028235e+38", "{}", std::numeric_limits<float>::max());
+	CHECK_FORMAT("1.7976931348623157e+308", "{}", std::numeric_limits<double>::max());
+	CHECK_FORMAT("340282346638528859811704183484516925440.000000", "{:f}", std::numeric_limits<float>::max());
 	CHECK_FORMAT("17976931348623157081452742373170435679807056752584499659891747680315"
 		"72607800285387605895586327668781715404589535143824642343213268894641827684675"
 		"46703537516986049910576551282076245490090389328944075868508455133942304583236"
 		"90322294816580855933212334827479782620414472316873817718091929988125040402618"
-		"4124858368.000000", "{}", std::numeric_limits<double>::max());
+		"4124858368.000000", "{:f}", std::numeric_limits<double>::max());
+	CHECK_FORMAT("4.940656458412465441765687928682213723651e-324", "{:.39e}", 5e-324);
 
 	CHECK_FORMAT("234987324.454500", "{:f}", 234987324.4545);
 	CHECK_FORMAT("2.34987e+08", "{:g}", 234987324.4545);
@@ -217,6 +318,19 @@ static void test_floats()
 	CHECK_FORMAT("234987324.454500", "{:F}", 234987324.4545);
 	CHECK_FORMAT("2.34987E+08", "{:G}", 234987324.4545);
 	CHECK_FORMAT("0X1.C033E78E8B439P+27", "{:A}", 234987324.4545);
+
+	// rounding is to nearest, ties to even, on the exact binary value
+	CHECK_FORMAT("0 2 2 0.1 0.3", "{:.0f} {:.0f} {:.0f} {:.1f} {:.1f}", 0.5, 1.5, 2.5, 0.125, 0.25 + 0.0625);
+	CHECK_FORMAT("1.0 10.0 1.0e+01", "{:.1f} {:.1f} {:.1e}", 0.96, 9.96, 9.96);
+	CHECK_FORMAT("0.000000e+00 0 0.00000", "{:e} {:g} {:#g}", 0.0, 0.0, 0.0);
+	CHECK_FORMAT("100000 1e+06 0.0001 1e-05 1.50000", "{:g} {:g} {:g} {:g} {:#g}", 1e5, 1e6, 1e-4, 1e-5, 1.5);
+	CHECK_FORMAT("0x1p+0 0x2p+0 0x1.8p+0 0x0.0000000000001p-1022", "{:a} {:.0a} {:.1a} {:a}", 1.0, 1.5, 1.5, 5e-324);
+	CHECK_FORMAT("0x0001p+0", "{:09a}", 1.0);
+
+	CHECK_FORMAT("inf -inf +INF nan", "{} {} {:+F} {}", std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN());
+	CHECK_FORMAT("   inf", "{:06}", std::numeric_limits<double>::infinity());
+
+	CHECK_WFORMAT(L"123987.456 1.5e+300 2.50", L"{} {} {:.2f}", 123987.456, 1.5e300, 2.5);
 }
 
 // this is mostly tested already via the CHECK_FORMAT tests everywhere else
@@ -225,6 +339,551 @@ static void test_string_writer()
 	formatxx::string_writer tmp;
 
 	CHECK_FORMAT_WRITER("1234", tmp, "1{}4", 23);
+
+	tmp.clear();
+	CHECK_FORMAT_WRITER("[  -12|ab   ]", tmp, "[{:5}|{:-5}]", -12, "ab");
+}
+
+namespace
+{
+	// formats itself through the scratch API, exercising reentrancy
+	struct nested_type { int value; };
+
+	void format_value(formatxx::format_writer& out, nested_type const& value, formatxx::string_view)
+	{
+		std::string const inner = formatxx::scratch_format_string("<{}>", value.value);
+		out.write({inner.c_str(), inner.size()});
+	}
+}
+
+static void test_format_append()
+{
+	// appends to what the container already holds
+	std::string response = "HTTP/1.1 200 OK\r\n";
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::format_append(response, "Content-Length: {}\r\n", 42));
+	formatxx::printf_append(response, "%s: %-4d|\r\n", "X-Id", 7);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("HTTP/1.1 200 OK\r\nContent-Length: 42\r\nX-Id: 7   |\r\n"), response);
+
+	std::vector<char> bytes(1, '>');
+	formatxx::format_append(bytes, "{} {:#x} {:.1f} {:5}", std::string("abc"), 255, 2.25, true);
+	CHECK_FORMAT_HELPER(std::cerr, std::string(">abc 0xff 2.2  true"), std::string(bytes.begin(), bytes.end()));
+
+	// many small appends grow geometrically rather than by each append's size
+	std::vector<char> lines;
+	std::string expected;
+	std::size_t reallocations = 0;
+	for (int i = 0; i != 1000; ++i)
+	{
+		std::size_t const capacity = lines.capacity();
+		formatxx::format_append(lines, "{},", i);
+		reallocations += lines.capacity() != capacity;
+		expected += std::to_string(i) + ",";
+	}
+	CHECK_FORMAT_HELPER(std::cerr, expected, std::string(lines.begin(), lines.end()));
+	CHECK_FORMAT_HELPER(std::cerr, true, reallocations < 16);
+
+	std::wstring wide = L"[";
+	formatxx::format_append(wide, L"{:,}]", 123456);
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"[123,456]"), wide);
+
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_range, formatxx::format_append(response, "{1}", 1));
+}
+
+static void test_scratch_strings()
+{
+	CHECK_FORMAT_HELPER(std::cerr, std::string("a=1 b=2.5"), formatxx::scratch_format_string("a={} b={}", 1, 2.5));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("-0042|x"), formatxx::scratch_printf_string("%05d|%s", -42, "x"));
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"wide 7"), formatxx::scratch_format_string<std::wstring>(L"wide {}", 7));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("[<1>,<2>]"), formatxx::scratch_format_string("[{},{}]", nested_type{1}, nested_type{2}));
+
+	// results larger than the retained scratch size
+	std::string const large(100000, 'z');
+	CHECK_FORMAT_HELPER(std::cerr, large, formatxx::scratch_format_string("{}", large.c_str()));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("small"), formatxx::scratch_format_string("{}", "small"));
+
+	// size hints from previous calls must not affect the result as lengths change
+	for (int count = 1; count < 200; count *= 3)
+	{
+		std::string const text(count, 'q');
+		CHECK_FORMAT(text + "!", "{}!", text.c_str());
+	}
+
+	// one huge result only raises the hint up to the cap
+	static char const hinted[] = "{}";
+	CHECK_FORMAT_HELPER(std::cerr, large, formatxx::format_string(hinted, large.c_str()));
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::format_string(hinted, "a").capacity() < large.size());
+
+	// formats that aren't pointers or literals get no hint
+	std::string const owned = "{}?";
+	CHECK_FORMAT_HELPER(std::cerr, large + "?", formatxx::format_string(formatxx::string_view(owned.c_str(), owned.size()), large.c_str()));
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::format_string(formatxx::string_view(owned.c_str(), owned.size()), "a").capacity() < 1024);
+}
+
+namespace
+{
+	// a writer that only implements the required interface
+	class minimal_writer : public formatxx::format_writer
+	{
+	public:
+		void write(formatxx::string_view str) override { string.append(str.data(), str.size()); ++writes; }
+
+		std::size_t size() const { return string.size(); }
+		char const* c_str() const { return string.c_str(); }
+
+		std::string string;
+		int writes = 0;
+	};
+}
+
+static void test_formatted_size()
+{
+	CHECK_FORMAT_HELPER(std::cerr, 0, formatxx::formatted_size(""));
+	CHECK_FORMAT_HELPER(std::cerr, 9, formatxx::formatted_size("a={} b={}", 1, 2.5));
+	CHECK_FORMAT_HELPER(std::cerr, 40, formatxx::formatted_size("{:40}", -7));
+	CHECK_FORMAT_HELPER(std::cerr, 316, formatxx::formatted_size("{:f}", std::numeric_limits<double>::max()));
+	CHECK_FORMAT_HELPER(std::cerr, 5, formatxx::printf_formatted_size("%05d", 42));
+	CHECK_FORMAT_HELPER(std::cerr, 6, formatxx::formatted_size(L"wide {}", 7));
+	CHECK_FORMAT_HELPER(std::cerr, 3, formatxx::formatted_size(std::string("{}"), 123));
+
+	formatxx::compiled_format const compiled("[{}|{:x}]");
+	CHECK_FORMAT_HELPER(std::cerr, 7, formatxx::formatted_size(compiled, 12, 255));
+}
+
+static void test_format_to_n()
+{
+	char buffer[8];
+
+	auto const fits = formatxx::format_to_n(buffer, sizeof(buffer), "{}-{}", 12, 34);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("12-34"), std::string(buffer, fits.out));
+	CHECK_FORMAT_HELPER(std::cerr, 5, fits.size);
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, fits.result);
+
+	auto const exact = formatxx::format_to_n(buffer, sizeof(buffer), "{:08}", 1);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("00000001"), std::string(buffer, exact.out));
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, exact.result);
+
+	auto const truncated = formatxx::format_to_n(buffer, sizeof(buffer), "{} {:6}", "hello", 3);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("hello   "), std::string(buffer, truncated.out));
+	CHECK_FORMAT_HELPER(std::cerr, 12, truncated.size);
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_space, truncated.result);
+
+	auto const printed = formatxx::printf_to_n(buffer, 4, "%d", 123456);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("1234"), std::string(buffer, printed.out));
+	CHECK_FORMAT_HELPER(std::cerr, 6, printed.size);
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_space, printed.result);
+
+	auto const error = formatxx::format_to_n(buffer, sizeof(buffer), "{1}", 1);
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_range, error.result);
+
+	wchar_t wbuffer[4];
+	auto const wide = formatxx::format_to_n(wbuffer, 4, L"{}", 12345);
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"1234"), std::wstring(wbuffer, wide.out));
+	CHECK_FORMAT_HELPER(std::cerr, 5, wide.size);
+}
+
+template <std::size_t SizeN>
+static std::string join_iovecs(formatxx::iovec_writer<SizeN> const& writer)
+{
+	std::string result;
+	for (std::size_t i = 0; i != writer.count(); ++i)
+	{
+		result.append(static_cast<char const*>(writer.data()[i].iov_base), writer.data()[i].iov_len);
+	}
+	return result;
+}
+
+namespace
+{
+	// formats through the public string helper with a string that dies on return
+	struct temporary_text { std::size_t length; };
+
+	void format_value(formatxx::format_writer& out, temporary_text const& value, formatxx::string_view spec)
+	{
+		std::string const text(value.length, 't');
+		formatxx::format_value(out, formatxx::string_view(text.c_str(), text.size()), spec);
+		formatxx::format_value(out, text.c_str(), spec);
+	}
+}
+
+static void test_iovec_writer()
+{
+	std::string const name(100, 'n');
+	char const* const format = "this literal is long enough to be referenced: {} {:5} {} and {{escaped}} tail";
+
+	formatxx::iovec_writer<> writer(16);
+	formatxx::format(writer, format, 42, 7, name);
+	std::string const expected = "this literal is long enough to be referenced: 42     7 " + name + " and {escaped}} tail";
+	CHECK_FORMAT_HELPER(std::cerr, expected, join_iovecs(writer));
+	CHECK_FORMAT_HELPER(std::cerr, expected.size(), writer.size());
+
+	// the leading literal and the string argument are not copied
+	CHECK_FORMAT_HELPER(std::cerr, static_cast<void const*>(format), static_cast<void const*>(writer.data()[0].iov_base));
+	bool referenced = false;
+	for (std::size_t i = 0; i != writer.count(); ++i)
+	{
+		referenced = referenced || writer.data()[i].iov_base == name.data();
+	}
+	CHECK_FORMAT_HELPER(std::cerr, true, referenced);
+
+	// with every span referenced, only the argument is copied
+	formatxx::iovec_writer<> all(1);
+	formatxx::format(all, "a{{b{}c", 1);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("a{b1c"), join_iovecs(all));
+	CHECK_FORMAT_HELPER(std::cerr, 4, all.count());
+
+	// transient output coalesces into one segment and spills past the inline arena
+	writer.clear();
+	CHECK_FORMAT_HELPER(std::cerr, 0, writer.count());
+	std::string transient;
+	for (int i = 0; i != 500; ++i)
+	{
+		formatxx::format(writer, "{},", i);
+		transient += std::to_string(i) + ",";
+	}
+	CHECK_FORMAT_HELPER(std::cerr, transient, join_iovecs(writer));
+	CHECK_FORMAT_HELPER(std::cerr, true, writer.count() < 10);
+
+	formatxx::iovec_writer<16> small;
+	formatxx::printf(small, "%s|%-6c|%d", name.c_str(), 'x', 5);
+	CHECK_FORMAT_HELPER(std::cerr, name + "|x     |5", join_iovecs(small));
+
+	// strings a format_value passes to the public helpers are copied, not referenced
+	formatxx::iovec_writer<> copied(1);
+	formatxx::format(copied, "{}", temporary_text{86});
+	CHECK_FORMAT_HELPER(std::cerr, std::string(172, 't'), join_iovecs(copied));
+}
+
+static std::string read_file(std::FILE* file)
+{
+	std::fflush(file);
+	std::rewind(file);
+
+	std::string contents;
+	char buffer[4096];
+	std::size_t read = 0;
+	while ((read = std::fread(buffer, 1, sizeof(buffer), file)) != 0)
+	{
+		contents.append(buffer, read);
+	}
+	return contents;
+}
+
+static void test_fd_writer()
+{
+	std::FILE* const file = std::tmpfile();
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	{
+		formatxx::fd_writer<16> writer(file);
+		formatxx::format(writer, "{} {:20} {}", 1, "padded", 3.5);
+		CHECK_FORMAT_HELPER(std::cerr, true, writer.buffered() <= 16);
+		CHECK_FORMAT_HELPER(std::cerr, true, writer.flush());
+		CHECK_FORMAT_HELPER(std::cerr, 0, writer.buffered());
+
+		formatxx::format(writer, "|{}|", std::string(40, 'L'));
+	}
+	CHECK_FORMAT_HELPER(std::cerr, "1               padded 3.5|" + std::string(40, 'L') + "|", read_file(file));
+
+	// line flushing leaves only the unterminated tail buffered
+	{
+		formatxx::fd_writer<> lines(file, formatxx::flush_policy::each_line);
+		formatxx::format(lines, "first\nsec");
+		CHECK_FORMAT_HELPER(std::cerr, 0, lines.buffered());
+		formatxx::format(lines, "ond");
+		CHECK_FORMAT_HELPER(std::cerr, 3, lines.buffered());
+	}
+
+	std::fclose(file);
+}
+
+static void test_mmap_writer()
+{
+	std::FILE* const file = std::tmpfile();
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	// a small step forces several remaps, each of which keeps the earlier output
+	std::string expected;
+	{
+		formatxx::mmap_writer writer(fileno(file), 4096);
+		for (int i = 0; i != 1000; ++i)
+		{
+			formatxx::format(writer, "{:6} {:-8}|{}\n", i, "row", 2.5);
+			expected += formatxx::format_string("{:6} {:-8}|{}\n", i, "row", 2.5);
+		}
+		formatxx::format(writer, "{:10000}", "wide");
+		expected += std::string(9996, ' ') + "wide";
+		CHECK_FORMAT_HELPER(std::cerr, expected.size(), writer.size());
+		CHECK_FORMAT_HELPER(std::cerr, true, writer.close());
+		CHECK_FORMAT_HELPER(std::cerr, expected.size(), writer.size());
+
+		// closed writers drop output
+		formatxx::format(writer, "dropped");
+		CHECK_FORMAT_HELPER(std::cerr, expected.size(), writer.size());
+	}
+	CHECK_FORMAT_HELPER(std::cerr, expected, read_file(file));
+
+	// an empty writer truncates the file
+	{
+		formatxx::mmap_writer empty(fileno(file));
+	}
+	CHECK_FORMAT_HELPER(std::cerr, std::string(), read_file(file));
+	std::fclose(file);
+
+	formatxx::mmap_writer invalid(-1);
+	formatxx::format(invalid, "{}", 1);
+	CHECK_FORMAT_HELPER(std::cerr, true, invalid.failed());
+	CHECK_FORMAT_HELPER(std::cerr, 0, invalid.size());
+	CHECK_FORMAT_HELPER(std::cerr, false, invalid.close());
+
+	// descriptors that aren't open for both reading and writing can't be mapped
+	char const* const path = "formatxx_mmap_test.tmp";
+	for (char const* const mode : {"wb", "rb"})
+	{
+		std::FILE* const opened = std::fopen(path, mode);
+		if (opened == nullptr)
+		{
+			continue;
+		}
+		{
+			formatxx::mmap_writer one_way(fileno(opened), 4096);
+			formatxx::format(one_way, "{}", 1);
+			CHECK_FORMAT_HELPER(std::cerr, true, one_way.failed());
+			CHECK_FORMAT_HELPER(std::cerr, false, one_way.close());
+		}
+		std::fclose(opened);
+	}
+	std::remove(path);
+}
+
+static void test_log_sink()
+{
+	std::FILE* const file = std::tmpfile();
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	constexpr int thread_count = 4;
+	constexpr int record_count = 2000;
+
+	{
+		// a small ring forces producers to wait on the flusher, and long records span many slots
+		formatxx::log_sink sink(file, 16);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t != thread_count; ++t)
+		{
+			threads.emplace_back([&sink, t]() {
+				for (int i = 0; i != record_count; ++i)
+				{
+					std::string const filler(static_cast<std::size_t>((i * 37) % 300), static_cast<char>('a' + t));
+					sink.format("thread {} record {} {}\n", t, i, filler);
+				}
+			});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		sink.printf("%s\n", "done");
+		sink.flush();
+		CHECK_FORMAT_HELPER(std::cerr, 0, sink.dropped());
+	}
+
+	// every record arrives exactly once and intact
+	std::string const contents = read_file(file);
+	std::set<std::string> lines;
+	std::size_t begin = 0;
+	for (std::size_t end = contents.find('\n'); end != std::string::npos; begin = end + 1, end = contents.find('\n', begin))
+	{
+		lines.insert(contents.substr(begin, end - begin));
+	}
+
+	bool intact = lines.size() == static_cast<std::size_t>(thread_count * record_count + 1) && lines.count("done") == 1;
+	for (int t = 0; t != thread_count && intact; ++t)
+	{
+		for (int i = 0; i != record_count && intact; ++i)
+		{
+			std::string const filler(static_cast<std::size_t>((i * 37) % 300), static_cast<char>('a' + t));
+			intact = lines.count(formatxx::format_string("thread {} record {} {}", t, i, filler)) == 1;
+		}
+	}
+	CHECK_FORMAT_HELPER(std::cerr, true, intact);
+
+	// under the drop policy every record is either written or counted as dropped
+	std::FILE* const dropping = std::tmpfile();
+	if (dropping != nullptr)
+	{
+		std::size_t dropped = 0;
+		{
+			formatxx::log_sink sink(dropping, 2, formatxx::overflow_policy::drop);
+			for (int i = 0; i != record_count; ++i)
+			{
+				sink.format("{}\n", i);
+			}
+			sink.flush();
+			dropped = sink.dropped();
+		}
+		std::string const written = read_file(dropping);
+		CHECK_FORMAT_HELPER(std::cerr, static_cast<std::size_t>(record_count), static_cast<std::size_t>(std::count(written.begin(), written.end(), '\n')) + dropped);
+		std::fclose(dropping);
+	}
+
+	std::fclose(file);
+}
+
+namespace
+{
+	struct point { int x; int y; };
+
+	void format_value(formatxx::format_writer& out, point const& value, formatxx::string_view)
+	{
+		formatxx::format(out, "({},{})", value.x, value.y);
+	}
+}
+
+static void test_deferred()
+{
+	alignas(formatxx::deferred_alignment) unsigned char record[512];
+	alignas(formatxx::deferred_alignment) unsigned char moved[512];
+
+	// strings are copied at capture time, so later changes don't show up
+	char name[] = "alpha";
+	std::string owned = "beta";
+	std::size_t const size = formatxx::capture_format(record, sizeof(record), "{} {} {} {:.2f} {:#x} {} {}", name, owned, formatxx::string_view("gamma"), 2.5, 255, point{1, 2}, true);
+	CHECK_FORMAT_HELPER(std::cerr, true, size != 0 && size <= sizeof(record));
+	CHECK_FORMAT_HELPER(std::cerr, size, formatxx::deferred_record_size(record));
+	name[0] = 'X';
+	owned = "changed";
+
+	formatxx::string_writer out;
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::replay_format(out, record));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("alpha beta gamma 2.50 0xff (1,2) true"), out.str());
+
+	// records are position independent and can be replayed again
+	std::memcpy(moved, record, size);
+	std::memset(record, 0, sizeof(record));
+	out.clear();
+	formatxx::replay_format(out, moved);
+	formatxx::replay_format(out, moved);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("alpha beta gamma 2.50 0xff (1,2) truealpha beta gamma 2.50 0xff (1,2) true"), out.str());
+
+	// too small a buffer reports the size needed without writing
+	CHECK_FORMAT_HELPER(std::cerr, size, formatxx::capture_format(record, 8, "{} {} {} {:.2f} {:#x} {} {}", name, owned, formatxx::string_view("gamma"), 2.5, 255, point{1, 2}, true));
+	CHECK_FORMAT_HELPER(std::cerr, 0, formatxx::deferred_record_size(record));
+
+	// byte spans are copied too, not just their data pointer
+	unsigned char packet[] = {0xde, 0xad, 0xbe, 0xef};
+	formatxx::capture_format(record, sizeof(record), "{} {:X}", formatxx::hex_bytes(packet, sizeof(packet)), formatxx::hex_bytes());
+	std::memset(packet, 0, sizeof(packet));
+	out.clear();
+	formatxx::replay_format(out, record);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("deadbeef "), out.str());
+
+	formatxx::capture_printf(record, sizeof(record), "%s=%05d", "id", 42);
+	out.clear();
+	formatxx::replay_format(out, record);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("id=00042"), out.str());
+
+	// so are UTF-16, UTF-32 and UTF-8 strings
+	char16_t u16name[] = u"hello";
+	std::u16string u16owned = u"owned";
+	char32_t u32name[] = U"world";
+	formatxx::capture_format(record, sizeof(record), "{} {} {} {}", static_cast<char16_t const*>(u16name), u16owned, formatxx::basic_string_view<char32_t>(u32name), static_cast<char32_t*>(u32name));
+	u16name[0] = u'J';
+	u16owned = u"changed";
+	u32name[0] = U'J';
+	out.clear();
+	formatxx::replay_format(out, record);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("hello owned world world"), out.str());
+#if defined(__cpp_char8_t)
+	char8_t u8name[] = u8"h\u00e9llo";
+	formatxx::capture_format(record, sizeof(record), "{} {}", static_cast<char8_t const*>(u8name), formatxx::basic_string_view<char8_t>(u8name));
+	u8name[0] = u8'J';
+	out.clear();
+	formatxx::replay_format(out, record);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("h\xc3\xa9llo h\xc3\xa9llo"), out.str());
+#endif
+
+	formatxx::capture_format(record, sizeof(record), L"{} {}", L"wide", "narrow");
+	formatxx::basic_string_writer<std::wstring> wide;
+	formatxx::replay_format(wide, record);
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"wide narrow"), wide.str());
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::malformed_input, formatxx::replay_format(out, record));
+
+	// deferred records are rendered by the log_sink's background thread
+	std::FILE* const file = std::tmpfile();
+	if (file != nullptr)
+	{
+		{
+			formatxx::log_sink sink(file, 64);
+			std::string const long_text(300, 'd');
+			for (int i = 0; i != 100; ++i)
+			{
+				sink.defer("deferred {} {}\n", i, i % 10 == 0 ? long_text : std::string("short"));
+			}
+			sink.defer_printf("%s %d\n", "printf", 7);
+			sink.format("direct\n");
+			sink.flush();
+		}
+
+		std::string expected;
+		for (int i = 0; i != 100; ++i)
+		{
+			expected += formatxx::format_string("deferred {} {}\n", i, i % 10 == 0 ? std::string(300, 'd') : std::string("short"));
+		}
+		expected += "printf 7\ndirect\n";
+		CHECK_FORMAT_HELPER(std::cerr, expected, read_file(file));
+		std::fclose(file);
+	}
+}
+
+static void test_minimal_writer()
+{
+	minimal_writer writer;
+	CHECK_FORMAT_WRITER("[  -12|ab   |0x0000ff]", writer, "[{:5}|{:-5}|{:#08x}]", -12, "ab", 255);
+
+	minimal_writer decimal;
+	CHECK_FORMAT_WRITER("7 -18446744073709551615 00042", decimal, "{} -{} {:05}", 7, std::numeric_limits<std::uint64_t>::max(), 42);
+
+	minimal_writer fill;
+	fill.write_fill('*', 70);
+	CHECK_FORMAT_HELPER(std::cerr, std::string(70, '*'), fill.string);
+	CHECK_FORMAT_HELPER(std::cerr, 3, fill.writes);
+
+	// a writer without a window receives every put through its virtual functions
+	minimal_writer put;
+	put.put("ab");
+	put.put_fill('.', 2);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("ab.."), put.string);
+	CHECK_FORMAT_HELPER(std::cerr, true, put.put_reserve(4) == nullptr);
+}
+
+static void test_grouping()
+{
+	CHECK_FORMAT("1,234,567 -1,234 999 0 1,000", "{:,} {:,} {:,} {:,} {:,}", 1234567, -1234, 999, 0, 1000);
+	CHECK_FORMAT("1_234_567|   1,234,567|1,234,567   |", "{:_}|{:12,}|{:-12,}|", 1234567, 1234567, 1234567);
+	CHECK_FORMAT("18,446,744,073,709,551,615 -9,223,372,036,854,775,808", "{:,} {:,}", std::numeric_limits<std::uint64_t>::max(), std::numeric_limits<std::int64_t>::min());
+	CHECK_FORMAT("+12,345 000001,234", "{:+,} {:010,}", 12345, 1234);
+	CHECK_PRINTF("1,234,567|  12,345", "%'d|%'8d", 1234567, 12345);
+
+	// only decimal digits are grouped
+	CHECK_FORMAT("123456 1234567", "{:,x} {:,o}", 0x123456, 01234567);
+
+	// floats group the integer part of fixed notation only
+	CHECK_FORMAT("1,234,567.89 1,234.5 123.25 1e+20", "{:,.2f} {:,} {:,} {:,}", 1234567.891, 1234.5, 123.25, 1e20);
+	CHECK_FORMAT("1,234,567 1.23457e+06 -0.5", "{:,.10g} {:,g} {:,}", 1234567.0, 1234567.0, -0.5);
+	CHECK_PRINTF("12,345.7", "%'.1f", 12345.67);
+
+	minimal_writer writer;
+	CHECK_FORMAT_WRITER("[ 98,765,432]", writer, "[{:11,}]", 98765432);
+	CHECK_WFORMAT(L"4,096", L"{:,}", 4096);
 }
 
 static void test_buffered()
@@ -236,6 +895,90 @@ static void test_buffered()
 	buf.clear();
 
 	CHECK_FORMAT_WRITER("1234567890", buf, "1{}3{}5{}7{}9{}", 2, 4, 6, 8, 0);
+
+	buf.clear();
+	CHECK_FORMAT_WRITER("-000000000000042", buf, "{:016}", -42);
+
+	// the terminator is only written on demand, including after shrinking via clear
+	buf.clear();
+	buf.put("ab");
+	CHECK_FORMAT_HELPER(std::cerr, std::string("ab"), std::string(buf.c_str()));
+	buf.put("cdefgh");
+	formatxx::buffered_writer<4> const& const_buf = buf;
+	CHECK_FORMAT_HELPER(std::cerr, std::string("abcdefgh"), std::string(const_buf.c_str()));
+	formatxx::buffered_writer<8> inline_release;
+	inline_release.put("xyz");
+	auto inline_released = inline_release.release();
+	CHECK_FORMAT_HELPER(std::cerr, std::string("xyz"), std::string(inline_released.data));
+	inline_release.get_allocator().deallocate(inline_released.data, inline_released.capacity);
+
+	// moving keeps the contents, whether inline or allocated
+	formatxx::buffered_writer<8> small;
+	formatxx::format(small, "{}", 123);
+	formatxx::buffered_writer<8> moved_small(std::move(small));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("123"), std::string(moved_small.c_str()));
+	CHECK_FORMAT_HELPER(std::cerr, 0, small.size());
+
+	formatxx::buffered_writer<8> large;
+	formatxx::format(large, "{:20}", 7);
+	char const* const storage = large.c_str();
+	formatxx::buffered_writer<8> moved_large;
+	moved_large = std::move(large);
+	CHECK_FORMAT_HELPER(std::cerr, storage, moved_large.c_str());
+	CHECK_FORMAT_HELPER(std::cerr, 20, moved_large.size());
+
+	auto released = moved_large.release();
+	CHECK_FORMAT_HELPER(std::cerr, storage, released.data);
+	CHECK_FORMAT_HELPER(std::cerr, 20, released.size);
+	CHECK_FORMAT_HELPER(std::cerr, 0, moved_large.size());
+	moved_large.get_allocator().deallocate(released.data, released.capacity);
+}
+
+static void test_arena()
+{
+	formatxx::monotonic_arena<64> arena;
+	using arena_writer = formatxx::basic_buffered_writer<char, 16, formatxx::arena_allocator<char>>;
+
+	{
+		arena_writer writer(arena);
+		CHECK_FORMAT_WRITER("0123456789abcdefghij", writer, "{}{}", "0123456789", "abcdefghij");
+		CHECK_FORMAT_HELPER(std::cerr, true, writer.capacity() >= 20);
+
+		// grows past the inline arena storage into heap blocks
+		writer.clear();
+		std::string const text(500, 'x');
+		CHECK_FORMAT_WRITER(text, writer, "{}", text.c_str());
+
+		// inline contents are copied into the arena on release
+		arena_writer inline_writer(arena);
+		formatxx::format(inline_writer, "{}", 42);
+		auto released = inline_writer.release();
+		CHECK_FORMAT_HELPER(std::cerr, std::string("42"), std::string(released.data));
+
+		// every writer is gone before the arena is reset
+		arena_writer moved(std::move(writer));
+		CHECK_FORMAT_HELPER(std::cerr, text, std::string(moved.c_str()));
+	}
+
+	arena.reset();
+	CHECK_FORMAT_HELPER(std::cerr, 0, arena.used());
+
+	formatxx::arena_allocator<int> ints(arena);
+	int* const values = ints.allocate(4);
+	CHECK_FORMAT_HELPER(std::cerr, 0, reinterpret_cast<std::uintptr_t>(values) % alignof(int));
+	ints.deallocate(values, 4);
+	CHECK_FORMAT_HELPER(std::cerr, 0, arena.used());
+	CHECK_FORMAT_HELPER(std::cerr, true, ints == formatxx::arena_allocator<char>(arena));
+
+	// an arena reset per request reuses its heap block rather than growing a new one each time
+	void* const first_spill = arena.allocate(100, 1);
+	bool reused = true;
+	for (int i = 0; i != 32; ++i)
+	{
+		arena.reset();
+		reused = reused && arena.allocate(100, 1) == first_spill;
+	}
+	CHECK_FORMAT_HELPER(std::cerr, true, reused);
 }
 
 static void test_printf()
@@ -298,10 +1041,28 @@ static void test_strings()
 	CHECK_FORMAT("value   00042", "{:-8}{:05}", "value", 42);
 }
 
+static void test_literals()
+{
+	// directives at every offset around the scanner's block boundaries
+	for (std::size_t offset = 0; offset != 40; ++offset)
+	{
+		std::string const literal(offset, 'x');
+		std::wstring const wliteral(offset, L'x');
+
+		CHECK_FORMAT(literal + "7" + literal, (literal + "{}" + literal).c_str(), 7);
+		CHECK_FORMAT(literal + "{" + literal, (literal + "{{" + literal).c_str());
+		CHECK_PRINTF(literal + "7%" + literal, (literal + "%d%%" + literal).c_str(), 7);
+		CHECK_WFORMAT(wliteral + L"7" + wliteral, (wliteral + L"{}" + wliteral).c_str(), 7);
+	}
+
+	CHECK_FORMAT("<0000000000000000000000000000000000000042>", "<{:0000000000000000000000000000000000000040}>", 42);
+	CHECK_FORMAT("{:01234567890123456789", "{:01234567890123456789");
+}
+
 static void test_wide_strings()
 {
 	CHECK_WFORMAT_VALUE(L"1234", 1234U, L"");
-	CHECK_WFORMAT_VALUE(L"-17.500000", -17.5, L"");
+	CHECK_WFORMAT_VALUE(L"-17.5", -17.5, L"");
 	CHECK_WFORMAT_VALUE(L"true", true, L"");
 	CHECK_WFORMAT_VALUE(L"lorem ipsum", "lorem ipsum", L"");
 	CHECK_FORMAT_VALUE("lorem ipsum", L"lorem ipsum", "");
@@ -313,6 +1074,69 @@ static void test_wide_strings()
 	CHECK_FORMAT("this is a test", "this {} a {}{}{}", L"is", 't', L'e', L"st");
 
 	CHECK_WPRINTF(L"12abcd34", L"%d%s%c%c%d", 12, L"ab", 'c', L'd', 34UL);
+
+	// narrow strings are UTF-8, and invalid input becomes U+FFFD
+	CHECK_WFORMAT_VALUE(L"h\u00e9llo \u20ac \U0001F600", "h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80", L"");
+	CHECK_FORMAT_VALUE("h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80", L"h\u00e9llo \u20ac \U0001F600", "");
+	CHECK_WFORMAT_VALUE(L"a\uFFFDb\uFFFD\uFFFDc\uFFFD", "a\xff" "b\xc0\xaf" "c\xe2\x82", L"");
+	CHECK_WFORMAT_VALUE(L"\uFFFD", '\xe9', L"");
+	CHECK_FORMAT_VALUE("\xc3\xa9", L'\u00e9', "");
+
+	// widths and precisions count output code units, never splitting a code point
+	CHECK_WFORMAT_VALUE(L"  h\u00e9", "h\xc3\xa9", L"4");
+	CHECK_WFORMAT_VALUE(L"h\u00e9  ", std::string("h\xc3\xa9"), L"-4");
+	CHECK_FORMAT_VALUE("   h\xc3\xa9", L"h\u00e9", "6");
+	CHECK_FORMAT_VALUE("h", L"h\u00e9llo", ".2");
+	CHECK_FORMAT_VALUE(" h\xc3\xa9", L"h\u00e9llo", "4.3");
+	CHECK_WFORMAT(L"[  abc]", L"[{:5}]", "abc");
+	CHECK_WPRINTF(L"[ab   ]", L"[%-5.2s]", "abcd");
+
+	// long strings convert in blocks, with the ASCII fast path around non-ASCII text
+	std::string narrow;
+	std::wstring wide;
+	for (int i = 0; i != 100; ++i)
+	{
+		narrow += "0123456789abcdefghij\xc3\xa9";
+		wide += L"0123456789abcdefghij\u00e9";
+	}
+	CHECK_WFORMAT_VALUE(wide, narrow, L"");
+	CHECK_FORMAT_VALUE(narrow, wide, "");
+}
+
+static void test_unicode_strings()
+{
+	CHECK_U16FORMAT(u"1234 -17.5 true", u"{} {} {}", 1234U, -17.5, true);
+	CHECK_U32FORMAT(U"1234 -17.5 true", U"{} {} {}", 1234U, -17.5, true);
+	CHECK_U16FORMAT(u"[  0x2a|ab  |c]", u"[{:#6x}|{:-4}|{}]", 42, u"ab", u'c');
+	CHECK_U32FORMAT(U"[  0x2a|ab  |c]", U"[{:#6x}|{:-4}|{}]", 42, U"ab", U'c');
+	CHECK_FORMAT_HELPER(std::cerr, std::u16string(u"00042 1.50e+00"), formatxx::printf_string<std::u16string>(u"%05d %.2e", 42, 1.5));
+	CHECK_FORMAT_HELPER(std::cerr, std::u32string(U"x=0042"), formatxx::printf_string<std::u32string>(U"%s=%04d", U"x", 42));
+	CHECK_FORMAT_HELPER(std::cerr, std::u16string(u"7 42 ff"), formatxx::printf_string<std::u16string>(u"%u %lu %Lx", 7u, 42ul, 255));
+	CHECK_FORMAT_HELPER(std::cerr, std::u32string(U"7 42 ff"), formatxx::printf_string<std::u32string>(U"%u %lu %Lx", 7u, 42ul, 255));
+
+	// UTF-8 narrow strings convert straight into the target encoding, and back
+	CHECK_U16FORMAT(u"h\u00e9llo \U0001F600", u"{} {}", "h\xc3\xa9llo", std::string("\xf0\x9f\x98\x80"));
+	CHECK_U32FORMAT(U"h\u00e9llo \U0001F600", U"{} {}", "h\xc3\xa9llo", std::string("\xf0\x9f\x98\x80"));
+	CHECK_FORMAT("h\xc3\xa9llo \xf0\x9f\x98\x80 \xe2\x82\xac", "{} {} {}", u"h\u00e9llo", std::u32string(U"\U0001F600"), u'\u20ac');
+	CHECK_U16FORMAT(u"\U0001F600\U0001F600", u"{}{}", std::u16string(u"\U0001F600"), u"\U0001F600");
+	CHECK_FORMAT("\xef\xbf\xbd", "{}", u"\xd800");
+
+	formatxx::u16fixed_writer<16> fixed;
+	formatxx::format(fixed, u"{}-{}", u"ab", 7);
+	CHECK_FORMAT_HELPER(std::cerr, std::u16string(u"ab-7"), std::u16string(fixed.c_str(), fixed.size()));
+
+#if defined(__cpp_char8_t)
+	CHECK_U8FORMAT(u8"1234 -17.5 true", u8"{} {} {}", 1234U, -17.5, true);
+	CHECK_U8FORMAT(u8"[  0x2a|ab  |c]", u8"[{:#6x}|{:-4}|{}]", 42, u8"ab", u8'c');
+	CHECK_FORMAT_HELPER(std::cerr, std::u8string(u8"x=0042"), formatxx::printf_string<std::u8string>(u8"%s=%04d", u8"x", 42));
+	CHECK_FORMAT_HELPER(std::cerr, std::u8string(u8"7 42 ff"), formatxx::printf_string<std::u8string>(u8"%u %lu %Lx", 7u, 42ul, 255));
+	CHECK_U8FORMAT(u8"h\u00e9llo \U0001F600", u8"{} {}", "h\xc3\xa9llo", std::string("\xf0\x9f\x98\x80"));
+	CHECK_FORMAT("h\xc3\xa9llo \xe2\x82\xac", "{} {}", u8"h\u00e9llo", std::u8string(u8"\u20ac"));
+
+	formatxx::u8fixed_writer<16> fixed8;
+	formatxx::format(fixed8, u8"{}-{}", u8"ab", 7);
+	CHECK_FORMAT_HELPER(std::cerr, std::u8string(u8"ab-7"), std::u8string(fixed8.c_str(), fixed8.size()));
+#endif
 }
 
 static void test_bool()
@@ -330,12 +1154,464 @@ static void test_pointers()
 	CHECK_FORMAT("fefefefe", "{:x}", iptr);
 }
 
+static void test_hex_bytes()
+{
+	unsigned char const bytes[] = {0x00, 0x01, 0x7f, 0x80, 0xab, 0xcd, 0xef, 0xff};
+	formatxx::hex_bytes const span(bytes, sizeof(bytes));
+
+	CHECK_FORMAT("00017f80abcdefff", "{}", span);
+	CHECK_FORMAT("00017F80ABCDEFFF", "{:X}", span);
+	CHECK_FORMAT("00 01 7f 80 ab cd ef ff", "{: }", span);
+	CHECK_FORMAT("00017f\n80abcd\nefff", "{:3}", span);
+	CHECK_FORMAT("00 01 7F\n80 AB CD\nEF FF", "{: 3X}", span);
+	CHECK_FORMAT("[]", "[{}]", formatxx::hex_bytes(bytes, 0));
+	CHECK_FORMAT("[]", "[{}]", formatxx::hex_bytes());
+	CHECK_WFORMAT(L"00 01 7F 80", L"{: X}", formatxx::hex_bytes(bytes, 4));
+
+	// spans long enough for the bulk kernel, checked against a byte-at-a-time expansion
+	unsigned char large[300];
+	std::string expected;
+	std::string spaced;
+	for (std::size_t i = 0; i != sizeof(large); ++i)
+	{
+		large[i] = static_cast<unsigned char>(i * 37 + 11);
+		char const digits[] = {"0123456789abcdef"[large[i] >> 4], "0123456789abcdef"[large[i] & 0xF], 0};
+		expected += digits;
+		spaced += (i == 0 ? "" : i % 16 == 0 ? "\n" : " ");
+		spaced += digits;
+	}
+	CHECK_FORMAT(expected, "{}", formatxx::hex_bytes(large, sizeof(large)));
+	CHECK_FORMAT(spaced, "{: 16}", formatxx::hex_bytes(large, sizeof(large)));
+	CHECK_FORMAT(expected.substr(0, 2 * 33), "{}", formatxx::hex_bytes(large, 33));
+
+	minimal_writer writer;
+	CHECK_FORMAT_WRITER(spaced, writer, "{: 16}", formatxx::hex_bytes(large, sizeof(large)));
+	CHECK_FORMAT_HELPER(std::cerr, 3, writer.writes);
+}
+
+namespace
+{
+	struct user_type { int value; };
+
+	void format_value(formatxx::format_writer& out, user_type const& value, formatxx::string_view spec)
+	{
+		formatxx::format(out, "user({})", value.value);
+		out.write(spec);
+	}
+}
+
+static void test_specs()
+{
+	// user types always receive the raw spec string
+	CHECK_FORMAT("user(7)x", "{:x}", user_type{7});
+	CHECK_PRINTF("user(7)-4s", "%-4s", user_type{7});
+
+	// built-in types receive the spec parsed once by printf or by compilation
+	CHECK_PRINTF("  0x1f|ab  |", "%#6x|%-4s|", 31, "ab");
+	CHECK_FORMAT("  0x1f|ab  |", formatxx::compiled_format("{:#6x}|{:-4s}|"), 31, "ab");
+	CHECK_FORMAT_VALUE("+0042", 42, formatxx::parse_format_spec(formatxx::string_view("+05")));
+
+	// flags in any order and repeated, size modifiers skipped, and the code that follows kept
+	formatxx::format_spec const spec = formatxx::parse_format_spec(formatxx::string_view("#0-0+ 12.3llxz"));
+	CHECK_FORMAT_HELPER(std::cerr, true, spec.alternate_form && spec.leading_zeroes && spec.left_justify && spec.prepend_sign && spec.prepend_space);
+	CHECK_FORMAT_HELPER(std::cerr, 12, spec.width);
+	CHECK_FORMAT_HELPER(std::cerr, 3, spec.precision);
+	CHECK_FORMAT_HELPER(std::cerr, 'x', spec.code);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("z"), std::string(spec.remaining));
+	CHECK_FORMAT_HELPER(std::cerr, 0, formatxx::parse_format_spec(formatxx::string_view("\xf8")).code);
+
+	// wide code units whose low byte is a spec character are not mistaken for one
+	CHECK_FORMAT_HELPER(std::cerr, 0, static_cast<int>(formatxx::parse_format_spec(formatxx::basic_string_view<wchar_t>(L"\u0178")).code));
+	CHECK_FORMAT_HELPER(std::cerr, false, formatxx::parse_format_spec(formatxx::basic_string_view<wchar_t>(L"\u012b")).prepend_sign);
+	CHECK_FORMAT_HELPER(std::cerr, std::u16string(u"7|12"), formatxx::printf_string<std::u16string>(u"%u|%Lx", 7u, 18));
+}
+
+static void test_format_args()
+{
+	using arg_type = formatxx::basic_format_arg<char>::type;
+	char const name[] = "name";
+	short const small = -3;
+
+	// library-formatted primitives are packed by value, everything else is bound to a thunk
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(small).kind == arg_type::signed_short);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(2.5f).kind == arg_type::single_float);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(name).kind == arg_type::zstring);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(formatxx::string_view("sv")).kind == arg_type::string);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(std::string("str")).kind == arg_type::string);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<wchar_t>(std::string("str")).kind == formatxx::basic_format_arg<wchar_t>::type::custom);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<char>(user_type{1}).kind == arg_type::custom);
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::_detail::make_format_arg<wchar_t>('c').kind == formatxx::basic_format_arg<wchar_t>::type::custom);
+
+	// packed integers keep their own type's formatting
+	CHECK_FORMAT("fffd ff -3", "{:x} {:x} {}", static_cast<unsigned short>(0xfffd), static_cast<unsigned char>(0xff), small);
+	CHECK_FORMAT("name 7 sv user(2) 1.5", "{} {} {} {} {}", name, 7ul, formatxx::string_view("sv"), user_type{2}, 1.5);
+	CHECK_PRINTF("1 true -2 x", "%d %s %lld %c", 1, true, -2ll, 'x');
+	CHECK_FORMAT("[ std] std|", "[{:4}] {:.3}|", std::string("std"), std::string("stdlib"));
+	CHECK_PRINTF("str", "%s", std::string("str"));
+
+	// calls without arguments pack nothing
+	CHECK_FORMAT("a{b", "a{{b");
+	CHECK_FORMAT_RESULT(formatxx::result_code::out_of_range, "{}");
+}
+
 static void test_errors()
 {
 	CHECK_FORMAT_RESULT(formatxx::result_code::success, "{} {:4d} {:3.5f}", "abc", 9, 12.57);
 	CHECK_FORMAT_RESULT(formatxx::result_code::malformed_input, "{} {:4d", "abc", 9);
 	CHECK_FORMAT_RESULT(formatxx::result_code::success, "{0} {1}", "abc", 9);
 	CHECK_FORMAT_RESULT(formatxx::result_code::out_of_range, "{0} {1} {5}", "abc", 9, 12.57);
+
+	// incomplete directives are written out once, as literal text
+	CHECK_FORMAT("abc{", "abc{");
+	CHECK_PRINTF("abc%", "abc%");
+}
+
+static void test_compiled()
+{
+	formatxx::compiled_format const format("{} {:4d} {1:x}!");
+	CHECK_FORMAT("abc    9 9!", format, "abc", 9);
+	CHECK_FORMAT("def   10 a!", format, "def", 10);
+	CHECK_FORMAT("{1}", formatxx::compiled_format("{{1}"));
+
+	formatxx::compiled_format const printf_format("%2$s=%1$-4d;%%", formatxx::format_syntax::printf);
+	CHECK_FORMAT("x=17  ;%", printf_format, 17, "x");
+
+	formatxx::basic_compiled_format<wchar_t> const wformat(L"{}-{}");
+	CHECK_WFORMAT(L"ab-12", wformat, L"ab", 12);
+
+	CHECK_FORMAT_RESULT(formatxx::result_code::malformed_input, formatxx::compiled_format("{} {:4d"), "abc", 9);
+	CHECK_FORMAT_RESULT(formatxx::result_code::out_of_range, formatxx::compiled_format("{0} {5}"), "abc", 9);
+}
+
+static void test_format_rows()
+{
+	int const ids[] = {1, 22, 333};
+	char const* const names[] = {"ann", "bo", "cy"};
+	double const scores[] = {1.5, 2.25, -0.125};
+	std::string const notes[] = {"a", "", "long note"};
+	point const places[] = {{1, 2}, {3, 4}, {5, 6}};
+
+	formatxx::string_writer out;
+	formatxx::compiled_format const csv("{},{:-4},{:.3f},{},{}\n");
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::format_rows(out, csv, 3, ids, names, scores, notes, places));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("1,ann ,1.500,a,(1,2)\n22,bo  ,2.250,,(3,4)\n333,cy  ,-0.125,long note,(5,6)\n"), out.str());
+
+	// every row matches formatting it alone
+	std::string expected;
+	for (int i = 0; i != 3; ++i)
+	{
+		expected += formatxx::format_string("{},{:-4},{:.3f},{},{}\n", ids[i], names[i], scores[i], notes[i], places[i]);
+	}
+	CHECK_FORMAT_HELPER(std::cerr, expected, out.str());
+
+	out.clear();
+	formatxx::compiled_format const tsv("%2$s\t%1$05d\n", formatxx::format_syntax::printf);
+	formatxx::format_rows(out, tsv, 2, ids, names);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("ann\t00001\nbo\t00022\n"), out.str());
+
+	out.clear();
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_range, formatxx::format_rows(out, formatxx::compiled_format("{}:{1};"), 2, ids));
+	CHECK_FORMAT_HELPER(std::cerr, std::string("1:;22:;"), out.str());
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::format_rows(out, csv, 0, ids, names, scores, notes, places));
+
+	formatxx::basic_string_writer<std::wstring> wout;
+	long long const totals[] = {-5, 6};
+	formatxx::format_rows(wout, formatxx::basic_compiled_format<wchar_t>(L"[{:3}]"), 2, totals);
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"[ -5][  6]"), wout.str());
+}
+
+namespace
+{
+	/// Runs chunks last to first on the calling thread, so out-of-order completion is visible.
+	struct reverse_executor : formatxx::batch_executor
+	{
+		void run(std::size_t count, task_type task, void* context) override
+		{
+			for (std::size_t index = count; index != 0; --index)
+			{
+				task(context, index - 1);
+			}
+			runs += count;
+		}
+
+		std::size_t runs = 0;
+	};
+}
+
+static void test_format_rows_parallel()
+{
+	std::vector<int> ids;
+	std::vector<double> values;
+	for (int i = 0; i != 1000; ++i)
+	{
+		ids.push_back(i * 7);
+		values.push_back(i / 8.0);
+	}
+
+	formatxx::compiled_format const csv("{},{:.2f}\n");
+	formatxx::string_writer serial;
+	formatxx::format_rows(serial, csv, ids.size(), ids.data(), values.data());
+
+	formatxx::thread_executor threads(4);
+	formatxx::string_writer out;
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::format_rows_parallel(out, threads, csv, ids.size(), 64, ids.data(), values.data()));
+	CHECK_FORMAT_HELPER(std::cerr, serial.str(), out.str());
+
+	// chunks are stitched in row order whatever order they finish in
+	reverse_executor reverse;
+	formatxx::row_chunks chunks;
+	formatxx::format_rows_parallel(chunks, reverse, csv, ids.size(), 300, ids.data(), values.data());
+	CHECK_FORMAT_HELPER(std::cerr, 4, chunks.size());
+	CHECK_FORMAT_HELPER(std::cerr, 4, reverse.runs);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("0,0.00\n7,0.12\n"), std::string(chunks[0].data(), 14));
+
+	// chunks can be handed to writev without concatenating them
+	formatxx::iovec_writer<> vectors;
+	chunks.write_to(vectors);
+	CHECK_FORMAT_HELPER(std::cerr, 4, vectors.count());
+	CHECK_FORMAT_HELPER(std::cerr, serial.str(), join_iovecs(vectors));
+
+	// chunks formatted straight into a writer are temporary, so they must be copied
+	formatxx::iovec_writer<> copied;
+	formatxx::format_rows_parallel(copied, threads, csv, ids.size(), 64, ids.data(), values.data());
+	CHECK_FORMAT_HELPER(std::cerr, serial.str(), join_iovecs(copied));
+
+	formatxx::format_rows_parallel(chunks, threads, csv, 0, 0, ids.data(), values.data());
+	CHECK_FORMAT_HELPER(std::cerr, 0, chunks.size());
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_range, formatxx::format_rows_parallel(chunks, threads, formatxx::compiled_format("{2}"), 10, 3, ids.data()));
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::out_of_range, chunks.result());
+}
+
+namespace
+{
+	// feeds format to a parser in pieces of the given size and returns the output and result
+	std::string parse_in_chunks(std::size_t chunk, formatxx::string_view format, formatxx::basic_format_args<char> args, formatxx::result_code& result)
+	{
+		formatxx::string_writer writer;
+		formatxx::format_parser parser(writer, args);
+		for (std::size_t first = 0; first < format.size(); first += chunk)
+		{
+			parser.feed({format.data() + first, std::min(chunk, format.size() - first)});
+		}
+		result = parser.finish();
+		return writer.str();
+	}
+}
+
+static void test_format_parser()
+{
+	std::string const name = "parser";
+	user_type const custom{3};
+	auto const args = formatxx::make_format_args<char>(name, 42, -1.5, custom);
+
+	// every split, down to one character at a time, matches formatting the whole string
+	char const* const formats[] = {
+		"{} {} {} {}",
+		"[{0:10}] {{literal}} {1:#06x} {2:.3f} {3} {0:-8}|",
+		"{1}{}{0} and {x} {",
+		"tail {:5",
+		"{99} ok",
+	};
+	for (char const* const format : formats)
+	{
+		formatxx::string_writer whole;
+		formatxx::result_code const expected_result = formatxx::_detail::format_impl<char>(whole, format, args);
+		for (std::size_t chunk = 1; chunk != 8; ++chunk)
+		{
+			formatxx::result_code chunked_result = formatxx::result_code::success;
+			CHECK_FORMAT_HELPER(std::cerr, whole.str(), parse_in_chunks(chunk, format, args, chunked_result));
+			CHECK_FORMAT_HELPER(std::cerr, true, chunked_result == expected_result);
+		}
+	}
+
+	// a parser can be reused after finish, with argument numbering starting over
+	formatxx::string_writer writer;
+	formatxx::format_parser parser(writer, args);
+	parser.feed("{} {");
+	parser.feed("}\n");
+	CHECK_FORMAT_HELPER(std::cerr, true, parser.finish() == formatxx::result_code::success);
+	parser.feed("{1:");
+	parser.feed("x}");
+	CHECK_FORMAT_HELPER(std::cerr, true, parser.finish() == formatxx::result_code::success);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("parser 42\n2a"), writer.str());
+
+	// split directives too long to buffer are malformed and dropped
+	std::string const long_spec = "<{:" + std::string(300, '1') + "}>";
+	formatxx::result_code long_result = formatxx::result_code::success;
+	CHECK_FORMAT_HELPER(std::cerr, std::string("<>"), parse_in_chunks(16, {long_spec.data(), long_spec.size()}, args, long_result));
+	CHECK_FORMAT_HELPER(std::cerr, true, long_result == formatxx::result_code::malformed_input);
+
+	// but a directive of any length within one chunk is formatted in place
+	auto const seven = formatxx::make_format_args<char>(7);
+	std::string const padded_spec = "{:" + std::string(300, '0') + "5}";
+	formatxx::result_code padded_result = formatxx::result_code::malformed_input;
+	CHECK_FORMAT_HELPER(std::cerr, std::string("00007"), parse_in_chunks(padded_spec.size(), {padded_spec.data(), padded_spec.size()}, seven, padded_result));
+	CHECK_FORMAT_HELPER(std::cerr, true, padded_result == formatxx::result_code::success);
+	CHECK_FORMAT("00007", padded_spec.c_str(), 7);
+
+	auto const no_args = formatxx::make_format_args<wchar_t>();
+	formatxx::wstring_writer wide;
+	formatxx::wformat_parser wparser(wide, no_args);
+	wparser.feed(L"wide {");
+	wparser.feed(L"{ text");
+	CHECK_FORMAT_HELPER(std::cerr, true, wparser.finish() == formatxx::result_code::success);
+	CHECK_FORMAT_HELPER(std::wcerr, std::wstring(L"wide { text"), wide.str());
+}
+
+static void test_static_format()
+{
+	CHECK_FORMAT("abc    9 9!", FORMATXX_STRING("{} {:4d} {1:x}!"), "abc", 9);
+	CHECK_FORMAT("{1}", FORMATXX_STRING("{{1}"));
+	CHECK_FORMAT("", FORMATXX_STRING(""));
+	CHECK_FORMAT("x=17", FORMATXX_STRING("{1}={0}"), 17, "x");
+	CHECK_FORMAT("a long literal run that spans more than one search block: 42",
+		FORMATXX_STRING("a long literal run that spans more than one search block: {}"), 42);
+	CHECK_WFORMAT(L"ab-12", FORMATXX_STRING(L"{}-{}"), L"ab", 12);
+
+	static_assert(formatxx::_detail::static_valid("{} {:4d}", 8, 0, 0), "valid format rejected");
+	static_assert(!formatxx::_detail::static_valid("{} {:4d", 7, 0, 0), "malformed format accepted");
+	static_assert(!formatxx::_detail::static_valid("{", 1, 0, 0), "malformed format accepted");
+	static_assert(formatxx::_detail::static_required("{0} {3}", 7, 0, 0) == 4, "incorrect argument count");
+	static_assert(formatxx::_detail::static_required("{} {} {{}", 9, 0, 0) == 2, "incorrect argument count");
+}
+
+static void test_binary()
+{
+	formatxx::format_registry registry;
+	formatxx::string_writer stream;
+
+	enum class level : short { warn = 2 };
+	unsigned char const key[] = {0xde, 0xad};
+	formatxx::encode_format(stream, registry, "{} {:+} {:#x} {:.2f} {:6} {} {} {} {}", -42, 7u, 255ull, 1.5f, "abc", std::string("str"), 'c', true, level::warn);
+	formatxx::encode_format(stream, registry, "{} {} {:X}", point{3, 4}, L"wide", formatxx::hex_bytes(key, sizeof(key)));
+	formatxx::encode_printf(stream, registry, "%s=%05d [%-6.3f]", "id", -42, -2.25);
+	formatxx::encode_format(stream, registry, "{} {}", std::numeric_limits<long long>::min(), std::numeric_limits<unsigned long long>::max());
+	CHECK_FORMAT_HELPER(std::cerr, 4, registry.size());
+
+	// the same format string is interned once, and costs a single byte of ID in the record
+	std::size_t const before = stream.str().size();
+	formatxx::encode_format(stream, registry, "{} {}", 1, 2);
+	CHECK_FORMAT_HELPER(std::cerr, 4, registry.size());
+	CHECK_FORMAT_HELPER(std::cerr, true, stream.str().size() - before == 8);
+
+	std::string const records = stream.str();
+	formatxx::string_view input(records.c_str(), records.size());
+	formatxx::string_writer out;
+	for (int i = 0; i != 5; ++i)
+	{
+		CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::success, formatxx::decode_record(out, registry, input));
+		out.write("\n");
+	}
+	CHECK_FORMAT_HELPER(std::cerr, 0, input.size());
+	std::string expected = formatxx::format_string("{} {:+} {:#x} {:.2f} {:6} {} {} {} {}\n", -42, 7u, 255ull, 1.5f, "abc", std::string("str"), 'c', true, level::warn);
+	expected += "(3,4) wide DEAD\n";
+	expected += formatxx::printf_string("%s=%05d [%-6.3f]\n", "id", -42, -2.25);
+	expected += formatxx::format_string("{} {}\n", std::numeric_limits<long long>::min(), std::numeric_limits<unsigned long long>::max());
+	expected += "1 2\n";
+	CHECK_FORMAT_HELPER(std::cerr, expected, out.str());
+
+	// a decoder with the format strings interned in the same order reads the same stream
+	formatxx::format_registry offline;
+	for (std::uint32_t id = 0; id != registry.size(); ++id)
+	{
+		offline.intern(registry.lookup(id));
+	}
+	input = formatxx::string_view(records.c_str(), records.size());
+	out.clear();
+	formatxx::decode_record(out, offline, input);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("-42 +7 0xff 1.50    abc str c true 2"), out.str());
+
+	// truncated records and unknown IDs are rejected
+	formatxx::string_view truncated(records.c_str(), 5);
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::malformed_input, formatxx::decode_record(out, registry, truncated));
+	formatxx::format_registry empty;
+	input = formatxx::string_view(records.c_str(), records.size());
+	CHECK_FORMAT_HELPER(std::cerr, formatxx::result_code::malformed_input, formatxx::decode_record(out, empty, input));
+	CHECK_FORMAT_HELPER(std::cerr, true, empty.lookup(0).data() == nullptr);
+
+	// a reused buffer holding a different format string of the same length gets its own ID
+	formatxx::format_registry reused;
+	formatxx::string_writer reused_stream;
+	char buffer[8] = "x={}";
+	formatxx::encode_format(reused_stream, reused, formatxx::string_view(buffer), 1);
+	buffer[0] = 'y';
+	formatxx::encode_format(reused_stream, reused, formatxx::string_view(buffer), 2);
+	CHECK_FORMAT_HELPER(std::cerr, 2, reused.size());
+	std::string const reused_records = reused_stream.str();
+	input = formatxx::string_view(reused_records.c_str(), reused_records.size());
+	out.clear();
+	formatxx::decode_record(out, reused, input);
+	formatxx::decode_record(out, reused, input);
+	CHECK_FORMAT_HELPER(std::cerr, std::string("x=1y=2"), out.str());
+
+	// UTF-16, UTF-32 and UTF-8 strings are transcoded, not encoded as addresses
+	formatxx::format_registry unicode;
+	formatxx::string_writer unicode_stream;
+	formatxx::encode_format(unicode_stream, unicode, "[{}] [{}] [{}]", static_cast<char16_t const*>(u"h\u00e9llo"), u"x", std::u16string(u"\u20ac"));
+	formatxx::encode_format(unicode_stream, unicode, "[{}] [{}] [{}]", static_cast<char32_t const*>(U"h\u00e9llo"), U"x", formatxx::basic_string_view<char32_t>(U"\U0001F600"));
+#if defined(__cpp_char8_t)
+	formatxx::encode_format(unicode_stream, unicode, "[{}] [{}] [{}]", static_cast<char8_t const*>(u8"h\u00e9llo"), u8"x", std::u8string(u8"\u20ac"));
+#endif
+	std::string const unicode_records = unicode_stream.str();
+	input = formatxx::string_view(unicode_records.c_str(), unicode_records.size());
+	out.clear();
+	formatxx::decode_record(out, unicode, input);
+	formatxx::decode_record(out, unicode, input);
+	std::string unicode_expected = "[h\xc3\xa9llo] [x] [\xe2\x82\xac][h\xc3\xa9llo] [x] [\xf0\x9f\x98\x80]";
+#if defined(__cpp_char8_t)
+	formatxx::decode_record(out, unicode, input);
+	unicode_expected += "[h\xc3\xa9llo] [x] [\xe2\x82\xac]";
+#endif
+	CHECK_FORMAT_HELPER(std::cerr, 0, input.size());
+	CHECK_FORMAT_HELPER(std::cerr, unicode_expected, out.str());
+}
+
+static void test_instrumentation()
+{
+#if defined(FORMATXX_INSTRUMENT)
+	static char const pair[] = "{} and {}";
+	static char const broken[] = "%d %";
+
+	CHECK_FORMAT_HELPER(std::cerr, true, formatxx::enable_instrumentation());
+	formatxx::reset_instrumentation();
+	for (int i = 0; i != 3; ++i)
+	{
+		formatxx::format_string(pair, i, "x");
+	}
+	std::thread([]{ formatxx::format_string(pair, 10, "y"); }).join();
+	formatxx::string_writer discard;
+	formatxx::printf(discard, broken, 1);
+	formatxx::disable_instrumentation();
+	formatxx::format_string(pair, 4, "z");
+
+	std::vector<formatxx::format_site_stats> stats;
+	formatxx::instrumentation_snapshot(stats);
+	auto const find = [&](void const* site) { return std::find_if(stats.begin(), stats.end(), [=](formatxx::format_site_stats const& entry) { return entry.site == site; }); };
+
+	// both threads' calls land on the one site; the call made after disabling is not counted
+	auto const counted = find(pair);
+	CHECK_FORMAT_HELPER(std::cerr, true, counted != stats.end());
+	CHECK_FORMAT_HELPER(std::cerr, 4, counted->calls);
+	CHECK_FORMAT_HELPER(std::cerr, 3 * 7 + 8, counted->bytes);
+	CHECK_FORMAT_HELPER(std::cerr, std::string(pair), counted->format);
+	CHECK_FORMAT_HELPER(std::cerr, 0, counted->malformed);
+	CHECK_FORMAT_HELPER(std::cerr, 0, counted->ticks);
+
+	auto const failed = find(broken);
+	CHECK_FORMAT_HELPER(std::cerr, true, failed != stats.end());
+	CHECK_FORMAT_HELPER(std::cerr, 1, failed->malformed);
+	CHECK_FORMAT_HELPER(std::cerr, true, stats.front().calls >= stats.back().calls);
+
+	formatxx::string_writer table;
+	formatxx::dump_instrumentation(table);
+	CHECK_FORMAT_HELPER(std::cerr, true, table.str().find("{} and {}") != std::string::npos);
+
+	formatxx::reset_instrumentation();
+	formatxx::instrumentation_snapshot(stats);
+	CHECK_FORMAT_HELPER(std::cerr, true, find(pair) == stats.end());
+#else
+	CHECK_FORMAT_HELPER(std::cerr, false, formatxx::enable_instrumentation());
+#endif
 }
 
 #if defined(WIN32)
@@ -351,14 +1627,38 @@ int FORMATXX_MAIN_DECL main()
 	test_fixed();
 	test_integers();
 	test_floats();
+	test_grouping();
 	test_string_writer();
+	test_scratch_strings();
+	test_format_append();
 	test_buffered();
+	test_arena();
+	test_minimal_writer();
+	test_formatted_size();
+	test_format_to_n();
+	test_iovec_writer();
+	test_fd_writer();
+	test_mmap_writer();
+	test_log_sink();
+	test_deferred();
+	test_binary();
 	test_printf();
 	test_strings();
+	test_literals();
 	test_wide_strings();
+	test_unicode_strings();
 	test_bool();
 	test_pointers();
+	test_hex_bytes();
+	test_specs();
+	test_format_args();
 	test_errors();
+	test_compiled();
+	test_format_rows();
+	test_format_rows_parallel();
+	test_format_parser();
+	test_static_format();
+	test_instrumentation();
 
 	std::cout << "formatxx passed " << (formatxx_tests - formatxx_failed) << " of " << formatxx_tests << " tests\n";
 	return formatxx_failed == 0 ? 0 : 1;
@@ -0,0 +1,259 @@
+// formatxx - C++ string formatting library.
+//
+// This is free and unencumbered software released into the public domain.
+// 
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non - commercial, and by any
+// means.
+// 
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+// 
+// For more information, please refer to <http://unlicense.org/>
+//
+// Authors:
+//   Sean Middleditch <sean@middleditch.us>
+
+#include <formatxx/format.h>
+#include <formatxx/unicode.h>
+
+#include <formatxx/_detail/format_traits.h>
+#include <formatxx/_detail/parse_unsigned.h>
+#include <formatxx/_detail/parse_format.h>
+#include <formatxx/_detail/write_integer.h>
+#include <formatxx/_detail/write_string.h>
+#include <formatxx/_detail/write_float.h>
+#include <formatxx/_detail/write_hex_bytes.h>
+#include <formatxx/_detail/transcode.h>
+#include <formatxx/_detail/format_arg_impl.h>
+#include <formatxx/_detail/format_impl.h>
+#include <formatxx/_detail/printf_impl.h>
+
+namespace formatxx {
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t value, u16string_view spec) { _detail::write_char(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t value, u16format_spec const& spec) { _detail::write_char(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t const* value, u16string_view spec) { _detail::write_string<char16_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t const* value, u16format_spec const& spec) { _detail::write_string<char16_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t* value, u16string_view spec) { _detail::write_string<char16_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char16_t* value, u16format_spec const& spec) { _detail::write_string<char16_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, u16string_view value, u16string_view spec) { _detail::write_string<char16_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, u16string_view value, u16format_spec const& spec) { _detail::write_string<char16_t>(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed int value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed int value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed char value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed char value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed short value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed short value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long long value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, signed long long value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned int value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned int value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned char value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned char value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned short value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned short value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long long value, u16string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, unsigned long long value, u16format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, bool value, u16string_view spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char16_t>::sTrue : _detail::FormatTraits<char16_t>::sFalse, parse_format_spec(spec));
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, bool value, u16format_spec const& spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char16_t>::sTrue : _detail::FormatTraits<char16_t>::sFalse, spec);
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, float value, u16string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, float value, u16format_spec const& spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, double value, u16string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, double value, u16format_spec const& spec) { _detail::write_float(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void* ptr, u16string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void* ptr, u16format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void const* ptr, u16string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, void const* ptr, u16format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, hex_bytes bytes, u16string_view spec) { _detail::write_hex_bytes(out, bytes, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, hex_bytes bytes, u16format_spec const& spec) { _detail::write_hex_bytes(out, bytes, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char ch, u16string_view spec) { _detail::write_transcoded<char16_t, char>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char const* zstr, u16string_view spec) { _detail::write_transcoded<char16_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, char* zstr, u16string_view spec) { _detail::write_transcoded<char16_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u16format_writer& out, string_view str, u16string_view spec) { _detail::write_transcoded<char16_t, char>(out, str, parse_format_spec(spec)); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t ch, string_view spec) { _detail::write_transcoded<char, char16_t>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t const* zstr, string_view spec) { _detail::write_transcoded<char, char16_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char16_t* zstr, string_view spec) { _detail::write_transcoded<char, char16_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u16string_view str, string_view spec) { _detail::write_transcoded<char, char16_t>(out, str, parse_format_spec(spec)); }
+
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_builtin_arg(basic_format_writer<char16_t>& out, basic_format_arg<char16_t> const& arg, basic_string_view<char16_t> spec_string, basic_format_spec<char16_t> const* spec);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_impl(basic_format_writer<char16_t>& out, basic_string_view<char16_t> format, basic_format_args<char16_t> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::printf_impl(basic_format_writer<char16_t>& out, basic_string_view<char16_t> format, basic_format_args<char16_t> args);
+template FORMATXX_PUBLIC basic_format_spec<char16_t> FORMATXX_API parse_format_spec(basic_string_view<char16_t>);
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t value, u32string_view spec) { _detail::write_char(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t value, u32format_spec const& spec) { _detail::write_char(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t const* value, u32string_view spec) { _detail::write_string<char32_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t const* value, u32format_spec const& spec) { _detail::write_string<char32_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t* value, u32string_view spec) { _detail::write_string<char32_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char32_t* value, u32format_spec const& spec) { _detail::write_string<char32_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, u32string_view value, u32string_view spec) { _detail::write_string<char32_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, u32string_view value, u32format_spec const& spec) { _detail::write_string<char32_t>(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed int value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed int value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed char value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed char value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed short value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed short value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long long value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, signed long long value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned int value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned int value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned char value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned char value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned short value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned short value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long long value, u32string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, unsigned long long value, u32format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, bool value, u32string_view spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char32_t>::sTrue : _detail::FormatTraits<char32_t>::sFalse, parse_format_spec(spec));
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, bool value, u32format_spec const& spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char32_t>::sTrue : _detail::FormatTraits<char32_t>::sFalse, spec);
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, float value, u32string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, float value, u32format_spec const& spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, double value, u32string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, double value, u32format_spec const& spec) { _detail::write_float(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void* ptr, u32string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void* ptr, u32format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void const* ptr, u32string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, void const* ptr, u32format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, hex_bytes bytes, u32string_view spec) { _detail::write_hex_bytes(out, bytes, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, hex_bytes bytes, u32format_spec const& spec) { _detail::write_hex_bytes(out, bytes, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char ch, u32string_view spec) { _detail::write_transcoded<char32_t, char>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char const* zstr, u32string_view spec) { _detail::write_transcoded<char32_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, char* zstr, u32string_view spec) { _detail::write_transcoded<char32_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u32format_writer& out, string_view str, u32string_view spec) { _detail::write_transcoded<char32_t, char>(out, str, parse_format_spec(spec)); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t ch, string_view spec) { _detail::write_transcoded<char, char32_t>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t const* zstr, string_view spec) { _detail::write_transcoded<char, char32_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char32_t* zstr, string_view spec) { _detail::write_transcoded<char, char32_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u32string_view str, string_view spec) { _detail::write_transcoded<char, char32_t>(out, str, parse_format_spec(spec)); }
+
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_builtin_arg(basic_format_writer<char32_t>& out, basic_format_arg<char32_t> const& arg, basic_string_view<char32_t> spec_string, basic_format_spec<char32_t> const* spec);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_impl(basic_format_writer<char32_t>& out, basic_string_view<char32_t> format, basic_format_args<char32_t> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::printf_impl(basic_format_writer<char32_t>& out, basic_string_view<char32_t> format, basic_format_args<char32_t> args);
+template FORMATXX_PUBLIC basic_format_spec<char32_t> FORMATXX_API parse_format_spec(basic_string_view<char32_t>);
+
+#if defined(__cpp_char8_t)
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t value, u8string_view spec) { _detail::write_char(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t value, u8format_spec const& spec) { _detail::write_char(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t const* value, u8string_view spec) { _detail::write_string<char8_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t const* value, u8format_spec const& spec) { _detail::write_string<char8_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t* value, u8string_view spec) { _detail::write_string<char8_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char8_t* value, u8format_spec const& spec) { _detail::write_string<char8_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, u8string_view value, u8string_view spec) { _detail::write_string<char8_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, u8string_view value, u8format_spec const& spec) { _detail::write_string<char8_t>(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed int value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed int value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed char value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed char value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed short value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed short value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long long value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, signed long long value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned int value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned int value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned char value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned char value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned short value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned short value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long long value, u8string_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, unsigned long long value, u8format_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, bool value, u8string_view spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char8_t>::sTrue : _detail::FormatTraits<char8_t>::sFalse, parse_format_spec(spec));
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, bool value, u8format_spec const& spec)
+{
+	_detail::write_string(out, value ? _detail::FormatTraits<char8_t>::sTrue : _detail::FormatTraits<char8_t>::sFalse, spec);
+}
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, float value, u8string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, float value, u8format_spec const& spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, double value, u8string_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, double value, u8format_spec const& spec) { _detail::write_float(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void* ptr, u8string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void* ptr, u8format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void const* ptr, u8string_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, void const* ptr, u8format_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, hex_bytes bytes, u8string_view spec) { _detail::write_hex_bytes(out, bytes, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, hex_bytes bytes, u8format_spec const& spec) { _detail::write_hex_bytes(out, bytes, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char ch, u8string_view spec) { _detail::write_transcoded<char8_t, char>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char const* zstr, u8string_view spec) { _detail::write_transcoded<char8_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, char* zstr, u8string_view spec) { _detail::write_transcoded<char8_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(u8format_writer& out, string_view str, u8string_view spec) { _detail::write_transcoded<char8_t, char>(out, str, parse_format_spec(spec)); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t ch, string_view spec) { _detail::write_transcoded<char, char8_t>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t const* zstr, string_view spec) { _detail::write_transcoded<char, char8_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, char8_t* zstr, string_view spec) { _detail::write_transcoded<char, char8_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, u8string_view str, string_view spec) { _detail::write_transcoded<char, char8_t>(out, str, parse_format_spec(spec)); }
+
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_builtin_arg(basic_format_writer<char8_t>& out, basic_format_arg<char8_t> const& arg, basic_string_view<char8_t> spec_string, basic_format_spec<char8_t> const* spec);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_impl(basic_format_writer<char8_t>& out, basic_string_view<char8_t> format, basic_format_args<char8_t> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::printf_impl(basic_format_writer<char8_t>& out, basic_string_view<char8_t> format, basic_format_args<char8_t> args);
+template FORMATXX_PUBLIC basic_format_spec<char8_t> FORMATXX_API parse_format_spec(basic_string_view<char8_t>);
+
+#endif
+
+} // namespace formatxx
@@ -30,6 +30,10 @@
 
 #include <formatxx/format.h>
 #include <formatxx/wide.h>
+#include <formatxx/compiled.h>
+#include <formatxx/batch.h>
+#include <formatxx/static_format.h>
+#include <formatxx/parser.h>
 
 #include <formatxx/_detail/format_traits.h>
 #include <formatxx/_detail/parse_unsigned.h>
@@ -37,142 +41,89 @@
 #include <formatxx/_detail/write_integer.h>
 #include <formatxx/_detail/write_string.h>
 #include <formatxx/_detail/write_float.h>
+#include <formatxx/_detail/write_hex_bytes.h>
+#include <formatxx/_detail/transcode.h>
+#include <formatxx/_detail/format_arg_impl.h>
 #include <formatxx/_detail/format_impl.h>
 #include <formatxx/_detail/printf_impl.h>
-
-#include <cwchar>
-#include <cstdlib>
-#include <climits>
+#include <formatxx/_detail/compile_impl.h>
+#include <formatxx/_detail/parser_impl.h>
 
 namespace formatxx {
 
-#pragma warning(push)
-#pragma warning(disable: 4996)
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char ch, wstring_view)
-{
-	std::mbstate_t state{};
-	wchar_t wc;
-	std::size_t const rs = std::mbrtowc(&wc, &ch, 1, &state);
-	if (rs > 0 && rs < static_cast<std::size_t>(-2))
-	{
-		out.write({&wc, 1});
-	}
-}
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char const* zstr, wstring_view)
-{
-	if (zstr != nullptr)
-	{
-		std::mbstate_t state{};
-		while (*zstr != 0)
-		{
-			wchar_t wc;
-			std::size_t const rs = std::mbrtowc(&wc, zstr++, 1, &state);
-			if (rs < static_cast<std::size_t>(-2))
-			{
-				out.write({&wc, 1});
-			}
-		}
-	}
-}
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char* zstr, wstring_view spec)
-{
-	format_value(out, (char const*)zstr, spec);
-}
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char ch, wstring_view spec) { _detail::write_transcoded<wchar_t, char>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char const* zstr, wstring_view spec) { _detail::write_transcoded<wchar_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, char* zstr, wstring_view spec) { _detail::write_transcoded<wchar_t, char>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, string_view str, wstring_view spec) { _detail::write_transcoded<wchar_t, char>(out, str, parse_format_spec(spec)); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t ch, string_view spec) { _detail::write_transcoded<char, wchar_t>(out, {&ch, 1}, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t const* zstr, string_view spec) { _detail::write_transcoded<char, wchar_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t* zstr, string_view spec) { _detail::write_transcoded<char, wchar_t>(out, zstr, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wstring_view str, string_view spec) { _detail::write_transcoded<char, wchar_t>(out, str, parse_format_spec(spec)); }
+
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t value, wstring_view spec) { _detail::write_char(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t value, wformat_spec const& spec) { _detail::write_char(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t const* value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t const* value, wformat_spec const& spec) { _detail::write_string<wchar_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t* value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t* value, wformat_spec const& spec) { _detail::write_string<wchar_t>(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wstring_view value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wstring_view value, wformat_spec const& spec) { _detail::write_string<wchar_t>(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed int value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed int value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed char value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed char value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed short value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed short value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long long value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long long value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned int value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned int value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned char value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned char value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned short value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned short value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long long value, wstring_view spec) { _detail::write_integer(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long long value, wformat_spec const& spec) { _detail::write_integer(out, value, spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, string_view str, wstring_view)
-{
-	std::mbstate_t state{};
-	for (auto const ch : str)
-	{
-		wchar_t wc;
-		std::size_t const rs = std::mbrtowc(&wc, &ch, 1, &state);
-		if (rs < static_cast<std::size_t>(-2))
-		{
-			out.write({&wc, 1});
-		}
-	}
-}
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t ch, string_view)
-{
-	std::mbstate_t state{};
-	char mb[MB_LEN_MAX];
-	std::size_t const rs = std::wcrtomb(mb, ch, &state);
-	if (rs != static_cast<std::size_t>(-1))
-	{
-		out.write({mb, rs});
-	}
-}
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t const* zstr, string_view)
-{
-	if (zstr != nullptr)
-	{
-		std::mbstate_t state{};
-		char mb[MB_LEN_MAX];
-		while (*zstr != 0)
-		{
-			std::size_t const rs = std::wcrtomb(mb, *zstr++, &state);
-			if (rs != static_cast<std::size_t>(-1))
-			{
-				out.write({mb, rs});
-			}
-		}
-	}
-}
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wchar_t* zstr, string_view spec)
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, bool value, wstring_view spec)
 {
-	format_value(out, (wchar_t const*)zstr, spec);
+	_detail::write_string(out, value ? _detail::FormatTraits<wchar_t>::sTrue : _detail::FormatTraits<wchar_t>::sFalse, parse_format_spec(spec));
 }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(format_writer& out, wstring_view str, string_view)
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, bool value, wformat_spec const& spec)
 {
-	std::mbstate_t state{};
-	char mb[MB_LEN_MAX];
-	for (auto const ch : str)
-	{
-		std::size_t const rs = std::wcrtomb(mb, ch, &state);
-		if (rs != static_cast<std::size_t>(-1))
-		{
-			out.write({mb, rs});
-		}
-	}
+	_detail::write_string(out, value ? _detail::FormatTraits<wchar_t>::sTrue : _detail::FormatTraits<wchar_t>::sFalse, spec);
 }
 
-#pragma warning(pop)
-
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, float value, wstring_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, float value, wformat_spec const& spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, double value, wstring_view spec) { _detail::write_float(out, value, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, double value, wformat_spec const& spec) { _detail::write_float(out, value, spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t value, wstring_view spec) { _detail::write_char(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t const* value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wchar_t* value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, wstring_view value, wstring_view spec) { _detail::write_string<wchar_t>(out, value, spec); }
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed int value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed char value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed short value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, signed long long value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned int value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned char value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned short value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, unsigned long long value, wstring_view spec) { _detail::write_integer(out, value, spec); }
-
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, bool value, wstring_view spec)
-{
-	format_value(out, value ? _detail::FormatTraits<wchar_t>::sTrue : _detail::FormatTraits<wchar_t>::sFalse, spec);
-}
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void* ptr, wstring_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void* ptr, wformat_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void const* ptr, wstring_view spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, void const* ptr, wformat_spec const& spec) { _detail::write_integer(out, reinterpret_cast<std::uintptr_t>(ptr), spec); }
 
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, float value, wstring_view spec) { _detail::write_float(out, value, spec); }
-FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, double value, wstring_view spec) { _detail::write_float(out, value, spec); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, hex_bytes bytes, wstring_view spec) { _detail::write_hex_bytes(out, bytes, parse_format_spec(spec)); }
+FORMATXX_PUBLIC void FORMATXX_API format_value(wformat_writer& out, hex_bytes bytes, wformat_spec const& spec) { _detail::write_hex_bytes(out, bytes, spec); }
 
+template result_code FORMATXX_API _detail::format_builtin_arg(basic_format_writer<wchar_t>& out, basic_format_arg<wchar_t> const& arg, basic_string_view<wchar_t> spec_string, basic_format_spec<wchar_t> const* spec);
 template result_code FORMATXX_API _detail::format_impl(basic_format_writer<wchar_t>& out, basic_string_view<wchar_t> format, basic_format_args<wchar_t> args);
 template result_code FORMATXX_API _detail::printf_impl(basic_format_writer<wchar_t>& out, basic_string_view<wchar_t> format, basic_format_args<wchar_t> args);
 template FORMATXX_PUBLIC basic_format_spec<wchar_t> FORMATXX_API parse_format_spec(basic_string_view<wchar_t>);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::compile_format_impl(std::vector<_detail::compiled_segment<wchar_t>>& segments, basic_string_view<wchar_t> format, format_syntax syntax);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::compiled_format_impl(basic_format_writer<wchar_t>& out, _detail::compiled_segment<wchar_t> const* segments, std::size_t count, basic_format_args<wchar_t> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::format_rows_impl(basic_format_writer<wchar_t>& out, _detail::compiled_segment<wchar_t> const* segments, std::size_t count, _detail::batch_column<wchar_t> const* columns, std::size_t column_count, std::size_t first_row, std::size_t last_row);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::static_format_impl(basic_format_writer<wchar_t>& out, wchar_t const* format, _detail::static_segment const* segments, std::size_t count, basic_format_args<wchar_t> args);
+template FORMATXX_PUBLIC result_code FORMATXX_API _detail::parse_format_chunk(basic_format_writer<wchar_t>& out, basic_format_args<wchar_t> const& args, _detail::parser_state<wchar_t>& state, basic_string_view<wchar_t> chunk);
 
 } // namespace formatxx